@@ -848,7 +848,7 @@ void streamfx::filter::autoframing::autoframing_instance::switch_provider(tracki
 	_provider     = provider;
 
 	// Then spawn a new task to switch provider.
-	_provider_task = streamfx::threadpool()->push(std::bind(&autoframing_instance::task_switch_provider, this, std::placeholders::_1), spd);
+	_provider_task = streamfx::threadpool()->push(std::bind(&autoframing_instance::task_switch_provider, this, std::placeholders::_1), spd, streamfx::util::threadpool::priority::BACKGROUND);
 }
 
 void streamfx::filter::autoframing::autoframing_instance::task_switch_provider(util::threadpool::task_data_t data)
@@ -1268,10 +1268,11 @@ std::shared_ptr<autoframing_factory> autoframing_factory::instance()
 static std::shared_ptr<autoframing_factory> loader_instance;
 
 static auto loader = streamfx::loader(
+	"filter-autoframing",
 	[]() { // Initalizer
 		loader_instance = autoframing_factory::instance();
 	},
 	[]() { // Finalizer
 		loader_instance.reset();
 	},
-	streamfx::loader_priority::NORMAL);
+	streamfx::loader_priority::NORMAL, streamfx::loader_flags::NONE, {"nvidia-cuda"});
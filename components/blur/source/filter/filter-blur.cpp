@@ -8,6 +8,7 @@
 #include "gfx/blur/gfx-blur-box-linear.hpp"
 #include "gfx/blur/gfx-blur-box.hpp"
 #include "gfx/blur/gfx-blur-dual-filtering.hpp"
+#include "gfx/blur/gfx-blur-gaussian-cascade.hpp"
 #include "gfx/blur/gfx-blur-gaussian-linear.hpp"
 #include "gfx/blur/gfx-blur-gaussian.hpp"
 #include "obs/gs/gs-helper.hpp"
@@ -97,6 +98,11 @@
 #define ST_KEY_MASK_ALPHA "Filter.Blur.Mask.Alpha"
 #define ST_I18N_MASK_MULTIPLIER "Filter.Blur.Mask.Multiplier"
 #define ST_KEY_MASK_MULTIPLIER "Filter.Blur.Mask.Multiplier"
+#define ST_I18N_CACHE "Filter.Blur.Cache"
+#define ST_KEY_CACHE "Filter.Blur.Cache"
+#define ST_I18N_CACHE_DISABLED "Filter.Blur.Cache.Disabled"
+#define ST_I18N_CACHE_AUTOMATIC "Filter.Blur.Cache.Automatic"
+#define ST_I18N_CACHE_STATIC "Filter.Blur.Cache.Static"
 
 using namespace streamfx::filter::blur;
 
@@ -112,7 +118,7 @@ struct local_blur_subtype_t {
 };
 
 static std::map<std::string, local_blur_type_t> list_of_types = {
-	{"box", {&::streamfx::gfx::blur::box_factory::get, S_BLUR_TYPE_BOX}}, {"box_linear", {&::streamfx::gfx::blur::box_linear_factory::get, S_BLUR_TYPE_BOX_LINEAR}}, {"gaussian", {&::streamfx::gfx::blur::gaussian_factory::get, S_BLUR_TYPE_GAUSSIAN}}, {"gaussian_linear", {&::streamfx::gfx::blur::gaussian_linear_factory::get, S_BLUR_TYPE_GAUSSIAN_LINEAR}}, {"dual_filtering", {&::streamfx::gfx::blur::dual_filtering_factory::get, S_BLUR_TYPE_DUALFILTERING}},
+	{"box", {&::streamfx::gfx::blur::box_factory::get, S_BLUR_TYPE_BOX}}, {"box_linear", {&::streamfx::gfx::blur::box_linear_factory::get, S_BLUR_TYPE_BOX_LINEAR}}, {"gaussian", {&::streamfx::gfx::blur::gaussian_factory::get, S_BLUR_TYPE_GAUSSIAN}}, {"gaussian_linear", {&::streamfx::gfx::blur::gaussian_linear_factory::get, S_BLUR_TYPE_GAUSSIAN_LINEAR}}, {"gaussian_cascade", {&::streamfx::gfx::blur::gaussian_cascade_factory::get, S_BLUR_TYPE_GAUSSIAN_CASCADE}}, {"dual_filtering", {&::streamfx::gfx::blur::dual_filtering_factory::get, S_BLUR_TYPE_DUALFILTERING}},
 };
 static std::map<std::string, local_blur_subtype_t> list_of_subtypes = {
 	{"area", {::streamfx::gfx::blur::type::Area, S_BLUR_SUBTYPE_AREA}},
@@ -121,7 +127,7 @@ static std::map<std::string, local_blur_subtype_t> list_of_subtypes = {
 	{"zoom", {::streamfx::gfx::blur::type::Zoom, S_BLUR_SUBTYPE_ZOOM}},
 };
 
-blur_instance::blur_instance(obs_data_t* settings, obs_source_t* self) : obs::source_instance(settings, self), _gfx_util(::streamfx::gfx::util::get()), _source_rendered(false), _output_rendered(false)
+blur_instance::blur_instance(obs_data_t* settings, obs_source_t* self) : obs::source_instance(settings, self), _gfx_util(::streamfx::gfx::util::get()), _source_rendered(false), _output_rendered(false), _cache_mode(cache_mode::Disabled), _cache_input(self), _cache_dirty(true), _cache_signature(0), _cache_frames(0), _cache_reused(0)
 {
 	{
 		auto gctx = streamfx::obs::gs::context();
@@ -144,7 +150,12 @@ blur_instance::blur_instance(obs_data_t* settings, obs_source_t* self) : obs::so
 	update(settings);
 }
 
-blur_instance::~blur_instance() {}
+blur_instance::~blur_instance()
+{
+	if (_cache_frames > 0) {
+		D_LOG_INFO("'%s' reused its previous result for %" PRIu64 " of %" PRIu64 " frames (%.1f%%).", obs_source_get_name(_self), _cache_reused, _cache_frames, static_cast<double>(_cache_reused) * 100.0 / static_cast<double>(_cache_frames));
+	}
+}
 
 bool blur_instance::apply_mask_parameters(streamfx::obs::gs::effect effect, gs_texture_t* original_texture, gs_texture_t* blurred_texture)
 {
@@ -210,6 +221,16 @@ bool blur_instance::apply_mask_parameters(streamfx::obs::gs::effect effect, gs_t
 	return true;
 }
 
+bool blur_instance::get_input_signature(uint64_t& signature)
+{
+	// Other sources used as a mask may change at any time.
+	if (_mask.enabled && (_mask.type == mask_type::Source)) {
+		return false;
+	}
+
+	return _cache_input.signature(_cache_mode == cache_mode::Automatic, signature);
+}
+
 void blur_instance::load(obs_data_t* settings)
 {
 	update(settings);
@@ -316,6 +337,11 @@ void blur_instance::update(obs_data_t* settings)
 			}
 		}
 	}
+
+	{ // Caching
+		_cache_mode = static_cast<cache_mode>(obs_data_get_int(settings, ST_KEY_CACHE));
+		_cache_input.invalidate();
+	}
 }
 
 void blur_instance::video_tick(float)
@@ -360,8 +386,28 @@ void blur_instance::video_tick(float)
 		}
 	}
 
-	_source_rendered = false;
-	_output_rendered = false;
+	// Reuse the previous result if neither the input nor the settings changed since.
+	bool reuse = false;
+	if (_cache_mode != cache_mode::Disabled) {
+		uint64_t signature = 0;
+		bool     dirty     = _cache_dirty.exchange(false);
+		if (get_input_signature(signature)) {
+			reuse            = !dirty && (signature == _cache_signature);
+			_cache_signature = signature;
+		} else {
+			_cache_dirty = true;
+		}
+
+		_cache_frames++;
+		if (reuse) {
+			_cache_reused++;
+		}
+	}
+
+	if (!reuse) {
+		_source_rendered = false;
+		_output_rendered = false;
+	}
 }
 
 void blur_instance::video_render(gs_effect_t* effect)
@@ -616,6 +662,9 @@ void blur_factory::get_defaults2(obs_data_t* settings)
 	obs_data_set_default_string(settings, ST_KEY_MASK_SOURCE, "");
 	obs_data_set_default_int(settings, ST_KEY_MASK_COLOR, 0xFFFFFFFFull);
 	obs_data_set_default_double(settings, ST_KEY_MASK_MULTIPLIER, 1.0);
+
+	// Caching
+	obs_data_set_default_int(settings, ST_KEY_CACHE, static_cast<int64_t>(cache_mode::Disabled));
 }
 
 bool modified_properties(void*, obs_properties_t* props, obs_property* prop, obs_data_t* settings) noexcept
@@ -757,6 +806,7 @@ obs_properties_t* blur_factory::get_properties2(blur_instance* data)
 		obs_property_list_add_string(p, D_TRANSLATE(S_BLUR_TYPE_BOX_LINEAR), "box_linear");
 		obs_property_list_add_string(p, D_TRANSLATE(S_BLUR_TYPE_GAUSSIAN), "gaussian");
 		obs_property_list_add_string(p, D_TRANSLATE(S_BLUR_TYPE_GAUSSIAN_LINEAR), "gaussian_linear");
+		obs_property_list_add_string(p, D_TRANSLATE(S_BLUR_TYPE_GAUSSIAN_CASCADE), "gaussian_cascade");
 		obs_property_list_add_string(p, D_TRANSLATE(S_BLUR_TYPE_DUALFILTERING), "dual_filtering");
 
 		p = obs_properties_add_list(pr, ST_KEY_SUBTYPE, D_TRANSLATE(ST_I18N_SUBTYPE), OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_STRING);
@@ -825,6 +875,14 @@ obs_properties_t* blur_factory::get_properties2(blur_instance* data)
 		p = obs_properties_add_float_slider(pr, ST_KEY_MASK_MULTIPLIER, D_TRANSLATE(ST_I18N_MASK_MULTIPLIER), 0.0, 10.0, 0.01);
 	}
 
+	// Caching
+	{
+		p = obs_properties_add_list(pr, ST_KEY_CACHE, D_TRANSLATE(ST_I18N_CACHE), OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_INT);
+		obs_property_list_add_int(p, D_TRANSLATE(ST_I18N_CACHE_DISABLED), static_cast<int64_t>(cache_mode::Disabled));
+		obs_property_list_add_int(p, D_TRANSLATE(ST_I18N_CACHE_AUTOMATIC), static_cast<int64_t>(cache_mode::Automatic));
+		obs_property_list_add_int(p, D_TRANSLATE(ST_I18N_CACHE_STATIC), static_cast<int64_t>(cache_mode::Static));
+	}
+
 	return pr;
 }
 
@@ -869,6 +927,7 @@ std::shared_ptr<blur_factory> blur_factory::instance()
 static std::shared_ptr<blur_factory> loader_instance;
 
 static auto loader = streamfx::loader(
+	"filter-blur",
 	[]() { // Initalizer
 		loader_instance = blur_factory::instance();
 	},
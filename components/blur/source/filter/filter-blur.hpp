@@ -11,9 +11,11 @@
 #include "obs/gs/gs-helper.hpp"
 #include "obs/gs/gs-rendertarget.hpp"
 #include "obs/gs/gs-texture.hpp"
+#include "obs/obs-filter-input-tracker.hpp"
 #include "obs/obs-source-factory.hpp"
 
 #include "warning-disable.hpp"
+#include <atomic>
 #include <chrono>
 #include <functional>
 #include <list>
@@ -27,6 +29,12 @@ namespace streamfx::filter::blur {
 		Source,
 	};
 
+	enum class cache_mode : int64_t {
+		Disabled,
+		Automatic,
+		Static,
+	};
+
 	class blur_instance : public obs::source_instance {
 		// Effects
 		streamfx::obs::gs::effect            _effect_mask;
@@ -84,6 +92,14 @@ namespace streamfx::filter::blur {
 			float multiplier;
 		} _mask;
 
+		// Caching
+		cache_mode                          _cache_mode;
+		streamfx::obs::filter_input_tracker _cache_input;
+		std::atomic<bool>                   _cache_dirty;
+		uint64_t                            _cache_signature;
+		uint64_t                            _cache_frames;
+		uint64_t                            _cache_reused;
+
 		public:
 		blur_instance(obs_data_t* settings, obs_source_t* self);
 		~blur_instance();
@@ -98,6 +114,12 @@ namespace streamfx::filter::blur {
 
 		private:
 		bool apply_mask_parameters(streamfx::obs::gs::effect effect, gs_texture_t* original_texture, gs_texture_t* blurred_texture);
+
+		/** Summarize everything the input depends on, if the cache mode allows assuming it is otherwise unchanged.
+		 *
+		 * \return false if the input may change at any time, and has to be rendered again.
+		 */
+		bool get_input_signature(uint64_t& signature);
 	};
 
 	class blur_factory : public obs::source_factory<filter::blur::blur_factory, filter::blur::blur_instance> {
@@ -186,7 +186,7 @@ streamfx::gfx::blur::box::box() : _data(::streamfx::gfx::blur::box_factory::get(
 {
 	auto gctx      = streamfx::obs::gs::context();
 	_rendertarget  = std::make_shared<::streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
-	_rendertarget2 = std::make_shared<::streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
+	_rt_pool       = ::streamfx::gfx::rendertarget_pool::get();
 }
 
 streamfx::gfx::blur::box::~box() {}
@@ -262,6 +262,9 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::box::render()
 	gs_stencil_function(GS_STENCIL_BOTH, GS_ALWAYS);
 	gs_stencil_op(GS_STENCIL_BOTH, GS_ZERO, GS_ZERO, GS_ZERO);
 
+	// Only needed while rendering, so borrow it.
+	auto scratch = _rt_pool->acquire(GS_RGBA, uint32_t(width), uint32_t(height));
+
 	// Two Pass Blur
 	streamfx::obs::gs::effect effect = _data->get_effect();
 	if (effect) {
@@ -277,7 +280,7 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::box::render()
 			auto gdm = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Horizontal");
 #endif
 
-			auto op = _rendertarget2->render(uint32_t(width), uint32_t(height));
+			auto op = scratch->render(uint32_t(width), uint32_t(height));
 			gs_ortho(0, 1., 0, 1., 0, 1.);
 			while (gs_effect_loop(effect.get_object(), "Draw")) {
 				_data->get_gfx_util()->draw_fullscreen_triangle();
@@ -285,7 +288,7 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::box::render()
 		}
 
 		// Pass 2
-		effect.get_parameter("pImage").set_texture(_rendertarget2->get_texture());
+		effect.get_parameter("pImage").set_texture(scratch->get_texture());
 		effect.get_parameter("pImageTexel").set_float2(0.f, float(1.f / height));
 
 		{
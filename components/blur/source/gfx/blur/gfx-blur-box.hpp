@@ -5,6 +5,7 @@
 #pragma once
 #include "common.hpp"
 #include "gfx-blur-base.hpp"
+#include "gfx/gfx-rendertarget-pool.hpp"
 #include "gfx/gfx-util.hpp"
 #include "obs/gs/gs-effect.hpp"
 #include "obs/gs/gs-rendertarget.hpp"
@@ -83,7 +84,7 @@ namespace streamfx::gfx {
 			std::shared_ptr<::streamfx::obs::gs::rendertarget> _rendertarget;
 
 			private:
-			std::shared_ptr<::streamfx::obs::gs::rendertarget> _rendertarget2;
+			std::shared_ptr<::streamfx::gfx::rendertarget_pool> _rt_pool;
 
 			public:
 			box();
@@ -33,6 +33,8 @@
 
 #define ST_MAX_LEVELS 16
 
+#define ST_FORMAT GS_RGBA
+
 streamfx::gfx::blur::dual_filtering_data::dual_filtering_data() : _gfx_util(::streamfx::gfx::util::get())
 {
 	auto gctx = streamfx::obs::gs::context();
@@ -168,19 +170,10 @@ std::shared_ptr<::streamfx::gfx::blur::dual_filtering_data> streamfx::gfx::blur:
 	return instance;
 }
 
-streamfx::gfx::blur::dual_filtering::dual_filtering() : _data(::streamfx::gfx::blur::dual_filtering_factory::get().data()), _size(0), _iterations(0)
+streamfx::gfx::blur::dual_filtering::dual_filtering() : _data(::streamfx::gfx::blur::dual_filtering_factory::get().data()), _pyramid(::streamfx::gfx::pyramid::get()), _rt_pool(::streamfx::gfx::rendertarget_pool::get()), _size(0), _iterations(0)
 {
 	auto gctx = streamfx::obs::gs::context();
-	_rts.resize(ST_MAX_LEVELS + 1);
-	for (std::size_t n = 0; n <= ST_MAX_LEVELS; n++) {
-		gs_color_format cf = GS_RGBA;
-#if 0
-		cf = GS_RGBA16F;
-#elif 0
-		cf = GS_RGBA32F;
-#endif
-		_rts[n] = std::make_shared<streamfx::obs::gs::rendertarget>(cf, GS_ZS_NONE);
-	}
+	_rt       = std::make_shared<streamfx::obs::gs::rendertarget>(ST_FORMAT, GS_ZS_NONE);
 }
 
 streamfx::gfx::blur::dual_filtering::~dual_filtering() {}
@@ -240,56 +233,42 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::dual_filterin
 	uint32_t height     = _input_texture->get_height();
 	size_t   iterations = _iterations;
 
-	// Downsample
+	// Downsample, sharing the levels with anyone else who blurs the same input this frame.
 	for (std::size_t n = 1; n <= iterations; n++) {
-#if defined(ENABLE_PROFILING) && !defined(D_PLATFORM_MAC) && _DEBUG
-		auto gdm = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Down %" PRIuMAX, n);
-#endif
-
-		// Select Texture
-		std::shared_ptr<streamfx::obs::gs::texture> tex;
-		if (n > 1) {
-			tex = _rts[n - 1]->get_texture();
-		} else { // Idx 0 is a simply considered as a straight copy of the original and not rendered to.
-			tex = _input_texture;
-		}
-
-		// Reduce Size
-		uint32_t owidth  = width >> n;
-		uint32_t oheight = height >> n;
-		if ((owidth == 0) || (oheight == 0)) {
+		if (((width >> n) == 0) || ((height >> n) == 0)) {
 			iterations = n - 1;
 			break;
 		}
+	}
+	std::shared_ptr<streamfx::obs::gs::texture> down;
+	if (iterations > 0) {
+#if defined(ENABLE_PROFILING) && !defined(D_PLATFORM_MAC) && _DEBUG
+		auto gdm = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Down %" PRIuMAX, iterations);
+#endif
 
-		// Apply
-		effect.get_parameter("pImage").set_texture(tex);
-		effect.get_parameter("pImageSize").set_float2(static_cast<float>(owidth), static_cast<float>(oheight));
-		effect.get_parameter("pImageTexel").set_float2(0.5f / static_cast<float>(owidth), 0.5f / static_cast<float>(oheight));
-
-		{
-			auto op = _rts[n]->render(owidth, oheight);
-			gs_ortho(0., 1., 0., 1., 0., 1.);
-			while (gs_effect_loop(effect.get_object(), "Down")) {
-				_data->get_gfx_util()->draw_fullscreen_triangle();
-			}
+		down = _pyramid->get_level(_input_texture, iterations, ::streamfx::gfx::pyramid::filter::DualFiltering, ST_FORMAT);
+		if (!down) {
+			gs_blend_state_pop();
+			return _input_texture;
 		}
 	}
 
-	// Upsample
+	// Upsample, with everything but the final level only needed until the next one is done.
+	std::shared_ptr<streamfx::obs::gs::rendertarget> up;
 	for (std::size_t n = iterations; n > 0; n--) {
 #if defined(ENABLE_PROFILING) && !defined(D_PLATFORM_MAC) && _DEBUG
 		auto gdm = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Up %" PRIuMAX, n);
 #endif
 
 		// Select Texture
-		std::shared_ptr<streamfx::obs::gs::texture> tex = _rts[n]->get_texture();
+		std::shared_ptr<streamfx::obs::gs::texture> tex = (n == iterations) ? down : up->get_texture();
 
 		// Get Size
 		uint32_t iwidth  = tex->get_width();
 		uint32_t iheight = tex->get_height();
 		uint32_t owidth  = width >> (n - 1);
 		uint32_t oheight = height >> (n - 1);
+		auto     rt      = (n > 1) ? _rt_pool->acquire(ST_FORMAT, owidth, oheight) : _rt;
 
 		// Apply
 		effect.get_parameter("pImage").set_texture(tex);
@@ -297,20 +276,21 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::dual_filterin
 		effect.get_parameter("pImageTexel").set_float2(0.5f / static_cast<float>(iwidth), 0.5f / static_cast<float>(iheight));
 
 		{
-			auto op = _rts[n - 1]->render(owidth, oheight);
+			auto op = rt->render(owidth, oheight);
 			gs_ortho(0., 1., 0., 1., 0., 1.);
 			while (gs_effect_loop(effect.get_object(), "Up")) {
 				_data->get_gfx_util()->draw_fullscreen_triangle();
 			}
 		}
+		up = rt;
 	}
 
 	gs_blend_state_pop();
 
-	return _rts[0]->get_texture();
+	return _rt->get_texture();
 }
 
 std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::dual_filtering::get()
 {
-	return _rts[0]->get_texture();
+	return _rt->get_texture();
 }
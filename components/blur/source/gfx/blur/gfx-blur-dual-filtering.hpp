@@ -5,6 +5,8 @@
 #pragma once
 #include "common.hpp"
 #include "gfx-blur-base.hpp"
+#include "gfx/gfx-pyramid.hpp"
+#include "gfx/gfx-rendertarget-pool.hpp"
 #include "gfx/gfx-util.hpp"
 #include "obs/gs/gs-effect.hpp"
 #include "obs/gs/gs-rendertarget.hpp"
@@ -76,13 +78,15 @@ namespace streamfx::gfx {
 
 		class dual_filtering : public ::streamfx::gfx::blur::base {
 			std::shared_ptr<::streamfx::gfx::blur::dual_filtering_data> _data;
+			std::shared_ptr<::streamfx::gfx::pyramid>                   _pyramid;
+			std::shared_ptr<::streamfx::gfx::rendertarget_pool>         _rt_pool;
 
 			double_t    _size;
 			std::size_t _iterations;
 
 			std::shared_ptr<streamfx::obs::gs::texture> _input_texture;
 
-			std::vector<std::shared_ptr<streamfx::obs::gs::rendertarget>> _rts;
+			std::shared_ptr<streamfx::obs::gs::rendertarget> _rt;
 
 			public:
 			dual_filtering();
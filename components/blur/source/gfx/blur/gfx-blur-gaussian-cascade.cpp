@@ -0,0 +1,317 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2023 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "gfx-blur-gaussian-cascade.hpp"
+#include "common.hpp"
+#include "obs/gs/gs-helper.hpp"
+#include "plugin.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "warning-enable.hpp"
+
+// Gaussian Cascade Blur
+//
+// Halving the size with a 2x2 box filter adds a variance of 1/4 texel^2 of the level being halved, and doubling it
+//  again with bilinear filtering adds 1/6 texel^2 of the level being doubled. Measured in texels of the input, going
+//  down n levels and back up adds up to:
+//
+//   (4^n - 1) / 12 + 2 * (4^n - 1) / 9 = (4^n - 1) * 11 / 36
+//
+// Whatever is left of the requested variance is applied at the smallest level, where it only costs a few samples.
+//  Levels are only added while at least ST_MIN_SIGMA is left to apply there, as a smaller Gaussian would not hide
+//  the blockiness of the bilinear upsampling.
+
+#define ST_MAX_LEVELS 16
+#define ST_MAX_SIZE 1024
+#define ST_MIN_SIGMA 4.
+#define ST_MAX_SIGMA 8.75 // (MAX_SAMPLES - 1) / 4, see gaussian-cascade.effect
+
+static inline double_t cascade_variance(std::size_t levels)
+{
+	return (std::pow(4., static_cast<double_t>(levels)) - 1.) * 11. / 36.;
+}
+
+streamfx::gfx::blur::gaussian_cascade_data::gaussian_cascade_data() : _gfx_util(::streamfx::gfx::util::get())
+{
+	auto gctx = streamfx::obs::gs::context();
+	{
+		auto file = streamfx::data_file_path("effects/blur/gaussian-cascade.effect");
+		try {
+			_effect = streamfx::obs::gs::effect::create(file);
+		} catch (const std::exception& ex) {
+			DLOG_ERROR("Error loading '%s': %s", file.generic_u8string().c_str(), ex.what());
+		}
+	}
+}
+
+streamfx::gfx::blur::gaussian_cascade_data::~gaussian_cascade_data()
+{
+	auto gctx = streamfx::obs::gs::context();
+	_effect.reset();
+}
+
+std::shared_ptr<streamfx::gfx::util> streamfx::gfx::blur::gaussian_cascade_data::get_gfx_util()
+{
+	return _gfx_util;
+}
+
+streamfx::obs::gs::effect streamfx::gfx::blur::gaussian_cascade_data::get_effect()
+{
+	return _effect;
+}
+
+streamfx::gfx::blur::gaussian_cascade_factory::gaussian_cascade_factory() {}
+
+streamfx::gfx::blur::gaussian_cascade_factory::~gaussian_cascade_factory() {}
+
+bool streamfx::gfx::blur::gaussian_cascade_factory::is_type_supported(::streamfx::gfx::blur::type type)
+{
+	switch (type) {
+	case ::streamfx::gfx::blur::type::Area:
+		return true;
+	default:
+		return false;
+	}
+}
+
+std::shared_ptr<::streamfx::gfx::blur::base> streamfx::gfx::blur::gaussian_cascade_factory::create(::streamfx::gfx::blur::type type)
+{
+	switch (type) {
+	case ::streamfx::gfx::blur::type::Area:
+		return std::make_shared<::streamfx::gfx::blur::gaussian_cascade>();
+	default:
+		throw std::runtime_error("Invalid type.");
+	}
+}
+
+double_t streamfx::gfx::blur::gaussian_cascade_factory::get_min_size(::streamfx::gfx::blur::type)
+{
+	return double_t(1.);
+}
+
+double_t streamfx::gfx::blur::gaussian_cascade_factory::get_step_size(::streamfx::gfx::blur::type)
+{
+	return double_t(1.);
+}
+
+double_t streamfx::gfx::blur::gaussian_cascade_factory::get_max_size(::streamfx::gfx::blur::type)
+{
+	return double_t(ST_MAX_SIZE);
+}
+
+double_t streamfx::gfx::blur::gaussian_cascade_factory::get_min_angle(::streamfx::gfx::blur::type)
+{
+	return double_t(0);
+}
+
+double_t streamfx::gfx::blur::gaussian_cascade_factory::get_step_angle(::streamfx::gfx::blur::type)
+{
+	return double_t(0);
+}
+
+double_t streamfx::gfx::blur::gaussian_cascade_factory::get_max_angle(::streamfx::gfx::blur::type)
+{
+	return double_t(0);
+}
+
+bool streamfx::gfx::blur::gaussian_cascade_factory::is_step_scale_supported(::streamfx::gfx::blur::type)
+{
+	return false;
+}
+
+double_t streamfx::gfx::blur::gaussian_cascade_factory::get_min_step_scale_x(::streamfx::gfx::blur::type)
+{
+	return double_t(0);
+}
+
+double_t streamfx::gfx::blur::gaussian_cascade_factory::get_step_step_scale_x(::streamfx::gfx::blur::type)
+{
+	return double_t(0);
+}
+
+double_t streamfx::gfx::blur::gaussian_cascade_factory::get_max_step_scale_x(::streamfx::gfx::blur::type)
+{
+	return double_t(0);
+}
+
+double_t streamfx::gfx::blur::gaussian_cascade_factory::get_min_step_scale_y(::streamfx::gfx::blur::type)
+{
+	return double_t(0);
+}
+
+double_t streamfx::gfx::blur::gaussian_cascade_factory::get_step_step_scale_y(::streamfx::gfx::blur::type)
+{
+	return double_t(0);
+}
+
+double_t streamfx::gfx::blur::gaussian_cascade_factory::get_max_step_scale_y(::streamfx::gfx::blur::type)
+{
+	return double_t(0);
+}
+
+std::shared_ptr<::streamfx::gfx::blur::gaussian_cascade_data> streamfx::gfx::blur::gaussian_cascade_factory::data()
+{
+	std::unique_lock<std::mutex>                                ulock(_data_lock);
+	std::shared_ptr<::streamfx::gfx::blur::gaussian_cascade_data> data = _data.lock();
+	if (!data) {
+		data  = std::make_shared<::streamfx::gfx::blur::gaussian_cascade_data>();
+		_data = data;
+	}
+	return data;
+}
+
+::streamfx::gfx::blur::gaussian_cascade_factory& streamfx::gfx::blur::gaussian_cascade_factory::get()
+{
+	static ::streamfx::gfx::blur::gaussian_cascade_factory instance;
+	return instance;
+}
+
+streamfx::gfx::blur::gaussian_cascade::gaussian_cascade() : _data(::streamfx::gfx::blur::gaussian_cascade_factory::get().data()), _rt_pool(::streamfx::gfx::rendertarget_pool::get()), _size(0)
+{
+	auto gctx = streamfx::obs::gs::context();
+	_rt       = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
+}
+
+streamfx::gfx::blur::gaussian_cascade::~gaussian_cascade() {}
+
+void streamfx::gfx::blur::gaussian_cascade::set_input(std::shared_ptr<::streamfx::obs::gs::texture> texture)
+{
+	_input_texture = std::move(texture);
+}
+
+::streamfx::gfx::blur::type streamfx::gfx::blur::gaussian_cascade::get_type()
+{
+	return ::streamfx::gfx::blur::type::Area;
+}
+
+double_t streamfx::gfx::blur::gaussian_cascade::get_size()
+{
+	return _size;
+}
+
+void streamfx::gfx::blur::gaussian_cascade::set_size(double_t width)
+{
+	_size = std::clamp<double_t>(width, 0., ST_MAX_SIZE);
+}
+
+void streamfx::gfx::blur::gaussian_cascade::set_step_scale(double_t, double_t) {}
+
+void streamfx::gfx::blur::gaussian_cascade::get_step_scale(double_t&, double_t&) {}
+
+void streamfx::gfx::blur::gaussian_cascade::pass(std::shared_ptr<streamfx::obs::gs::texture> input, std::shared_ptr<streamfx::obs::gs::rendertarget> output, uint32_t width, uint32_t height, const char* technique)
+{
+	auto effect = _data->get_effect();
+	effect.get_parameter("pImage").set_texture(input);
+
+	auto op = output->render(width, height);
+	gs_ortho(0., 1., 0., 1., 0., 1.);
+	while (gs_effect_loop(effect.get_object(), technique)) {
+		_data->get_gfx_util()->draw_fullscreen_triangle();
+	}
+}
+
+std::pair<std::size_t, double_t> streamfx::gfx::blur::gaussian_cascade::plan(double_t size, uint32_t width, uint32_t height)
+{
+	// Go down as far as the requested size and the input allow.
+	double_t    variance = size * size;
+	std::size_t levels   = 0;
+	while ((levels < ST_MAX_LEVELS) && ((width >> (levels + 1)) > 0) && ((height >> (levels + 1)) > 0)) {
+		double_t left = variance - cascade_variance(levels + 1);
+		if (left < (ST_MIN_SIGMA * ST_MIN_SIGMA * std::pow(4., static_cast<double_t>(levels + 1)))) {
+			break;
+		}
+		levels++;
+	}
+	double_t sigma = std::sqrt(std::max<double_t>(variance - cascade_variance(levels), 0.) / std::pow(4., static_cast<double_t>(levels)));
+	sigma          = std::min<double_t>(sigma, ST_MAX_SIGMA);
+
+	return {levels, sigma};
+}
+
+std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_cascade::render()
+{
+	auto gctx = streamfx::obs::gs::context();
+
+#if defined(ENABLE_PROFILING) && !defined(D_PLATFORM_MAC) && _DEBUG
+	auto gdmp = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Gaussian Cascade Blur");
+#endif
+
+	auto effect = _data->get_effect();
+	if (!effect || (_size < std::numeric_limits<double_t>::epsilon())) {
+		return _input_texture;
+	}
+
+	uint32_t width  = _input_texture->get_width();
+	uint32_t height = _input_texture->get_height();
+
+	auto [levels, sigma] = plan(_size, width, height);
+
+	gs_blend_state_push();
+	gs_reset_blend_state();
+	gs_enable_color(true, true, true, true);
+	gs_enable_blending(false);
+	gs_enable_depth_test(false);
+	gs_enable_stencil_test(false);
+	gs_enable_stencil_write(false);
+	gs_set_cull_mode(GS_NEITHER);
+	gs_depth_function(GS_ALWAYS);
+	gs_blend_function(GS_BLEND_ONE, GS_BLEND_ZERO);
+	gs_stencil_function(GS_STENCIL_BOTH, GS_ALWAYS);
+	gs_stencil_op(GS_STENCIL_BOTH, GS_ZERO, GS_ZERO, GS_ZERO);
+
+	// Only the output is kept, every other level is borrowed for the duration of this call.
+	std::vector<std::shared_ptr<streamfx::obs::gs::rendertarget>> rts(levels + 1);
+	rts[0] = _rt;
+	for (std::size_t n = 1; n <= levels; n++) {
+		rts[n] = _rt_pool->acquire(GS_RGBA, width >> n, height >> n);
+	}
+
+	// Downsample
+	for (std::size_t n = 1; n <= levels; n++) {
+#if defined(ENABLE_PROFILING) && !defined(D_PLATFORM_MAC) && _DEBUG
+		auto gdm = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Down %" PRIuMAX, n);
+#endif
+
+		pass((n > 1) ? rts[n - 1]->get_texture() : _input_texture, rts[n], width >> n, height >> n, "Resample");
+	}
+
+	// Blur
+	{
+#if defined(ENABLE_PROFILING) && !defined(D_PLATFORM_MAC) && _DEBUG
+		auto gdm = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Blur %" PRIuMAX, levels);
+#endif
+
+		uint32_t lwidth  = width >> levels;
+		uint32_t lheight = height >> levels;
+		auto     input   = (levels > 0) ? rts[levels]->get_texture() : _input_texture;
+		auto     scratch = _rt_pool->acquire(GS_RGBA, lwidth, lheight);
+
+		effect.get_parameter("pSize").set_float(static_cast<float>(sigma));
+		effect.get_parameter("pImageTexel").set_float2(1.f / static_cast<float>(lwidth), 0.f);
+		pass(input, scratch, lwidth, lheight, "Draw");
+		effect.get_parameter("pImageTexel").set_float2(0.f, 1.f / static_cast<float>(lheight));
+		pass(scratch->get_texture(), rts[levels], lwidth, lheight, "Draw");
+	}
+
+	// Upsample
+	for (std::size_t n = levels; n > 0; n--) {
+#if defined(ENABLE_PROFILING) && !defined(D_PLATFORM_MAC) && _DEBUG
+		auto gdm = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Up %" PRIuMAX, n);
+#endif
+
+		pass(rts[n]->get_texture(), rts[n - 1], width >> (n - 1), height >> (n - 1), "Resample");
+	}
+
+	gs_blend_state_pop();
+
+	return _rt->get_texture();
+}
+
+std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_cascade::get()
+{
+	return _rt->get_texture();
+}
@@ -0,0 +1,125 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2023 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "common.hpp"
+#include "gfx-blur-base.hpp"
+#include "gfx/gfx-rendertarget-pool.hpp"
+#include "gfx/gfx-util.hpp"
+#include "obs/gs/gs-effect.hpp"
+#include "obs/gs/gs-rendertarget.hpp"
+#include "obs/gs/gs-texture.hpp"
+
+#include "warning-disable.hpp"
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "warning-enable.hpp"
+
+namespace streamfx::gfx {
+	namespace blur {
+		class gaussian_cascade_data {
+			streamfx::obs::gs::effect            _effect;
+			std::shared_ptr<streamfx::gfx::util> _gfx_util;
+
+			public:
+			gaussian_cascade_data();
+			virtual ~gaussian_cascade_data();
+
+			std::shared_ptr<streamfx::gfx::util> get_gfx_util();
+
+			streamfx::obs::gs::effect get_effect();
+		};
+
+		class gaussian_cascade_factory : public ::streamfx::gfx::blur::ifactory {
+			std::mutex                                                _data_lock;
+			std::weak_ptr<::streamfx::gfx::blur::gaussian_cascade_data> _data;
+
+			public:
+			gaussian_cascade_factory();
+			virtual ~gaussian_cascade_factory() override;
+
+			virtual bool is_type_supported(::streamfx::gfx::blur::type type) override;
+
+			virtual std::shared_ptr<::streamfx::gfx::blur::base> create(::streamfx::gfx::blur::type type) override;
+
+			virtual double_t get_min_size(::streamfx::gfx::blur::type type) override;
+
+			virtual double_t get_step_size(::streamfx::gfx::blur::type type) override;
+
+			virtual double_t get_max_size(::streamfx::gfx::blur::type type) override;
+
+			virtual double_t get_min_angle(::streamfx::gfx::blur::type type) override;
+
+			virtual double_t get_step_angle(::streamfx::gfx::blur::type type) override;
+
+			virtual double_t get_max_angle(::streamfx::gfx::blur::type type) override;
+
+			virtual bool is_step_scale_supported(::streamfx::gfx::blur::type type) override;
+
+			virtual double_t get_min_step_scale_x(::streamfx::gfx::blur::type type) override;
+
+			virtual double_t get_step_step_scale_x(::streamfx::gfx::blur::type type) override;
+
+			virtual double_t get_max_step_scale_x(::streamfx::gfx::blur::type type) override;
+
+			virtual double_t get_min_step_scale_y(::streamfx::gfx::blur::type type) override;
+
+			virtual double_t get_step_step_scale_y(::streamfx::gfx::blur::type type) override;
+
+			virtual double_t get_max_step_scale_y(::streamfx::gfx::blur::type type) override;
+
+			std::shared_ptr<::streamfx::gfx::blur::gaussian_cascade_data> data();
+
+			public: // Singleton
+			static ::streamfx::gfx::blur::gaussian_cascade_factory& get();
+		};
+
+		/** Gaussian blur of (almost) any size at a cost that barely depends on the size.
+		 *
+		 * The input is halved in size until only a small Gaussian is left to apply, which is then scaled back up. The
+		 * blur added by each halving and doubling is subtracted from what is left to apply, so that the result is
+		 * close to a full size Gaussian of the same standard deviation.
+		 */
+		class gaussian_cascade : public ::streamfx::gfx::blur::base {
+			std::shared_ptr<::streamfx::gfx::blur::gaussian_cascade_data> _data;
+			std::shared_ptr<::streamfx::gfx::rendertarget_pool>           _rt_pool;
+
+			double_t _size;
+
+			std::shared_ptr<streamfx::obs::gs::texture> _input_texture;
+
+			std::shared_ptr<streamfx::obs::gs::rendertarget> _rt;
+
+			public:
+			gaussian_cascade();
+			virtual ~gaussian_cascade() override;
+
+			virtual void set_input(std::shared_ptr<::streamfx::obs::gs::texture> texture) override;
+
+			virtual ::streamfx::gfx::blur::type get_type() override;
+
+			virtual double_t get_size() override;
+
+			virtual void set_size(double_t width) override;
+
+			virtual void set_step_scale(double_t x, double_t y) override;
+
+			virtual void get_step_scale(double_t& x, double_t& y) override;
+
+			virtual std::shared_ptr<::streamfx::obs::gs::texture> render() override;
+
+			virtual std::shared_ptr<::streamfx::obs::gs::texture> get() override;
+
+			/** Number of levels to go down and the standard deviation (in texels of that level) to apply there.
+			 *
+			 * @param size Standard deviation of the requested blur, in texels of the input.
+			 */
+			static std::pair<std::size_t, double_t> plan(double_t size, uint32_t width, uint32_t height);
+
+			private:
+			void pass(std::shared_ptr<streamfx::obs::gs::texture> input, std::shared_ptr<streamfx::obs::gs::rendertarget> output, uint32_t width, uint32_t height, const char* technique);
+		};
+	} // namespace blur
+} // namespace streamfx::gfx
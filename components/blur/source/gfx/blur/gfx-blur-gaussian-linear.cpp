@@ -8,6 +8,8 @@
 #include "obs/gs/gs-helper.hpp"
 
 #include "warning-disable.hpp"
+#include <algorithm>
+#include <cmath>
 #include <stdexcept>
 #include "warning-enable.hpp"
 
@@ -20,51 +22,64 @@
 #define ST_SEARCH_DENSITY double_t(1. / 500.)
 #define ST_SEARCH_THRESHOLD double_t(1. / (ST_MAX_KERNEL_SIZE * 5))
 #define ST_SEARCH_EXTENSION 1
-#define ST_SEARCH_RANGE ST_MAX_KERNEL_SIZE * 2
 
-streamfx::gfx::blur::gaussian_linear_data::gaussian_linear_data() : _gfx_util(::streamfx::gfx::util::get())
-{
+// Kernels for every size, each stretched so that it only fades out at the edge.
+struct gaussian_linear_kernel {
+	static constexpr std::array<float, ST_MAX_KERNEL_SIZE> make(std::size_t kernel_size)
 	{
-		auto gctx = streamfx::obs::gs::context();
-
-		{
-			auto file = streamfx::data_file_path("effects/blur/gaussian-linear.effect");
-			try {
-				_effect = streamfx::obs::gs::effect::create(file);
-			} catch (const std::exception& ex) {
-				DLOG_ERROR("Error loading '%s': %s", file.generic_u8string().c_str(), ex.what());
-			}
+		std::array<double_t, ST_MAX_KERNEL_SIZE> kernel_math{};
+		std::array<float, ST_MAX_KERNEL_SIZE>    kernel_data{};
+		if (kernel_size == 0) {
+			kernel_data[0] = 1.f;
+			return kernel_data;
 		}
-	}
 
-	// Precalculate Kernels
-	for (std::size_t kernel_size = 1; kernel_size <= ST_MAX_BLUR_SIZE; kernel_size++) {
-		std::vector<double_t> kernel_math(ST_MAX_KERNEL_SIZE);
-		std::vector<float>  kernel_data(ST_MAX_KERNEL_SIZE);
-		double_t              actual_width = 1.;
-
-		// Find actual kernel width.
-		for (double_t h = ST_SEARCH_DENSITY; h < ST_SEARCH_RANGE; h += ST_SEARCH_DENSITY) {
-			if (streamfx::util::math::gaussian<double_t>(double_t(kernel_size + ST_SEARCH_EXTENSION), h) > ST_SEARCH_THRESHOLD) {
-				actual_width = h;
-				break;
+		// Find actual kernel width, the first step of the search grid past the threshold. The curve only rises until the
+		// width reaches the distance, so a binary search finds the same step as walking the grid would.
+		double_t    distance = double_t(kernel_size + ST_SEARCH_EXTENSION);
+		std::size_t low      = 1;
+		std::size_t high     = std::size_t(distance / ST_SEARCH_DENSITY);
+		while (low < high) {
+			std::size_t mid = low + (high - low) / 2;
+			if (streamfx::gfx::blur::kernel::gaussian(distance, double_t(mid) * ST_SEARCH_DENSITY) > ST_SEARCH_THRESHOLD) {
+				high = mid;
+			} else {
+				low = mid + 1;
 			}
 		}
+		double_t actual_width = double_t(low) * ST_SEARCH_DENSITY;
 
 		// Calculate and normalize
 		double_t sum = 0;
 		for (std::size_t p = 0; p <= kernel_size; p++) {
-			kernel_math[p] = streamfx::util::math::gaussian<double_t>(double_t(p), actual_width);
+			kernel_math[p] = streamfx::gfx::blur::kernel::gaussian(double_t(p), actual_width);
 			sum += kernel_math[p] * (p > 0 ? 2 : 1);
 		}
 
 		// Normalize to fill the entire 0..1 range over the width.
 		double_t inverse_sum = 1.0 / sum;
 		for (std::size_t p = 0; p <= kernel_size; p++) {
-			kernel_data.at(p) = float(kernel_math[p] * inverse_sum);
+			kernel_data[p] = float(kernel_math[p] * inverse_sum);
 		}
+		return kernel_data;
+	}
+};
+typedef streamfx::gfx::blur::kernel::table<gaussian_linear_kernel, ST_MAX_KERNEL_SIZE, ST_MAX_BLUR_SIZE + 1> gaussian_linear_kernels;
+static_assert(std::is_same_v<gaussian_linear_kernels::buffer_t, streamfx::gfx::blur::gaussian_linear_data::kernel_buffer_t>);
+
+streamfx::gfx::blur::gaussian_linear_data::gaussian_linear_data() : _gfx_util(::streamfx::gfx::util::get())
+{
+	{
+		auto gctx = streamfx::obs::gs::context();
 
-		_kernels.push_back(std::move(kernel_data));
+		{
+			auto file = streamfx::data_file_path("effects/blur/gaussian-linear.effect");
+			try {
+				_effect = streamfx::obs::gs::effect::create(file);
+			} catch (const std::exception& ex) {
+				DLOG_ERROR("Error loading '%s': %s", file.generic_u8string().c_str(), ex.what());
+			}
+		}
 	}
 }
 
@@ -78,14 +93,9 @@ streamfx::obs::gs::effect streamfx::gfx::blur::gaussian_linear_data::get_effect(
 	return _effect;
 }
 
-std::vector<float> const& streamfx::gfx::blur::gaussian_linear_data::get_kernel(std::size_t width)
+streamfx::gfx::blur::kernel::span streamfx::gfx::blur::gaussian_linear_data::get_kernel(double_t width, kernel_buffer_t& buffer)
 {
-	if (width < 1)
-		width = 1;
-	if (width > ST_MAX_BLUR_SIZE)
-		width = ST_MAX_BLUR_SIZE;
-	width -= 1;
-	return _kernels[width];
+	return gaussian_linear_kernels::get(std::clamp<double_t>(width, 1., ST_MAX_BLUR_SIZE), buffer);
 }
 
 std::shared_ptr<streamfx::gfx::util> streamfx::gfx::blur::gaussian_linear_data::get_gfx_util()
@@ -226,7 +236,7 @@ streamfx::gfx::blur::gaussian_linear::gaussian_linear() : _data(::streamfx::gfx:
 	auto gctx = streamfx::obs::gs::context();
 
 	_rendertarget  = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
-	_rendertarget2 = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
+	_rt_pool       = ::streamfx::gfx::rendertarget_pool::get();
 }
 
 streamfx::gfx::blur::gaussian_linear::~gaussian_linear() {}
@@ -286,7 +296,7 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_line
 #endif
 
 	streamfx::obs::gs::effect effect = _data->get_effect();
-	auto                      kernel = _data->get_kernel(size_t(_size));
+	auto                      kernel = _data->get_kernel(_size, _kernel);
 
 	if (!effect || ((_step_scale.first + _step_scale.second) < std::numeric_limits<double_t>::epsilon())) {
 		return _input_texture;
@@ -309,13 +319,22 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_line
 	gs_stencil_function(GS_STENCIL_BOTH, GS_ALWAYS);
 	gs_stencil_op(GS_STENCIL_BOTH, GS_ZERO, GS_ZERO, GS_ZERO);
 
-	effect.get_parameter("pImage").set_texture(_input_texture);
 	effect.get_parameter("pStepScale").set_float2(float(_step_scale.first), float(_step_scale.second));
-	effect.get_parameter("pSize").set_float(float(_size));
+	effect.get_parameter("pSize").set_float(float(std::ceil(_size)));
 	effect.get_parameter("pKernel").set_value(kernel.data(), ST_MAX_KERNEL_SIZE);
 
+	bool horizontal = (_step_scale.first > std::numeric_limits<double_t>::epsilon());
+	bool vertical   = (_step_scale.second > std::numeric_limits<double_t>::epsilon());
+
+	// The last pass always ends up in our own render target, so only the one between two passes has to be borrowed.
+	std::shared_ptr<streamfx::obs::gs::rendertarget> scratch;
+	if (horizontal && vertical) {
+		scratch = _rt_pool->acquire(GS_RGBA, uint32_t(width), uint32_t(height));
+	}
+
 	// First Pass
-	if (_step_scale.first > std::numeric_limits<double_t>::epsilon()) {
+	if (horizontal) {
+		effect.get_parameter("pImage").set_texture(_input_texture);
 		effect.get_parameter("pImageTexel").set_float2(float(1.f / width), 0.f);
 
 		{
@@ -323,19 +342,17 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_line
 			auto gdm = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Horizontal");
 #endif
 
-			auto op = _rendertarget2->render(uint32_t(width), uint32_t(height));
+			auto op = (vertical ? scratch : _rendertarget)->render(uint32_t(width), uint32_t(height));
 			gs_ortho(0, 1., 0, 1., 0, 1.);
 			while (gs_effect_loop(effect.get_object(), "Draw")) {
 				_data->get_gfx_util()->draw_fullscreen_triangle();
 			}
 		}
-
-		std::swap(_rendertarget, _rendertarget2);
-		effect.get_parameter("pImage").set_texture(_rendertarget->get_texture());
 	}
 
 	// Second Pass
-	if (_step_scale.second > std::numeric_limits<double_t>::epsilon()) {
+	if (vertical) {
+		effect.get_parameter("pImage").set_texture(horizontal ? scratch->get_texture() : _input_texture);
 		effect.get_parameter("pImageTexel").set_float2(0.f, float(1.f / height));
 
 		{
@@ -343,14 +360,12 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_line
 			auto gdm = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Vertical");
 #endif
 
-			auto op = _rendertarget2->render(uint32_t(width), uint32_t(height));
+			auto op = _rendertarget->render(uint32_t(width), uint32_t(height));
 			gs_ortho(0, 1., 0, 1., 0, 1.);
 			while (gs_effect_loop(effect.get_object(), "Draw")) {
 				_data->get_gfx_util()->draw_fullscreen_triangle();
 			}
 		}
-
-		std::swap(_rendertarget, _rendertarget2);
 	}
 
 	gs_blend_state_pop();
@@ -391,7 +406,7 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_line
 #endif
 
 	streamfx::obs::gs::effect effect = _data->get_effect();
-	auto                      kernel = _data->get_kernel(size_t(_size));
+	auto                      kernel = _data->get_kernel(_size, _kernel);
 
 	if (!effect || ((_step_scale.first + _step_scale.second) < std::numeric_limits<double_t>::epsilon())) {
 		return _input_texture;
@@ -417,7 +432,7 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_line
 	effect.get_parameter("pImage").set_texture(_input_texture);
 	effect.get_parameter("pImageTexel").set_float2(float(1.f / width * cos(_angle)), float(1.f / height * sin(_angle)));
 	effect.get_parameter("pStepScale").set_float2(float(_step_scale.first), float(_step_scale.second));
-	effect.get_parameter("pSize").set_float(float(_size));
+	effect.get_parameter("pSize").set_float(float(std::ceil(_size)));
 	effect.get_parameter("pKernel").set_value(kernel.data(), ST_MAX_KERNEL_SIZE);
 
 	// First Pass
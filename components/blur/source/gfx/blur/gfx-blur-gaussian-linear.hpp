@@ -5,14 +5,16 @@
 #pragma once
 #include "common.hpp"
 #include "gfx-blur-base.hpp"
+#include "gfx-blur-kernel.hpp"
+#include "gfx/gfx-rendertarget-pool.hpp"
 #include "gfx/gfx-util.hpp"
 #include "obs/gs/gs-effect.hpp"
 #include "obs/gs/gs-rendertarget.hpp"
 #include "obs/gs/gs-texture.hpp"
 
 #include "warning-disable.hpp"
+#include <array>
 #include <mutex>
-#include <vector>
 #include "warning-enable.hpp"
 
 namespace streamfx::gfx {
@@ -20,9 +22,10 @@ namespace streamfx::gfx {
 		class gaussian_linear_data {
 			streamfx::obs::gs::effect            _effect;
 			std::shared_ptr<streamfx::gfx::util> _gfx_util;
-			std::vector<std::vector<float>>    _kernels;
 
 			public:
+			typedef std::array<float, 128> kernel_buffer_t;
+
 			gaussian_linear_data();
 			virtual ~gaussian_linear_data();
 
@@ -30,7 +33,11 @@ namespace streamfx::gfx {
 
 			streamfx::obs::gs::effect get_effect();
 
-			std::vector<float> const& get_kernel(std::size_t width);
+			/** The kernel for a size, blended into buffer if the size is fractional.
+			 *
+			 * Kernels are generated at compile time, so this works without a graphics context.
+			 */
+			static streamfx::gfx::blur::kernel::span get_kernel(double_t width, kernel_buffer_t& buffer);
 		};
 
 		class gaussian_linear_factory : public ::streamfx::gfx::blur::ifactory {
@@ -85,9 +92,10 @@ namespace streamfx::gfx {
 			std::pair<double_t, double_t>                      _step_scale;
 			std::shared_ptr<::streamfx::obs::gs::texture>      _input_texture;
 			std::shared_ptr<::streamfx::obs::gs::rendertarget> _rendertarget;
+			gaussian_linear_data::kernel_buffer_t              _kernel;
 
 			private:
-			std::shared_ptr<::streamfx::obs::gs::rendertarget> _rendertarget2;
+			std::shared_ptr<::streamfx::gfx::rendertarget_pool> _rt_pool;
 
 			public:
 			gaussian_linear();
@@ -11,6 +11,7 @@
 
 #include "warning-disable.hpp"
 #include <algorithm>
+#include <cmath>
 #include <stdexcept>
 #include "warning-enable.hpp"
 
@@ -18,83 +19,57 @@
 
 #define ST_KERNEL_SIZE 128u
 #define ST_OVERSAMPLE_MULTIPLIER 2
-#define ST_MAX_BLUR_SIZE ST_KERNEL_SIZE / ST_OVERSAMPLE_MULTIPLIER
+#define ST_MAX_BLUR_SIZE (ST_KERNEL_SIZE / ST_OVERSAMPLE_MULTIPLIER)
 
-streamfx::gfx::blur::gaussian_data::gaussian_data() : _gfx_util(::streamfx::gfx::util::get())
-{
-	using namespace streamfx::util;
-
-	std::array<double, ST_KERNEL_SIZE> kernel_dbl;
-	std::vector<float>                 kernel(ST_KERNEL_SIZE);
+// Same order as gaussian_parameter.
+static constexpr std::array<const char*, 7> parameter_names = {"pImage", "pImageTexel", "pStepScale", "pSize", "pAngle", "pCenter", "pKernel"};
 
+// Kernels for every size, with ST_OVERSAMPLE_MULTIPLIER samples per unit of size.
+struct gaussian_kernel {
+	static constexpr std::array<float, ST_KERNEL_SIZE> make(std::size_t size)
 	{
-		auto gctx = streamfx::obs::gs::context();
-
-		{
-			auto file = streamfx::data_file_path("effects/blur/gaussian.effect");
-			try {
-				_effect = streamfx::obs::gs::effect::create(file);
-			} catch (const std::exception& ex) {
-				DLOG_ERROR("Error loading '%s': %s", file.generic_u8string().c_str(), ex.what());
-			}
-		}
-	}
-
-	//#define ST_USE_PASCAL_TRIANGLE
-
-	// Pre-calculate Kernel Information for all Kernel sizes
-	for (size_t size = 1; size <= ST_MAX_BLUR_SIZE; size++) {
-#ifdef ST_USE_PASCAL_TRIANGLE
-		// The Pascal Triangle can be used to generate Gaussian Kernels, which is
-		// significantly faster than doing the same task with searching. It is also
-		// much more accurate at the same time, so it is a 2-in-1 solution.
-
-		// Generate the required row and sum.
-		size_t offset   = size;
-		size_t row      = size * 2;
-		auto   triangle = math::pascal_triangle<double>(row);
-		double sum      = pow(2, row);
-
-		// Convert all integers to floats.
-		double accum = 0.;
-		for (size_t idx = offset; idx < std::min<size_t>(triangle.size(), ST_KERNEL_SIZE); idx++) {
-			double v                 = static_cast<double>(triangle[idx]) / sum;
-			kernel_dbl[idx - offset] = v;
-			// Accumulator needed as we end up with float inaccuracies above a certain threshold.
-			accum += v * (idx > offset ? 2 : 1);
+		std::array<double, ST_KERNEL_SIZE> weights{};
+		std::array<float, ST_KERNEL_SIZE>  kernel{};
+		if (size == 0) {
+			kernel[0] = 1.f;
+			return kernel;
 		}
 
-		// Rescale all values back into useful ranges.
-		accum = 1. / accum;
-		for (size_t idx = offset; idx < ST_KERNEL_SIZE; idx++) {
-			kernel[idx - offset] = kernel_dbl[idx - offset] * accum;
-		}
-#else
-		size_t oversample = size * ST_OVERSAMPLE_MULTIPLIER;
-
 		// Generate initial weights and calculate a total from them.
-		double total = 0.;
-		for (size_t idx = 0; (idx < oversample) && (idx < ST_KERNEL_SIZE); idx++) {
-			kernel_dbl[idx] = math::gaussian<double>(static_cast<double>(idx), static_cast<double>(size));
-			total += kernel_dbl[idx] * (idx > 0 ? 2 : 1);
+		std::size_t oversample = size * ST_OVERSAMPLE_MULTIPLIER;
+		double      total      = 0.;
+		for (std::size_t idx = 0; (idx < oversample) && (idx < ST_KERNEL_SIZE); idx++) {
+			weights[idx] = streamfx::gfx::blur::kernel::gaussian(static_cast<double>(idx), static_cast<double>(size));
+			total += weights[idx] * (idx > 0 ? 2 : 1);
 		}
 
 		// Scale the weights according to the total gathered, and convert to float.
-		for (size_t idx = 0; (idx < oversample) && (idx < ST_KERNEL_SIZE); idx++) {
-			kernel_dbl[idx] /= total;
-			kernel[idx] = static_cast<float>(kernel_dbl[idx]);
+		for (std::size_t idx = 0; (idx < oversample) && (idx < ST_KERNEL_SIZE); idx++) {
+			kernel[idx] = static_cast<float>(weights[idx] / total);
 		}
+		return kernel;
+	}
+};
+typedef streamfx::gfx::blur::kernel::table<gaussian_kernel, ST_KERNEL_SIZE, ST_MAX_BLUR_SIZE + 1> gaussian_kernels;
+static_assert(std::is_same_v<gaussian_kernels::buffer_t, streamfx::gfx::blur::gaussian_data::kernel_buffer_t>);
 
-#endif
+streamfx::gfx::blur::gaussian_data::gaussian_data() : _gfx_util(::streamfx::gfx::util::get())
+{
+	auto gctx = streamfx::obs::gs::context();
 
-		// Store Kernel
-		_kernels.insert_or_assign(size, kernel);
+	auto file = streamfx::data_file_path("effects/blur/gaussian.effect");
+	try {
+		_effect = streamfx::obs::gs::effect::create(file);
+		_parameters.bind(_effect, parameter_names);
+	} catch (const std::exception& ex) {
+		DLOG_ERROR("Error loading '%s': %s", file.generic_u8string().c_str(), ex.what());
 	}
 }
 
 streamfx::gfx::blur::gaussian_data::~gaussian_data()
 {
 	auto gctx = streamfx::obs::gs::context();
+	_parameters.reset();
 	_effect.reset();
 }
 
@@ -103,15 +78,19 @@ streamfx::obs::gs::effect streamfx::gfx::blur::gaussian_data::get_effect()
 	return _effect;
 }
 
+streamfx::gfx::blur::gaussian_parameters& streamfx::gfx::blur::gaussian_data::get_parameters()
+{
+	return _parameters;
+}
+
 std::shared_ptr<streamfx::gfx::util> streamfx::gfx::blur::gaussian_data::get_gfx_util()
 {
 	return _gfx_util;
 }
 
-std::vector<float> const& streamfx::gfx::blur::gaussian_data::get_kernel(std::size_t width)
+streamfx::gfx::blur::kernel::span streamfx::gfx::blur::gaussian_data::get_kernel(double_t width, kernel_buffer_t& buffer)
 {
-	width = std::clamp<size_t>(width, 1, ST_MAX_BLUR_SIZE);
-	return _kernels.at(width);
+	return gaussian_kernels::get(std::clamp<double_t>(width, 1., ST_MAX_BLUR_SIZE), buffer);
 }
 
 streamfx::gfx::blur::gaussian_factory::gaussian_factory() {}
@@ -255,7 +234,7 @@ streamfx::gfx::blur::gaussian::gaussian() : _data(::streamfx::gfx::blur::gaussia
 {
 	auto gctx      = streamfx::obs::gs::context();
 	_rendertarget  = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
-	_rendertarget2 = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
+	_rt_pool       = ::streamfx::gfx::rendertarget_pool::get();
 }
 
 streamfx::gfx::blur::gaussian::~gaussian() {}
@@ -315,12 +294,13 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian::ren
 #endif
 
 	streamfx::obs::gs::effect effect = _data->get_effect();
+	auto&                     params = _data->get_parameters();
 
 	if (!effect || ((_step_scale.first + _step_scale.second) < std::numeric_limits<double_t>::epsilon())) {
 		return _input_texture;
 	}
 
-	auto    kernel = _data->get_kernel(size_t(_size));
+	auto    kernel = _data->get_kernel(_size, _kernel);
 	float width  = float(_input_texture->get_width());
 	float height = float(_input_texture->get_height());
 
@@ -338,48 +318,53 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian::ren
 	gs_stencil_function(GS_STENCIL_BOTH, GS_ALWAYS);
 	gs_stencil_op(GS_STENCIL_BOTH, GS_ZERO, GS_ZERO, GS_ZERO);
 
-	effect.get_parameter("pStepScale").set_float2(float(_step_scale.first), float(_step_scale.second));
-	effect.get_parameter("pSize").set_float(float(_size * ST_OVERSAMPLE_MULTIPLIER));
-	effect.get_parameter("pKernel").set_value(kernel.data(), ST_KERNEL_SIZE);
+	params[gaussian_parameter::StepScale].set_float2(float(_step_scale.first), float(_step_scale.second));
+	params[gaussian_parameter::Size].set_float(float(std::ceil(_size) * ST_OVERSAMPLE_MULTIPLIER));
+	params[gaussian_parameter::Kernel].set_value(kernel.data(), ST_KERNEL_SIZE);
+
+	bool horizontal = (_step_scale.first > std::numeric_limits<double_t>::epsilon());
+	bool vertical   = (_step_scale.second > std::numeric_limits<double_t>::epsilon());
+
+	// The last pass always ends up in our own render target, so only the one between two passes has to be borrowed.
+	std::shared_ptr<streamfx::obs::gs::rendertarget> scratch;
+	if (horizontal && vertical) {
+		scratch = _rt_pool->acquire(GS_RGBA, uint32_t(width), uint32_t(height));
+	}
 
 	// First Pass
-	if (_step_scale.first > std::numeric_limits<double_t>::epsilon()) {
-		effect.get_parameter("pImage").set_texture(_input_texture);
-		effect.get_parameter("pImageTexel").set_float2(float(1.f / width), 0.f);
+	if (horizontal) {
+		params[gaussian_parameter::Image].set_texture(_input_texture);
+		params[gaussian_parameter::ImageTexel].set_float2(float(1.f / width), 0.f);
 
 		{
 #if defined(ENABLE_PROFILING) && !defined(D_PLATFORM_MAC) && _DEBUG
 			auto gdm = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Horizontal");
 #endif
 
-			auto op = _rendertarget2->render(uint32_t(width), uint32_t(height));
+			auto op = (vertical ? scratch : _rendertarget)->render(uint32_t(width), uint32_t(height));
 			gs_ortho(0, 1., 0, 1., 0, 1.);
 			while (gs_effect_loop(effect.get_object(), "Draw")) {
 				_data->get_gfx_util()->draw_fullscreen_triangle();
 			}
 		}
-
-		std::swap(_rendertarget, _rendertarget2);
 	}
 
 	// Second Pass
-	if (_step_scale.second > std::numeric_limits<double_t>::epsilon()) {
-		effect.get_parameter("pImage").set_texture(_rendertarget->get_texture());
-		effect.get_parameter("pImageTexel").set_float2(0.f, float(1.f / height));
+	if (vertical) {
+		params[gaussian_parameter::Image].set_texture(horizontal ? scratch->get_texture() : _input_texture);
+		params[gaussian_parameter::ImageTexel].set_float2(0.f, float(1.f / height));
 
 		{
 #if defined(ENABLE_PROFILING) && !defined(D_PLATFORM_MAC) && _DEBUG
 			auto gdm = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Vertical");
 #endif
 
-			auto op = _rendertarget2->render(uint32_t(width), uint32_t(height));
+			auto op = _rendertarget->render(uint32_t(width), uint32_t(height));
 			gs_ortho(0, 1., 0, 1., 0, 1.);
 			while (gs_effect_loop(effect.get_object(), "Draw")) {
 				_data->get_gfx_util()->draw_fullscreen_triangle();
 			}
 		}
-
-		std::swap(_rendertarget, _rendertarget2);
 	}
 
 	gs_blend_state_pop();
@@ -420,12 +405,13 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_dire
 #endif
 
 	streamfx::obs::gs::effect effect = _data->get_effect();
+	auto&                     params = _data->get_parameters();
 
 	if (!effect || ((_step_scale.first + _step_scale.second) < std::numeric_limits<double_t>::epsilon())) {
 		return _input_texture;
 	}
 
-	auto    kernel = _data->get_kernel(size_t(_size));
+	auto    kernel = _data->get_kernel(_size, _kernel);
 	float width  = float(_input_texture->get_width());
 	float height = float(_input_texture->get_height());
 
@@ -443,11 +429,11 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_dire
 	gs_stencil_function(GS_STENCIL_BOTH, GS_ALWAYS);
 	gs_stencil_op(GS_STENCIL_BOTH, GS_ZERO, GS_ZERO, GS_ZERO);
 
-	effect.get_parameter("pImage").set_texture(_input_texture);
-	effect.get_parameter("pImageTexel").set_float2(float(1.f / width * cos(m_angle)), float(1.f / height * sin(m_angle)));
-	effect.get_parameter("pStepScale").set_float2(float(_step_scale.first), float(_step_scale.second));
-	effect.get_parameter("pSize").set_float(float(_size * ST_OVERSAMPLE_MULTIPLIER));
-	effect.get_parameter("pKernel").set_value(kernel.data(), ST_KERNEL_SIZE);
+	params[gaussian_parameter::Image].set_texture(_input_texture);
+	params[gaussian_parameter::ImageTexel].set_float2(float(1.f / width * cos(m_angle)), float(1.f / height * sin(m_angle)));
+	params[gaussian_parameter::StepScale].set_float2(float(_step_scale.first), float(_step_scale.second));
+	params[gaussian_parameter::Size].set_float(float(std::ceil(_size) * ST_OVERSAMPLE_MULTIPLIER));
+	params[gaussian_parameter::Kernel].set_value(kernel.data(), ST_KERNEL_SIZE);
 
 	{
 		auto op = _rendertarget->render(uint32_t(width), uint32_t(height));
@@ -476,12 +462,13 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_rota
 #endif
 
 	streamfx::obs::gs::effect effect = _data->get_effect();
+	auto&                     params = _data->get_parameters();
 
 	if (!effect || ((_step_scale.first + _step_scale.second) < std::numeric_limits<double_t>::epsilon())) {
 		return _input_texture;
 	}
 
-	auto    kernel = _data->get_kernel(size_t(_size));
+	auto    kernel = _data->get_kernel(_size, _kernel);
 	float width  = float(_input_texture->get_width());
 	float height = float(_input_texture->get_height());
 
@@ -499,13 +486,13 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_rota
 	gs_stencil_function(GS_STENCIL_BOTH, GS_ALWAYS);
 	gs_stencil_op(GS_STENCIL_BOTH, GS_ZERO, GS_ZERO, GS_ZERO);
 
-	effect.get_parameter("pImage").set_texture(_input_texture);
-	effect.get_parameter("pImageTexel").set_float2(float(1.f / width), float(1.f / height));
-	effect.get_parameter("pStepScale").set_float2(float(_step_scale.first), float(_step_scale.second));
-	effect.get_parameter("pSize").set_float(float(_size * ST_OVERSAMPLE_MULTIPLIER));
-	effect.get_parameter("pAngle").set_float(float(m_angle / _size));
-	effect.get_parameter("pCenter").set_float2(float(m_center.first), float(m_center.second));
-	effect.get_parameter("pKernel").set_value(kernel.data(), ST_KERNEL_SIZE);
+	params[gaussian_parameter::Image].set_texture(_input_texture);
+	params[gaussian_parameter::ImageTexel].set_float2(float(1.f / width), float(1.f / height));
+	params[gaussian_parameter::StepScale].set_float2(float(_step_scale.first), float(_step_scale.second));
+	params[gaussian_parameter::Size].set_float(float(std::ceil(_size) * ST_OVERSAMPLE_MULTIPLIER));
+	params[gaussian_parameter::Angle].set_float(float(m_angle / _size));
+	params[gaussian_parameter::Center].set_float2(float(m_center.first), float(m_center.second));
+	params[gaussian_parameter::Kernel].set_value(kernel.data(), ST_KERNEL_SIZE);
 
 	// First Pass
 	{
@@ -557,7 +544,8 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_zoom
 #endif
 
 	streamfx::obs::gs::effect effect = _data->get_effect();
-	auto                      kernel = _data->get_kernel(size_t(_size));
+	auto&                     params = _data->get_parameters();
+	auto                      kernel = _data->get_kernel(_size, _kernel);
 
 	if (!effect || ((_step_scale.first + _step_scale.second) < std::numeric_limits<double_t>::epsilon())) {
 		return _input_texture;
@@ -580,12 +568,12 @@ std::shared_ptr<::streamfx::obs::gs::texture> streamfx::gfx::blur::gaussian_zoom
 	gs_stencil_function(GS_STENCIL_BOTH, GS_ALWAYS);
 	gs_stencil_op(GS_STENCIL_BOTH, GS_ZERO, GS_ZERO, GS_ZERO);
 
-	effect.get_parameter("pImage").set_texture(_input_texture);
-	effect.get_parameter("pImageTexel").set_float2(float(1.f / width), float(1.f / height));
-	effect.get_parameter("pStepScale").set_float2(float(_step_scale.first), float(_step_scale.second));
-	effect.get_parameter("pSize").set_float(float(_size));
-	effect.get_parameter("pCenter").set_float2(float(m_center.first), float(m_center.second));
-	effect.get_parameter("pKernel").set_value(kernel.data(), ST_KERNEL_SIZE);
+	params[gaussian_parameter::Image].set_texture(_input_texture);
+	params[gaussian_parameter::ImageTexel].set_float2(float(1.f / width), float(1.f / height));
+	params[gaussian_parameter::StepScale].set_float2(float(_step_scale.first), float(_step_scale.second));
+	params[gaussian_parameter::Size].set_float(float(std::ceil(_size)));
+	params[gaussian_parameter::Center].set_float2(float(m_center.first), float(m_center.second));
+	params[gaussian_parameter::Kernel].set_value(kernel.data(), ST_KERNEL_SIZE);
 
 	// First Pass
 	{
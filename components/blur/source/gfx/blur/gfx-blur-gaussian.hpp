@@ -5,32 +5,53 @@
 #pragma once
 #include "common.hpp"
 #include "gfx-blur-base.hpp"
+#include "gfx-blur-kernel.hpp"
+#include "gfx/gfx-rendertarget-pool.hpp"
 #include "gfx/gfx-util.hpp"
 #include "obs/gs/gs-effect.hpp"
 #include "obs/gs/gs-rendertarget.hpp"
 #include "obs/gs/gs-texture.hpp"
 
 #include "warning-disable.hpp"
+#include <array>
 #include <mutex>
-#include <vector>
 #include "warning-enable.hpp"
 
 namespace streamfx::gfx {
 	namespace blur {
+		enum class gaussian_parameter : std::size_t {
+			Image,
+			ImageTexel,
+			StepScale,
+			Size,
+			Angle,
+			Center,
+			Kernel,
+		};
+		typedef streamfx::obs::gs::effect_bindings<7> gaussian_parameters;
+
 		class gaussian_data {
 			streamfx::obs::gs::effect            _effect;
+			gaussian_parameters                  _parameters;
 			std::shared_ptr<streamfx::gfx::util> _gfx_util;
-			std::map<size_t, std::vector<float>> _kernels;
 
 			public:
+			typedef std::array<float, 128> kernel_buffer_t;
+
 			gaussian_data();
 			virtual ~gaussian_data();
 
 			streamfx::obs::gs::effect get_effect();
 
+			gaussian_parameters& get_parameters();
+
 			std::shared_ptr<streamfx::gfx::util> get_gfx_util();
 
-			std::vector<float> const& get_kernel(std::size_t width);
+			/** The kernel for a size, blended into buffer if the size is fractional.
+			 *
+			 * Kernels are generated at compile time, so this works without a graphics context.
+			 */
+			static streamfx::gfx::blur::kernel::span get_kernel(double_t width, kernel_buffer_t& buffer);
 		};
 
 		class gaussian_factory : public ::streamfx::gfx::blur::ifactory {
@@ -85,9 +106,10 @@ namespace streamfx::gfx {
 			std::pair<double_t, double_t>                      _step_scale;
 			std::shared_ptr<::streamfx::obs::gs::texture>      _input_texture;
 			std::shared_ptr<::streamfx::obs::gs::rendertarget> _rendertarget;
+			gaussian_data::kernel_buffer_t                     _kernel;
 
 			private:
-			std::shared_ptr<::streamfx::obs::gs::rendertarget> _rendertarget2;
+			std::shared_ptr<::streamfx::gfx::rendertarget_pool> _rt_pool;
 
 			public:
 			gaussian();
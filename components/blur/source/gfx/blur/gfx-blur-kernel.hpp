@@ -0,0 +1,146 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2023 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "common.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <utility>
+#include "warning-enable.hpp"
+
+namespace streamfx::gfx::blur {
+	namespace kernel {
+		/** std::exp() is not usable in constant expressions before C++26, so this is what tables are generated with.
+		 *
+		 * Splits x into k*ln(2) + r with |r| <= ln(2)/2, then uses a Taylor series for e^r. Relative error stays below 1e-13 outside of the denormal range.
+		 */
+		constexpr double exp(double x)
+		{
+			constexpr double ln2 = 0.69314718055994530942;
+			if (x < -708.) {
+				return 0.;
+			}
+
+			long long k = static_cast<long long>((x / ln2) + ((x < 0.) ? -0.5 : 0.5));
+			double    r = x - (static_cast<double>(k) * ln2);
+
+			double term = 1.;
+			double sum  = 1.;
+			for (int n = 1; n < 14; n++) {
+				term *= r / n;
+				sum += term;
+			}
+
+			// Square-and-multiply, so that large exponents stay cheap to evaluate.
+			double    base  = (k < 0) ? .5 : 2.;
+			long long power = (k < 0) ? -k : k;
+			for (; power > 0; power >>= 1, base *= base) {
+				if (power & 1) {
+					sum *= base;
+				}
+			}
+			return sum;
+		}
+
+		/** Same as streamfx::util::math::gaussian(), but usable in constant expressions. */
+		constexpr double gaussian(double x, double o)
+		{
+			constexpr double two_pi_sqroot = 2.506628274631000502415765284811;
+			return (1. / (o * two_pi_sqroot)) * exp(-.5 * (x / o) * (x / o));
+		}
+
+		/** A non-owning view of a single kernel, which stays valid for as long as its table or buffer does. */
+		class span {
+			const float* _data;
+			std::size_t  _size;
+
+			public:
+			constexpr span(const float* data, std::size_t size) : _data(data), _size(size) {}
+
+			constexpr const float* data() const
+			{
+				return _data;
+			}
+
+			constexpr std::size_t size() const
+			{
+				return _size;
+			}
+
+			constexpr float operator[](std::size_t idx) const
+			{
+				return _data[idx];
+			}
+		};
+
+		/** Kernels for every integer radius from 0 to Radii - 1, stored back to back in a single aligned block.
+		 *
+		 * Generator must provide `static constexpr std::array<float, Width> make(std::size_t radius)`. Every row is its
+		 * own constant evaluation, which keeps each of them well below the step limits of the various compilers.
+		 */
+		template<typename Generator, std::size_t Width, std::size_t Radii>
+		class table {
+			public:
+			typedef std::array<float, Width> buffer_t;
+
+			private:
+			template<std::size_t Radius>
+			static constexpr buffer_t row = Generator::make(Radius);
+
+			template<std::size_t... Radius>
+			static constexpr std::array<buffer_t, Radii> build(std::index_sequence<Radius...>)
+			{
+				return {{row<Radius>...}};
+			}
+
+			alignas(64) static constexpr std::array<buffer_t, Radii> _rows = build(std::make_index_sequence<Radii>{});
+
+			public:
+			static constexpr std::size_t width()
+			{
+				return Width;
+			}
+
+			static constexpr std::size_t radii()
+			{
+				return Radii;
+			}
+
+			/** The kernel for an integer radius, clamped to the table. */
+			static constexpr span get(std::size_t radius)
+			{
+				radius = (radius < Radii) ? radius : (Radii - 1);
+				return span(_rows[radius].data(), Width);
+			}
+
+			/** The kernel for a fractional radius, blended from the two closest rows.
+			 *
+			 * Integer radii are returned from the table directly, and buffer is left untouched.
+			 */
+			static span get(double radius, buffer_t& buffer)
+			{
+				radius = std::clamp(radius, 0., double(Radii - 1));
+
+				double      lower = std::floor(radius);
+				double      t     = radius - lower;
+				std::size_t index = static_cast<std::size_t>(lower);
+				if ((t <= 0.) || (index + 1 >= Radii)) {
+					return get(index);
+				}
+
+				const buffer_t& a = _rows[index];
+				const buffer_t& b = _rows[index + 1];
+				float           f = static_cast<float>(t);
+				for (std::size_t idx = 0; idx < Width; idx++) {
+					buffer[idx] = a[idx] + (b[idx] - a[idx]) * f;
+				}
+				return span(buffer.data(), Width);
+			}
+		};
+	} // namespace kernel
+} // namespace streamfx::gfx::blur
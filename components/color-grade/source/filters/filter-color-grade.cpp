@@ -108,12 +108,29 @@ using namespace streamfx::filter::color_grade;
 
 static constexpr std::string_view HELP_URL = "https://github.com/Xaymar/obs-StreamFX/wiki/Filter-Color-Grade";
 
+// Parameters of color-grade.effect, same order as effect_param_names.
+enum class effect_param : std::size_t {
+	Image,
+	Lift,
+	Gamma,
+	Gain,
+	Offset,
+	TintDetection,
+	TintMode,
+	TintExponent,
+	TintLow,
+	TintMid,
+	TintHig,
+	Correction,
+};
+static constexpr std::array<const char*, 12> effect_param_names = {"image", "pLift", "pGamma", "pGain", "pOffset", "pTintDetection", "pTintMode", "pTintExponent", "pTintLow", "pTintMid", "pTintHig", "pCorrection"};
+
 // TODO: Figure out a way to merge _lut_rt, _lut_texture, _rt_source, _rt_grad, _tex_source, _tex_grade, _source_updated and _grade_updated.
 // Seriously this is too much GPU space wasted on unused trash.
 
 color_grade_instance::~color_grade_instance() {}
 
-color_grade_instance::color_grade_instance(obs_data_t* data, obs_source_t* self) : obs::source_instance(data, self), _effect(), _gfx_util(::streamfx::gfx::util::get()), _lift(), _gamma(), _gain(), _offset(), _tint_detection(), _tint_luma(), _tint_exponent(), _tint_low(), _tint_mid(), _tint_hig(), _correction(), _lut_enabled(true), _lut_depth(), _ccache_rt(), _ccache_texture(), _ccache_fresh(false), _lut_initialized(false), _lut_dirty(true), _lut_producer(), _lut_consumer(), _lut_rt(), _lut_texture(), _cache_rt(), _cache_texture(), _cache_fresh(false)
+color_grade_instance::color_grade_instance(obs_data_t* data, obs_source_t* self) : obs::source_instance(data, self), _effect(), _effect_params(), _gfx_util(::streamfx::gfx::util::get()), _rt_pool(::streamfx::gfx::rendertarget_pool::get()), _lift(), _gamma(), _gain(), _offset(), _tint_detection(), _tint_luma(), _tint_exponent(), _tint_low(), _tint_mid(), _tint_hig(), _correction(), _lut_enabled(true), _lut_depth(), _ccache_rt(), _ccache_texture(), _ccache_fresh(false), _lut_initialized(false), _lut_dirty(true), _lut_producer(), _lut_consumer(), _lut_rt(), _lut_texture(), _cache_rt(), _cache_texture(), _cache_fresh(false)
 {
 	{
 		auto gctx = streamfx::obs::gs::context();
@@ -123,6 +140,7 @@ color_grade_instance::color_grade_instance(obs_data_t* data, obs_source_t* self)
 			auto file = streamfx::data_file_path("effects/color-grade.effect");
 			try {
 				_effect = streamfx::obs::gs::effect::create(file);
+				_effect_params.bind(_effect, effect_param_names);
 			} catch (std::exception& ex) {
 				D_LOG_ERROR("Error loading '%s': %s", file.u8string().c_str(), ex.what());
 				throw;
@@ -138,24 +156,11 @@ color_grade_instance::color_grade_instance(obs_data_t* data, obs_source_t* self)
 			D_LOG_WARNING("Failed to initialize LUT rendering, falling back to direct rendering.\n%s", ex.what());
 			_lut_initialized = false;
 		}
-
-		// Allocate render target for rendering.
-		try {
-			allocate_rendertarget(GS_RGBA);
-		} catch (std::exception const& ex) {
-			D_LOG_ERROR("Failed to acquire render target for rendering: %s", ex.what());
-			throw;
-		}
 	}
 
 	update(data);
 }
 
-void color_grade_instance::allocate_rendertarget(gs_color_format format)
-{
-	_cache_rt = std::make_unique<streamfx::obs::gs::rendertarget>(format, GS_ZS_NONE);
-}
-
 float fix_gamma_value(double_t v)
 {
 	if (v < 0.0) {
@@ -226,52 +231,48 @@ void color_grade_instance::update(obs_data_t* data)
 
 void color_grade_instance::prepare_effect()
 {
-	if (auto p = _effect.get_parameter("pLift"); p) {
-		p.set_float4(_lift);
+	if (_effect_params.has(effect_param::Lift)) {
+		_effect_params[effect_param::Lift].set_float4(_lift);
 	}
 
-	if (auto p = _effect.get_parameter("pGamma"); p) {
-		p.set_float4(_gamma);
+	if (_effect_params.has(effect_param::Gamma)) {
+		_effect_params[effect_param::Gamma].set_float4(_gamma);
 	}
 
-	if (auto p = _effect.get_parameter("pGain"); p) {
-		p.set_float4(_gain);
+	if (_effect_params.has(effect_param::Gain)) {
+		_effect_params[effect_param::Gain].set_float4(_gain);
 	}
 
-	if (auto p = _effect.get_parameter("pOffset"); p) {
-		p.set_float4(_offset);
+	if (_effect_params.has(effect_param::Offset)) {
+		_effect_params[effect_param::Offset].set_float4(_offset);
 	}
 
-	if (auto p = _effect.get_parameter("pLift"); p) {
-		p.set_float4(_lift);
+	if (_effect_params.has(effect_param::TintDetection)) {
+		_effect_params[effect_param::TintDetection].set_int(static_cast<int32_t>(_tint_detection));
 	}
 
-	if (auto p = _effect.get_parameter("pTintDetection"); p) {
-		p.set_int(static_cast<int32_t>(_tint_detection));
+	if (_effect_params.has(effect_param::TintMode)) {
+		_effect_params[effect_param::TintMode].set_int(static_cast<int32_t>(_tint_luma));
 	}
 
-	if (auto p = _effect.get_parameter("pTintMode"); p) {
-		p.set_int(static_cast<int32_t>(_tint_luma));
+	if (_effect_params.has(effect_param::TintExponent)) {
+		_effect_params[effect_param::TintExponent].set_float(_tint_exponent);
 	}
 
-	if (auto p = _effect.get_parameter("pTintExponent"); p) {
-		p.set_float(_tint_exponent);
+	if (_effect_params.has(effect_param::TintLow)) {
+		_effect_params[effect_param::TintLow].set_float3(_tint_low);
 	}
 
-	if (auto p = _effect.get_parameter("pTintLow"); p) {
-		p.set_float3(_tint_low);
+	if (_effect_params.has(effect_param::TintMid)) {
+		_effect_params[effect_param::TintMid].set_float3(_tint_mid);
 	}
 
-	if (auto p = _effect.get_parameter("pTintMid"); p) {
-		p.set_float3(_tint_mid);
+	if (_effect_params.has(effect_param::TintHig)) {
+		_effect_params[effect_param::TintHig].set_float3(_tint_hig);
 	}
 
-	if (auto p = _effect.get_parameter("pTintHig"); p) {
-		p.set_float3(_tint_hig);
-	}
-
-	if (auto p = _effect.get_parameter("pCorrection"); p) {
-		p.set_float4(_correction);
+	if (_effect_params.has(effect_param::Correction)) {
+		_effect_params[effect_param::Correction].set_float4(_correction);
 	}
 }
 
@@ -296,8 +297,8 @@ void color_grade_instance::rebuild_lut()
 		prepare_effect();
 
 		// Assign texture.
-		if (auto p = _effect.get_parameter("image"); p) {
-			p.set_texture(lut_texture);
+		if (_effect_params.has(effect_param::Image)) {
+			_effect_params[effect_param::Image].set_texture(lut_texture);
 		}
 
 		{ // Begin rendering.
@@ -333,6 +334,10 @@ void color_grade_instance::video_tick(float)
 {
 	_ccache_fresh = false;
 	_cache_fresh  = false;
+
+	// Give the borrowed render targets back, they are borrowed again on the next render.
+	_ccache_rt.reset();
+	_cache_rt.reset();
 }
 
 void color_grade_instance::video_render(gs_effect_t* shader)
@@ -363,9 +368,9 @@ void color_grade_instance::video_render(gs_effect_t* shader)
 #if defined(ENABLE_PROFILING) && !defined(D_PLATFORM_MAC) && _DEBUG
 		streamfx::obs::gs::debug_marker gdmp{streamfx::obs::gs::debug_color_cache, "Cache '%s'", obs_source_get_name(target)};
 #endif
-		// If the input cache render target doesn't exist, create it.
+		// Borrow the input cache render target for the rest of the frame.
 		if (!_ccache_rt) {
-			_ccache_rt = std::make_shared<streamfx::obs::gs::rendertarget>(GS_RGBA, GS_ZS_NONE);
+			_ccache_rt = _rt_pool->acquire(GS_RGBA, width, height);
 		}
 
 		{
@@ -426,9 +431,9 @@ void color_grade_instance::video_render(gs_effect_t* shader)
 				_cache_fresh = false;
 			}
 
-			// Reallocate the rendertarget if necessary.
-			if (_cache_rt->get_color_format() != GS_RGBA) {
-				allocate_rendertarget(GS_RGBA);
+			// Borrow the render cache render target for the rest of the frame.
+			if (!_cache_rt) {
+				_cache_rt = _rt_pool->acquire(GS_RGBA, width, height);
 			}
 
 			if (!_cache_fresh) {
@@ -456,8 +461,7 @@ void color_grade_instance::video_render(gs_effect_t* shader)
 					// Disable culling.
 					gs_set_cull_mode(GS_NEITHER);
 
-					auto effect = _lut_consumer->prepare(_lut_depth, _lut_texture);
-					effect->get_parameter("image").set_texture(_ccache_texture);
+					auto effect = _lut_consumer->prepare(_lut_depth, _lut_texture, _ccache_texture);
 					while (gs_effect_loop(effect->get_object(), "Draw")) {
 						_gfx_util->draw_fullscreen_triangle();
 					}
@@ -484,9 +488,9 @@ void color_grade_instance::video_render(gs_effect_t* shader)
 #if defined(ENABLE_PROFILING) && !defined(D_PLATFORM_MAC) && _DEBUG
 		streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_convert, "Direct Rendering"};
 #endif
-		// Reallocate the rendertarget if necessary.
-		if (_cache_rt->get_color_format() != GS_RGBA) {
-			allocate_rendertarget(GS_RGBA);
+		// Borrow the render cache render target for the rest of the frame.
+		if (!_cache_rt) {
+			_cache_rt = _rt_pool->acquire(GS_RGBA, width, height);
 		}
 
 		{ // Render the source to the cache.
@@ -516,7 +520,7 @@ void color_grade_instance::video_render(gs_effect_t* shader)
 			gs_set_cull_mode(GS_NEITHER);
 
 			// Render the effect.
-			_effect.get_parameter("image").set_texture(_ccache_texture);
+			_effect_params[effect_param::Image].set_texture(_ccache_texture);
 			while (gs_effect_loop(_effect.get_object(), "Draw")) {
 				_gfx_util->draw_fullscreen_triangle();
 			}
@@ -845,6 +849,7 @@ std::shared_ptr<color_grade_factory> streamfx::filter::color_grade::color_grade_
 static std::shared_ptr<color_grade_factory> loader_instance;
 
 static auto loader = streamfx::loader(
+	"filter-color-grade",
 	[]() { // Initalizer
 		loader_instance = color_grade_factory::instance();
 	},
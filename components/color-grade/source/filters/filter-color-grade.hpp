@@ -4,6 +4,7 @@
 
 #pragma once
 #include "gfx/gfx-mipmapper.hpp"
+#include "gfx/gfx-rendertarget-pool.hpp"
 #include "gfx/lut/gfx-lut-consumer.hpp"
 #include "gfx/lut/gfx-lut-producer.hpp"
 #include "gfx/lut/gfx-lut.hpp"
@@ -33,8 +34,10 @@ namespace streamfx::filter::color_grade {
 	};
 
 	class color_grade_instance : public obs::source_instance {
-		streamfx::obs::gs::effect            _effect;
-		std::shared_ptr<streamfx::gfx::util> _gfx_util;
+		streamfx::obs::gs::effect                         _effect;
+		streamfx::obs::gs::effect_bindings<12>            _effect_params;
+		std::shared_ptr<streamfx::gfx::util>              _gfx_util;
+		std::shared_ptr<streamfx::gfx::rendertarget_pool> _rt_pool;
 
 		// User Configuration
 		vec4                            _lift;
@@ -73,8 +76,6 @@ namespace streamfx::filter::color_grade {
 		color_grade_instance(obs_data_t* data, obs_source_t* self);
 		virtual ~color_grade_instance();
 
-		void allocate_rendertarget(gs_color_format format);
-
 		virtual void load(obs_data_t* data) override;
 		virtual void migrate(obs_data_t* data, uint64_t version) override;
 		virtual void update(obs_data_t* data) override;
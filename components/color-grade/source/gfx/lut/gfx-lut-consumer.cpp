@@ -6,11 +6,20 @@
 #include "gfx-lut-consumer.hpp"
 #include "obs/gs/gs-helper.hpp"
 
+enum class lut_param : std::size_t {
+	LUTParams0,
+	LUTParams1,
+	LUT,
+	Image,
+};
+static constexpr std::array<const char*, 4> param_names = {"lut_params_0", "lut_params_1", "lut", "image"};
+
 streamfx::gfx::lut::consumer::consumer()
 {
 	_data = streamfx::gfx::lut::data::instance();
 	if (!_data->consumer_effect())
 		throw std::runtime_error("Unable to get LUT consumer effect.");
+	_params.bind(*_data->consumer_effect(), param_names);
 }
 
 streamfx::gfx::lut::consumer::~consumer() = default;
@@ -26,35 +35,42 @@ std::shared_ptr<streamfx::obs::gs::effect> streamfx::gfx::lut::consumer::prepare
 	int32_t grid_size      = static_cast<int32_t>(pow(2l, (idepth / 2)));
 	int32_t container_size = static_cast<int32_t>(pow(2l, (idepth + (idepth / 2))));
 
-	if (streamfx::obs::gs::effect_parameter efp = effect->get_parameter("lut_params_0"); efp) {
-		efp.set_int4(size, grid_size, container_size, 0l);
+	if (_params.has(lut_param::LUTParams0)) {
+		_params[lut_param::LUTParams0].set_int4(size, grid_size, container_size, 0l);
 	}
 
-	if (streamfx::obs::gs::effect_parameter efp = effect->get_parameter("lut_params_1"); efp) {
+	if (_params.has(lut_param::LUTParams1)) {
 		float inverse_size           = 1.f / static_cast<float>(size);
 		float inverse_z_size         = 1.f / static_cast<float>(grid_size);
 		float inverse_container_size = 1.f / static_cast<float>(container_size);
 		float half_texel             = inverse_container_size / 2.f;
-		efp.set_float4(inverse_size, inverse_z_size, inverse_container_size, half_texel);
+		_params[lut_param::LUTParams1].set_float4(inverse_size, inverse_z_size, inverse_container_size, half_texel);
 	}
 
-	if (streamfx::obs::gs::effect_parameter efp = effect->get_parameter("lut"); efp) {
-		efp.set_texture(lut);
+	if (_params.has(lut_param::LUT)) {
+		_params[lut_param::LUT].set_texture(lut);
 	}
 
 	return effect;
 }
 
-void streamfx::gfx::lut::consumer::consume(streamfx::gfx::lut::color_depth depth, std::shared_ptr<streamfx::obs::gs::texture> lut, std::shared_ptr<streamfx::obs::gs::texture> texture)
+std::shared_ptr<streamfx::obs::gs::effect> streamfx::gfx::lut::consumer::prepare(streamfx::gfx::lut::color_depth depth, std::shared_ptr<streamfx::obs::gs::texture> lut, std::shared_ptr<streamfx::obs::gs::texture> image)
 {
-	auto gctx = streamfx::obs::gs::context();
-
 	auto effect = prepare(depth, lut);
 
-	if (streamfx::obs::gs::effect_parameter efp = effect->get_parameter("image"); efp) {
-		efp.set_texture(texture->get_object());
+	if (_params.has(lut_param::Image)) {
+		_params[lut_param::Image].set_texture(image);
 	}
 
+	return effect;
+}
+
+void streamfx::gfx::lut::consumer::consume(streamfx::gfx::lut::color_depth depth, std::shared_ptr<streamfx::obs::gs::texture> lut, std::shared_ptr<streamfx::obs::gs::texture> texture)
+{
+	auto gctx = streamfx::obs::gs::context();
+
+	auto effect = prepare(depth, lut, texture);
+
 	// Draw a simple quad.
 	while (gs_effect_loop(effect->get_object(), "Draw")) {
 		gs_draw_sprite(nullptr, 0, 1, 1);
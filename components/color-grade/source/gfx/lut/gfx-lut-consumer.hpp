@@ -14,6 +14,7 @@
 namespace streamfx::gfx::lut {
 	class consumer {
 		std::shared_ptr<streamfx::gfx::lut::data> _data;
+		streamfx::obs::gs::effect_bindings<4>     _params;
 
 		public:
 		consumer();
@@ -21,6 +22,8 @@ namespace streamfx::gfx::lut {
 
 		std::shared_ptr<streamfx::obs::gs::effect> prepare(streamfx::gfx::lut::color_depth depth, std::shared_ptr<streamfx::obs::gs::texture> lut);
 
+		std::shared_ptr<streamfx::obs::gs::effect> prepare(streamfx::gfx::lut::color_depth depth, std::shared_ptr<streamfx::obs::gs::texture> lut, std::shared_ptr<streamfx::obs::gs::texture> image);
+
 		void consume(streamfx::gfx::lut::color_depth depth, std::shared_ptr<streamfx::obs::gs::texture> lut, std::shared_ptr<streamfx::obs::gs::texture> texture);
 	};
 } // namespace streamfx::gfx::lut
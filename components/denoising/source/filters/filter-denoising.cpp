@@ -385,7 +385,7 @@ void streamfx::filter::denoising::denoising_instance::switch_provider(denoising_
 	_provider     = provider;
 
 	// Then spawn a new task to switch provider.
-	_provider_task = streamfx::threadpool()->push(std::bind(&denoising_instance::task_switch_provider, this, std::placeholders::_1), spd);
+	_provider_task = streamfx::threadpool()->push(std::bind(&denoising_instance::task_switch_provider, this, std::placeholders::_1), spd, streamfx::util::threadpool::priority::BACKGROUND);
 }
 
 void streamfx::filter::denoising::denoising_instance::task_switch_provider(util::threadpool::task_data_t data)
@@ -634,10 +634,11 @@ std::shared_ptr<denoising_factory> denoising_factory::instance()
 static std::shared_ptr<denoising_factory> loader_instance;
 
 static auto loader = streamfx::loader(
+	"filter-denoising",
 	[]() { // Initalizer
 		loader_instance = denoising_factory::instance();
 	},
 	[]() { // Finalizer
 		loader_instance.reset();
 	},
-	streamfx::loader_priority::NORMAL);
+	streamfx::loader_priority::NORMAL, streamfx::loader_flags::NONE, {"nvidia-cuda"});
@@ -98,6 +98,7 @@ dynamic_mask_instance::dynamic_mask_instance(obs_data_t* settings, obs_source_t*
 	: obs::source_instance(settings, self), //
 	  _data(streamfx::filter::dynamic_mask::data::get()), //
 	  _gfx_util(::streamfx::gfx::util::get()), //
+	  _rt_pool(::streamfx::gfx::rendertarget_pool::get()), //
 	  _translation_map(), //
 	  _input(), //
 	  _input_child(), //
@@ -232,6 +233,7 @@ void dynamic_mask_instance::video_tick(float time)
 {
 	{ // Base Information
 		_have_base = false;
+		_base_rt.reset();
 
 		std::array<gs_color_space, 1> preferred_formats = {GS_CS_SRGB};
 		_base_color_space                               = obs_source_get_color_space(obs_filter_get_target(_self), preferred_formats.size(), preferred_formats.data());
@@ -255,9 +257,9 @@ void dynamic_mask_instance::video_tick(float time)
 		}
 	}
 
+	_have_input = false;
+	_input_rt.reset();
 	if (auto input = _input.lock(); input) { // Input Information
-		_have_input = false;
-
 		std::array<gs_color_space, 1> preferred_formats = {GS_CS_SRGB};
 		_input_color_space                              = obs_source_get_color_space(input, preferred_formats.size(), preferred_formats.data());
 		switch (_input_color_space) {
@@ -278,11 +280,10 @@ void dynamic_mask_instance::video_tick(float time)
 		} else {
 			_input_srgb = false;
 		}
-	} else {
-		_have_input = false;
 	}
 
 	_have_final = false;
+	_final_rt.reset();
 	_final_srgb = _base_srgb;
 }
 
@@ -314,10 +315,8 @@ void dynamic_mask_instance::video_render(gs_effect_t* in_effect)
 #if defined(ENABLE_PROFILING) && !defined(D_PLATFORM_MAC) && _DEBUG
 		streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_cache, "Base Texture"};
 #endif
-		// Ensure the Render Target matches the expected format.
-		if (!_base_rt || (_base_rt->get_color_format() != _base_color_format)) {
-			_base_rt = std::make_shared<streamfx::obs::gs::rendertarget>(_base_color_format, GS_ZS_NONE);
-		}
+		// Borrow a Render Target for the rest of the frame.
+		_base_rt = _rt_pool->acquire(_base_color_format, width, height);
 
 		bool previous_srgb  = gs_framebuffer_srgb_enabled();
 		auto previous_lsrgb = gs_get_linear_srgb();
@@ -399,10 +398,8 @@ void dynamic_mask_instance::video_render(gs_effect_t* in_effect)
 #if defined(ENABLE_PROFILING) && !defined(D_PLATFORM_MAC) && _DEBUG
 			streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_source, "Input '%s'", input.name().data()};
 #endif
-			// Ensure the Render Target matches the expected format.
-			if (!_input_rt || (_input_rt->get_color_format() != _input_color_format)) {
-				_input_rt = std::make_shared<streamfx::obs::gs::rendertarget>(_input_color_format, GS_ZS_NONE);
-			}
+			// Borrow a Render Target for the rest of the frame.
+			_input_rt = _rt_pool->acquire(_input_color_format, input.width(), input.height());
 
 			auto previous_lsrgb = gs_get_linear_srgb();
 			gs_set_linear_srgb(_input_srgb);
@@ -473,10 +470,8 @@ void dynamic_mask_instance::video_render(gs_effect_t* in_effect)
 		streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_render, "Final Calculation"};
 #endif
 
-		// Ensure the Render Target matches the expected format.
-		if (!_final_rt || (_final_rt->get_color_format() != _base_color_format)) {
-			_final_rt = std::make_shared<streamfx::obs::gs::rendertarget>(_base_color_format, GS_ZS_NONE);
-		}
+		// Borrow a Render Target for the rest of the frame.
+		_final_rt = _rt_pool->acquire(_base_color_format, width, height);
 
 		bool previous_srgb  = gs_framebuffer_srgb_enabled();
 		auto previous_lsrgb = gs_get_linear_srgb();
@@ -835,6 +830,7 @@ std::shared_ptr<dynamic_mask_factory> dynamic_mask_factory::instance()
 static std::shared_ptr<dynamic_mask_factory> loader_instance;
 
 static auto loader = streamfx::loader(
+	"filter-dynamic-mask",
 	[]() { // Initalizer
 		loader_instance = dynamic_mask_factory::instance();
 	},
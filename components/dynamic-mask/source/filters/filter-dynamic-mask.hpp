@@ -4,6 +4,7 @@
 
 #pragma once
 #include "common.hpp"
+#include "gfx/gfx-rendertarget-pool.hpp"
 #include "gfx/gfx-source-texture.hpp"
 #include "gfx/gfx-util.hpp"
 #include "obs/gs/gs-effect.hpp"
@@ -41,6 +42,7 @@ namespace streamfx::filter::dynamic_mask {
 	class dynamic_mask_instance : public obs::source_instance {
 		std::shared_ptr<streamfx::filter::dynamic_mask::data> _data;
 		std::shared_ptr<streamfx::gfx::util>                  _gfx_util;
+		std::shared_ptr<streamfx::gfx::rendertarget_pool>     _rt_pool;
 
 		std::map<std::tuple<channel, channel, std::string>, std::string> _translation_map;
 
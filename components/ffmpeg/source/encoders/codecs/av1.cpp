@@ -17,3 +17,11 @@ const char* streamfx::encoder::codec::av1::profile_to_string(profile p)
 		return "Unknown";
 	}
 }
+
+::streamfx::ffmpeg::parameter_set_cache::unit_type streamfx::encoder::codec::av1::classify(const ::streamfx::ffmpeg::bitstream::unit& obu)
+{
+	if ((obu.size < 1) || (static_cast<obu_type>((obu.data[0] >> 3) & 0xF) != obu_type::SEQUENCE_HEADER)) {
+		return ::streamfx::ffmpeg::parameter_set_cache::unit_type::OTHER;
+	}
+	return ::streamfx::ffmpeg::parameter_set_cache::unit_type::HEADER;
+}
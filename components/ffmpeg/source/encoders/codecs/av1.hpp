@@ -4,6 +4,7 @@
 
 #pragma once
 #include "common.hpp"
+#include "ffmpeg/parameter-set-cache.hpp"
 
 #define S_CODEC_AV1 "Codec.AV1"
 #define S_CODEC_AV1_PROFILE "Codec.AV1.Profile"
@@ -16,5 +17,22 @@ namespace streamfx::encoder::codec::av1 {
 		UNKNOWN      = -1,
 	};
 
+	// See AV1 Bitstream & Decoding Process Specification, 6.2.2 OBU header semantics.
+	enum class obu_type : uint8_t {
+		SEQUENCE_HEADER        = 1,
+		TEMPORAL_DELIMITER     = 2,
+		FRAME_HEADER           = 3,
+		TILE_GROUP             = 4,
+		METADATA               = 5,
+		FRAME                  = 6,
+		REDUNDANT_FRAME_HEADER = 7,
+		TILE_LIST              = 8,
+		PADDING                = 15,
+	};
+
 	const char* profile_to_string(profile p);
+
+	/** Sort an OBU into Sequence Header or anything else.
+	 */
+	::streamfx::ffmpeg::parameter_set_cache::unit_type classify(const ::streamfx::ffmpeg::bitstream::unit& obu);
 } // namespace streamfx::encoder::codec::av1
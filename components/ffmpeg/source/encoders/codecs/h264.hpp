@@ -4,6 +4,7 @@
 
 #pragma once
 #include "common.hpp"
+#include "ffmpeg/parameter-set-cache.hpp"
 
 // Codec: H264
 #define S_CODEC_H264 "Codec.H264"
@@ -68,15 +69,8 @@ namespace streamfx::encoder::codec::h264 {
 		CODED_SLICE_EXTENSION_DEPTH_VIEW     = 21,
 	};
 
-	/** Search for the closest NAL unit.
-	 *
-	 * \param ptr Beginning of the search range.
-	 * \param endptr End of the search range (exclusive).
-	 * 
-	 * \return A valid pointer if a NAL was found, otherwise \ref nullptr.
+	/** Sort a NAL unit into SPS/PPS headers, SEI, or anything else.
 	 */
-	uint8_t* find_closest_nal(uint8_t* ptr, uint8_t* endptr, size_t& size);
-
-	uint32_t get_packet_reference_count(uint8_t* ptr, uint8_t* endptr);
+	::streamfx::ffmpeg::parameter_set_cache::unit_type classify(const ::streamfx::ffmpeg::bitstream::unit& nal);
 
 } // namespace streamfx::encoder::codec::h264
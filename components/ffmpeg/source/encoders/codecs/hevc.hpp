@@ -4,6 +4,7 @@
 
 #pragma once
 #include "common.hpp"
+#include "ffmpeg/parameter-set-cache.hpp"
 
 // Codec: HEVC
 #define S_CODEC_HEVC "Codec.HEVC"
@@ -42,5 +43,7 @@ namespace streamfx::encoder::codec::hevc {
 		UNKNOWN = -1,
 	};
 
-	void extract_header_sei(uint8_t* data, std::size_t sz_data, std::vector<uint8_t>& header, std::vector<uint8_t>& sei);
+	/** Sort a NAL unit into VPS/SPS/PPS headers, SEI, or anything else.
+	 */
+	::streamfx::ffmpeg::parameter_set_cache::unit_type classify(const ::streamfx::ffmpeg::bitstream::unit& nal);
 } // namespace streamfx::encoder::codec::hevc
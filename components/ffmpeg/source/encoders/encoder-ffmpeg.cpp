@@ -8,6 +8,7 @@
 
 #include "encoder-ffmpeg.hpp"
 #include "strings.hpp"
+#include "codecs/av1.hpp"
 #include "codecs/hevc.hpp"
 #include "ffmpeg/tools.hpp"
 #include "obs/gs/gs-helper.hpp"
@@ -46,6 +47,9 @@ extern "C" {
 #define ST_KEY_FFMPEG_FRAMERATE "FFmpeg.Framerate"
 #define ST_I18N_FFMPEG_GPU ST_I18N_FFMPEG ".GPU"
 #define ST_KEY_FFMPEG_GPU "FFmpeg.GPU"
+#define ST_I18N_FFMPEG_SCALER ST_I18N_FFMPEG ".Scaler"
+#define ST_I18N_FFMPEG_SCALER_(x) ST_I18N_FFMPEG_SCALER "." x
+#define ST_KEY_FFMPEG_SCALER "FFmpeg.Scaler"
 
 #define ST_I18N_KEYFRAMES ST_I18N_FFMPEG ".KeyFrames"
 #define ST_I18N_KEYFRAMES_INTERVALTYPE ST_I18N_KEYFRAMES ".IntervalType"
@@ -60,6 +64,9 @@ using namespace streamfx::encoder::codec;
 
 enum class keyframe_type { SECONDS, FRAMES };
 
+// Number of frames that may wait for the encode thread before encode() has to wait for it to catch up.
+static constexpr std::size_t input_queue_size = 8;
+
 ffmpeg_instance::ffmpeg_instance(obs_data_t* settings, obs_encoder_t* self, bool is_hw)
 	: encoder_instance(settings, self, is_hw),
 
@@ -71,9 +78,13 @@ ffmpeg_instance::ffmpeg_instance(obs_data_t* settings, obs_encoder_t* self, bool
 
 	  _hwapi(), _hwinst(),
 
-	  _lag_in_frames(0), _sent_frames(0), _have_first_frame(false), _extra_data(), _sei_data(),
+	  _have_first_frame(false), _parameter_sets(), _parameter_sets_generation(0),
+
+	  _frame_pool(),
 
-	  _free_frames(), _used_frames(), _free_frames_last_used()
+	  _encode_thread(), _context_lock(), _encode_stop(false), _encode_failed(false), _input_lock(), _input_cv(), _input_space_cv(), _input_frames(), _input_busy(false), _output_lock(), _output_packets(), _free_packets(),
+
+	  _latency(::streamfx::util::profiler::create()), _convert_time(::streamfx::util::profiler::create()), _latency_start(), _input_depth_max(0), _output_depth_max(0)
 {
 	// Initialize GPU Stuff
 	if (is_hw) {
@@ -125,16 +136,38 @@ ffmpeg_instance::ffmpeg_instance(obs_data_t* settings, obs_encoder_t* self, bool
 	update(settings);
 
 	// Initialize Encoder
-	auto gctx = streamfx::obs::gs::context();
-	int  res  = avcodec_open2(_context, _codec, NULL);
-	if (res < 0) {
-		throw std::runtime_error(::streamfx::ffmpeg::tools::get_error_description(res));
+	{
+		::streamfx::ffmpeg::hwapi::graphics_lock<streamfx::obs::gs::context> gctx(_hwinst);
+		int res = avcodec_open2(_context, _codec, NULL);
+		if (res < 0) {
+			throw std::runtime_error(::streamfx::ffmpeg::tools::get_error_description(res));
+		}
 	}
+
+	// Start the encode thread, which does all the sending and receiving from here on.
+	_encode_thread = std::thread(std::bind(&ffmpeg_instance::encode_thread, this));
 }
 
 ffmpeg_instance::~ffmpeg_instance()
 {
-	auto gctx = streamfx::obs::gs::context();
+	// Stop the encode thread, it finishes whatever is still queued first.
+	{
+		std::lock_guard<std::mutex> lg(_input_lock);
+		_encode_stop = true;
+		_input_cv.notify_all();
+	}
+	if (_encode_thread.joinable()) {
+		_encode_thread.join();
+	}
+
+	if (_latency->count() > 0) {
+		DLOG_INFO("[%s] Encoded %" PRIu64 " frames with %.2f ms average, %.2f ms 99th percentile latency, and a maximum queue depth of %zu frames and %zu packets.", _codec->name, _latency->count(), _latency->average_duration() / 1000000.0, static_cast<double_t>(_latency->percentile(0.99).count()) / 1000000.0, _input_depth_max, _output_depth_max);
+	}
+	if (_convert_time->count() > 0) {
+		DLOG_INFO("[%s] Converted %" PRIu64 " frames from '%s' to '%s' at %" PRIu32 "x%" PRIu32 " in %zu slices with %.2f ms average, %.2f ms 99th percentile.", _codec->name, _convert_time->count(), ::streamfx::ffmpeg::tools::get_pixel_format_name(_scaler.get_source_format()), ::streamfx::ffmpeg::tools::get_pixel_format_name(_scaler.get_target_format()), _scaler.get_target_width(), _scaler.get_target_height(), _scaler.get_slice_count(), _convert_time->average_duration() / 1000000.0, static_cast<double_t>(_convert_time->percentile(0.99).count()) / 1000000.0);
+	}
+
+	::streamfx::ffmpeg::hwapi::graphics_lock<streamfx::obs::gs::context> gctx(_hwinst);
 	if (_context) {
 		// Flush encoders that require it.
 		if ((_codec->capabilities & AV_CODEC_CAP_DELAY) != 0) {
@@ -165,6 +198,7 @@ void ffmpeg_instance::get_properties(obs_properties_t* props)
 
 	obs_property_set_enabled(obs_properties_get(props, ST_KEY_FFMPEG_THREADS), false);
 	obs_property_set_enabled(obs_properties_get(props, ST_KEY_FFMPEG_GPU), false);
+	obs_property_set_enabled(obs_properties_get(props, ST_KEY_FFMPEG_SCALER), false);
 }
 
 void ffmpeg_instance::migrate(obs_data_t* settings, uint64_t version)
@@ -175,6 +209,9 @@ void ffmpeg_instance::migrate(obs_data_t* settings, uint64_t version)
 
 bool ffmpeg_instance::update(obs_data_t* settings)
 {
+	// The encode thread may be using the context right now.
+	std::lock_guard<std::mutex> lg(_context_lock);
+
 	bool support_reconfig           = false;
 	bool support_reconfig_threads   = false;
 	bool support_reconfig_gpu       = false;
@@ -277,6 +314,7 @@ bool ffmpeg_instance::update(obs_data_t* settings)
 		} else {
 			DLOG_INFO("[%s]     Input: %" PRId32 "x%" PRId32 " %s %s %s", _codec->name, _scaler.get_source_width(), _scaler.get_source_height(), ::streamfx::ffmpeg::tools::get_pixel_format_name(_scaler.get_source_format()), ::streamfx::ffmpeg::tools::get_color_space_name(_scaler.get_source_colorspace()), _scaler.is_source_full_range() ? "Full" : "Partial");
 			DLOG_INFO("[%s]     Output: %" PRId32 "x%" PRId32 " %s %s %s", _codec->name, _scaler.get_target_width(), _scaler.get_target_height(), ::streamfx::ffmpeg::tools::get_pixel_format_name(_scaler.get_target_format()), ::streamfx::ffmpeg::tools::get_color_space_name(_scaler.get_target_colorspace()), _scaler.is_target_full_range() ? "Full" : "Partial");
+			DLOG_INFO("[%s]     Conversion: %zu slices", _codec->name, _scaler.get_slice_count());
 			if (!_hwinst)
 				DLOG_INFO("[%s]     On GPU Index: %lli", _codec->name, obs_data_get_int(settings, ST_KEY_FFMPEG_GPU));
 		}
@@ -339,33 +377,28 @@ bool ffmpeg_instance::encode_video(struct encoder_frame* frame, struct encoder_p
 		return true;
 	}
 
-	std::shared_ptr<AVFrame> vframe = pop_free_frame(); // Retrieve an empty frame.
-
-	// Convert frame.
-	{
-		vframe->height          = _context->height;
-		vframe->format          = _context->pix_fmt;
-		vframe->color_range     = _context->color_range;
-		vframe->colorspace      = _context->colorspace;
-		vframe->color_primaries = _context->color_primaries;
-		vframe->color_trc       = _context->color_trc;
-		vframe->pts             = frame->pts;
-
-		if ((_scaler.is_source_full_range() == _scaler.is_target_full_range()) && (_scaler.get_source_colorspace() == _scaler.get_target_colorspace()) && (_scaler.get_source_format() == _scaler.get_target_format())) {
-			copy_data(frame, vframe.get());
-		} else {
-			int res = _scaler.convert(reinterpret_cast<uint8_t**>(frame->data), reinterpret_cast<int*>(frame->linesize), 0, _context->height, vframe->data, vframe->linesize);
-			if (res <= 0) {
-				DLOG_ERROR("Failed to convert frame: %s (%" PRId32 ").", ::streamfx::ffmpeg::tools::get_error_description(res), res);
-				return false;
-			}
+	// OBS reuses the planes as soon as we return, and encoders may hold onto their input for a while, so always copy
+	// or convert into a pooled frame.
+	std::shared_ptr<AVFrame> vframe = pop_free_frame();
+	if ((_scaler.is_source_full_range() == _scaler.is_target_full_range()) && (_scaler.get_source_colorspace() == _scaler.get_target_colorspace()) && (_scaler.get_source_format() == _scaler.get_target_format())) {
+		copy_data(frame, vframe.get());
+	} else {
+		auto start = std::chrono::high_resolution_clock::now();
+		int  res   = _scaler.convert(reinterpret_cast<uint8_t**>(frame->data), reinterpret_cast<int*>(frame->linesize), 0, _context->height, vframe->data, vframe->linesize);
+		_convert_time->track(std::chrono::high_resolution_clock::now() - start);
+		if (res <= 0) {
+			DLOG_ERROR("Failed to convert frame: %s (%" PRId32 ").", ::streamfx::ffmpeg::tools::get_error_description(res), res);
+			return false;
 		}
 	}
 
-	if (!encode_avframe(vframe, packet, received_packet))
-		return false;
+	vframe->color_range     = _context->color_range;
+	vframe->colorspace      = _context->colorspace;
+	vframe->color_primaries = _context->color_primaries;
+	vframe->color_trc       = _context->color_trc;
+	vframe->pts             = frame->pts;
 
-	return true;
+	return encode_avframe(vframe, packet, received_packet);
 }
 
 bool ffmpeg_instance::encode_video(uint32_t handle, int64_t pts, uint64_t lock_key, uint64_t* next_key, struct encoder_packet* packet, bool* received_packet)
@@ -438,11 +471,15 @@ void ffmpeg_instance::initialize_sw(obs_data_t* settings)
 	_scaler.set_target_format(pix_fmt_target);
 
 	// Create Scaler
-	if (!_scaler.initialize(SWS_SINC | SWS_FULL_CHR_H_INT | SWS_FULL_CHR_H_INP | SWS_ACCURATE_RND | SWS_BITEXACT)) {
+	auto quality = static_cast<::streamfx::ffmpeg::swscale_quality>(obs_data_get_int(settings, ST_KEY_FFMPEG_SCALER));
+	if (!_scaler.initialize(::streamfx::ffmpeg::swscale::get_flags(quality), 0)) {
 		std::stringstream sstr;
 		sstr << "Initializing scaler failed for conversion from '" << ::streamfx::ffmpeg::tools::get_pixel_format_name(_scaler.get_source_format()) << "' to '" << ::streamfx::ffmpeg::tools::get_pixel_format_name(_scaler.get_target_format()) << "' with color space '" << ::streamfx::ffmpeg::tools::get_color_space_name(_scaler.get_source_colorspace()) << "' and " << (_scaler.is_source_full_range() ? "full" : "partial") << " range.";
 		throw std::runtime_error(sstr.str());
 	}
+
+	// Frames are shared with every other encoder using the same size and format.
+	_frame_pool = ::streamfx::ffmpeg::avframe_pool::instance(_context->width, _context->height, _context->pix_fmt);
 }
 
 void ffmpeg_instance::initialize_hw(obs_data_t*)
@@ -480,59 +517,14 @@ void ffmpeg_instance::initialize_hw(obs_data_t*)
 #endif
 }
 
-void ffmpeg_instance::push_free_frame(std::shared_ptr<AVFrame> frame)
-{
-	auto now = std::chrono::high_resolution_clock::now();
-	if (_free_frames.size() > 0) {
-		if ((now - _free_frames_last_used) < std::chrono::seconds(1)) {
-			_free_frames.push(frame);
-		}
-	} else {
-		_free_frames.push(frame);
-		_free_frames_last_used = std::chrono::high_resolution_clock::now();
-	}
-}
-
 std::shared_ptr<AVFrame> ffmpeg_instance::pop_free_frame()
 {
-	std::shared_ptr<AVFrame> frame;
-	if (_free_frames.size() > 0) {
-		// Re-use existing frames first.
-		frame = _free_frames.top();
-		_free_frames.pop();
+	if (_hwinst) {
+		// Surfaces are pooled by the hardware frames context itself.
+		return _hwinst->allocate_frame(_context->hw_frames_ctx);
 	} else {
-		if (_hwinst) {
-			frame = _hwinst->allocate_frame(_context->hw_frames_ctx);
-		} else {
-			frame = std::shared_ptr<AVFrame>(av_frame_alloc(), [](AVFrame* frame) {
-				av_frame_unref(frame);
-				av_frame_free(&frame);
-			});
-
-			frame->width  = _context->width;
-			frame->height = _context->height;
-			frame->format = _context->pix_fmt;
-
-			int res = av_frame_get_buffer(frame.get(), 32);
-			if (res < 0) {
-				throw std::runtime_error(::streamfx::ffmpeg::tools::get_error_description(res));
-			}
-		}
+		return _frame_pool->pop();
 	}
-
-	return frame;
-}
-
-void ffmpeg_instance::push_used_frame(std::shared_ptr<AVFrame> frame)
-{
-	_used_frames.push(frame);
-}
-
-std::shared_ptr<AVFrame> ffmpeg_instance::pop_used_frame()
-{
-	auto frame = _used_frames.front();
-	_used_frames.pop();
-	return frame;
 }
 
 bool ffmpeg_instance::get_extra_data(uint8_t** data, size_t* size)
@@ -540,8 +532,7 @@ bool ffmpeg_instance::get_extra_data(uint8_t** data, size_t* size)
 	if (!_have_first_frame)
 		return false;
 
-	*data = _extra_data.data();
-	*size = _extra_data.size();
+	_parameter_sets.header(data, size);
 	return true;
 }
 
@@ -550,8 +541,7 @@ bool ffmpeg_instance::get_sei_data(uint8_t** data, size_t* size)
 	if (!_have_first_frame)
 		return false;
 
-	*data = _sei_data.data();
-	*size = _sei_data.size();
+	_parameter_sets.sei(data, size);
 	return true;
 }
 
@@ -565,49 +555,33 @@ void ffmpeg_instance::get_video_info(struct video_scale_info* info)
 
 int ffmpeg_instance::receive_packet(bool* received_packet, struct encoder_packet* packet)
 {
-	int res = 0;
-
-	av_packet_unref(_packet.get());
+	{ // Take the oldest finished packet, OBS no longer needs the one we handed out last time.
+		std::lock_guard<std::mutex> lg(_output_lock);
+		if (_output_packets.empty()) {
+			return AVERROR(EAGAIN);
+		}
 
-	{
-		auto gctx = streamfx::obs::gs::context();
-		res       = avcodec_receive_packet(_context, _packet.get());
-	}
-	if (res != 0) {
-		return res;
+		av_packet_unref(_packet.get());
+		_free_packets.push_back(_packet);
+		_packet = _output_packets.front();
+		_output_packets.pop_front();
 	}
 
-	if (!_have_first_frame) {
-		if (_codec->id == AV_CODEC_ID_H264) {
-			uint8_t*    tmp_packet;
-			uint8_t*    tmp_header;
-			uint8_t*    tmp_sei;
-			std::size_t sz_packet, sz_header, sz_sei;
-
-			obs_extract_avc_headers(_packet->data, static_cast<size_t>(_packet->size), &tmp_packet, &sz_packet, &tmp_header, &sz_header, &tmp_sei, &sz_sei);
-
-			if (sz_header) {
-				_extra_data.resize(sz_header);
-				std::memcpy(_extra_data.data(), tmp_header, sz_header);
-			}
-
-			if (sz_sei) {
-				_sei_data.resize(sz_sei);
-				std::memcpy(_sei_data.data(), tmp_sei, sz_sei);
-			}
-
-			// Not required, we only need the Extra Data and SEI Data anyway.
-			//std::memcpy(_current_packet.data, tmp_packet, sz_packet);
-			//_current_packet.size = static_cast<int>(sz_packet);
+	// Track how long it took from submitting the frame to getting the packet.
+	_latency->track(std::chrono::high_resolution_clock::now() - _latency_start[static_cast<size_t>(_packet->pts) % _latency_start.size()]);
 
-			bfree(tmp_packet);
-			bfree(tmp_header);
-			bfree(tmp_sei);
+	// In-band headers can only change on keyframes, so every other packet skips the scan entirely. Unchanged headers are
+	// detected by hash and cost neither an allocation nor a copy.
+	if (!_have_first_frame || (_packet->flags & AV_PKT_FLAG_KEY)) {
+		if (_codec->id == AV_CODEC_ID_H264) {
+			_parameter_sets.update(_packet->data, static_cast<size_t>(_packet->size), true, h264::classify, !_have_first_frame);
 		} else if (_codec->id == AV_CODEC_ID_HEVC) {
-			hevc::extract_header_sei(_packet->data, static_cast<size_t>(_packet->size), _extra_data, _sei_data);
-		} else if (_context->extradata != nullptr) {
-			_extra_data.resize(static_cast<size_t>(_context->extradata_size));
-			std::memcpy(_extra_data.data(), _context->extradata, static_cast<size_t>(_context->extradata_size));
+			_parameter_sets.update(_packet->data, static_cast<size_t>(_packet->size), true, hevc::classify, !_have_first_frame);
+		} else if ((_codec->id == AV_CODEC_ID_AV1) && (_context->extradata == nullptr)) {
+			// Without global headers, the Sequence Header only exists in the bitstream.
+			_parameter_sets.update(_packet->data, static_cast<size_t>(_packet->size), false, av1::classify, false);
+		} else if (!_have_first_frame && (_context->extradata != nullptr)) {
+			_parameter_sets.set_header(_context->extradata, static_cast<size_t>(_context->extradata_size));
 		}
 		_have_first_frame = true;
 	}
@@ -633,8 +607,7 @@ int ffmpeg_instance::receive_packet(bool* received_packet, struct encoder_packet
 	for (size_t idx = 0, edx = static_cast<size_t>(_packet->side_data_elems); idx < edx; idx++) {
 		auto& side_data = _packet->side_data[idx];
 		if (side_data.type == AV_PKT_DATA_NEW_EXTRADATA) {
-			_extra_data.resize(side_data.size);
-			std::memcpy(_extra_data.data(), side_data.data, side_data.size);
+			_parameter_sets.set_header(side_data.data, side_data.size);
 		} else if (side_data.type == AV_PKT_DATA_QUALITY_STATS) {
 			// Decisions based on picture type, if present.
 			switch (side_data.data[sizeof(uint32_t)]) {
@@ -675,98 +648,152 @@ int ffmpeg_instance::receive_packet(bool* received_packet, struct encoder_packet
 		}
 	}
 
-	// Push free frame back into pool.
-	push_free_frame(pop_used_frame());
+	if (uint64_t generation = _parameter_sets.generation(); generation != _parameter_sets_generation) {
+		if (_parameter_sets_generation != 0) {
+			DLOG_INFO("[%s] Codec headers changed mid-stream (generation %" PRIu64 ").", _codec->name, generation);
+		}
+		_parameter_sets_generation = generation;
+	}
 
-	return res;
+	return 0;
 }
 
 int ffmpeg_instance::send_frame(std::shared_ptr<AVFrame> const frame)
 {
 	int res = 0;
 	{
-		auto gctx = streamfx::obs::gs::context();
-		res       = avcodec_send_frame(_context, frame.get());
-	}
-	if (res == 0) {
-		push_used_frame(frame);
+		::streamfx::ffmpeg::hwapi::graphics_lock<streamfx::obs::gs::context> gctx(_hwinst);
+		res = avcodec_send_frame(_context, frame.get());
 	}
-
 	return res;
 }
 
 bool ffmpeg_instance::encode_avframe(std::shared_ptr<AVFrame> frame, encoder_packet* packet, bool* received_packet)
 {
-	bool sent_frame  = false;
-	bool recv_packet = false;
-	bool should_lag  = (_sent_frames >= _lag_in_frames);
+	if (_encode_failed) {
+		return false;
+	}
 
-	auto loop_begin = std::chrono::high_resolution_clock::now();
-	auto loop_end   = loop_begin + std::chrono::milliseconds(50);
+	// Remember when the frame was submitted, so that we know its latency once the packet comes out.
+	_latency_start[static_cast<size_t>(frame->pts) % _latency_start.size()] = std::chrono::high_resolution_clock::now();
 
-	while ((!sent_frame || (should_lag && !recv_packet)) && !(std::chrono::high_resolution_clock::now() > loop_end)) {
-		bool eagain_is_stupid = false;
+	{ // Hand the frame to the encode thread, only waiting if it has fallen far behind.
+		std::unique_lock<std::mutex> ul(_input_lock);
+		_input_space_cv.wait(ul, [this]() { return (_input_frames.size() < input_queue_size) || _encode_failed; });
+		_input_frames.push_back(frame);
+		_input_depth_max = std::max(_input_depth_max, _input_frames.size());
+	}
+	_input_cv.notify_one();
 
-		if (!sent_frame) {
+	// Hand the oldest finished packet to OBS, if there is one.
+	if (int res = receive_packet(received_packet, packet); (res != 0) && (res != AVERROR(EAGAIN))) {
+		return false;
+	}
+
+	return true;
+}
+
+void ffmpeg_instance::encode_thread()
+{
+	while (true) {
+		std::shared_ptr<AVFrame> frame;
+		{
+			std::unique_lock<std::mutex> ul(_input_lock);
+			_input_cv.wait(ul, [this]() { return _encode_stop || !_input_frames.empty(); });
+			if (_input_frames.empty()) { // Only happens once we are asked to stop.
+				break;
+			}
+
+			frame = _input_frames.front();
+			_input_frames.pop_front();
+			_input_busy = true;
+		}
+		_input_space_cv.notify_all();
+
+		std::lock_guard<std::mutex> lg(_context_lock);
+
+		// Keep offering the frame to the encoder, collecting packets whenever it asks us to.
+		while (frame) {
 			int res = send_frame(frame);
 			switch (res) {
 			case 0:
-				sent_frame = true;
-				frame      = nullptr;
+				frame = nullptr;
 				break;
 			case AVERROR(EAGAIN):
-				// This means we should call receive_packet again, but what do we do with that data?
-				// Why can't we queue on both? Do I really have to implement threading for this stuff?
-				if (*received_packet == true) {
-					DLOG_WARNING("Skipped frame due to EAGAIN when a packet was already returned.");
-					sent_frame = true;
+				if (receive_packets() == 0) {
+					DLOG_ERROR("Both send and receive returned EAGAIN, encoder is broken.");
+					_encode_failed = true;
+					frame = nullptr;
 				}
-				eagain_is_stupid = true;
 				break;
-			case AVERROR(EOF):
+			case AVERROR_EOF:
 				DLOG_ERROR("Skipped frame due to end of stream.");
-				sent_frame = true;
+				frame = nullptr;
 				break;
 			default:
 				DLOG_ERROR("Failed to encode frame: %s (%" PRId32 ").", ::streamfx::ffmpeg::tools::get_error_description(res), res);
-				return false;
+				_encode_failed = true;
+				frame = nullptr;
+				break;
 			}
 		}
 
-		if (!recv_packet) {
-			int res = receive_packet(received_packet, packet);
-			switch (res) {
-			case 0:
-				recv_packet = true;
-				break;
-			case AVERROR(EOF):
-				DLOG_ERROR("Received end of file.");
-				recv_packet = true;
-				break;
-			case AVERROR(EAGAIN):
-				if (sent_frame) {
-					recv_packet = true;
-				}
-				if (eagain_is_stupid) {
-					DLOG_ERROR("Both send and recieve returned EAGAIN, encoder is broken.");
-					return false;
-				}
-				break;
-			default:
+		// Collect whatever the encoder has finished so far.
+		receive_packets();
+
+		{
+			std::lock_guard<std::mutex> lg(_input_lock);
+			_input_busy = false;
+		}
+
+		if (_encode_failed) {
+			_input_space_cv.notify_all();
+		}
+	}
+}
+
+std::size_t ffmpeg_instance::receive_packets()
+{
+	std::size_t count = 0;
+
+	while (true) {
+		std::shared_ptr<AVPacket> packet;
+		{
+			std::lock_guard<std::mutex> lg(_output_lock);
+			if (!_free_packets.empty()) {
+				packet = _free_packets.back();
+				_free_packets.pop_back();
+			}
+		}
+		if (!packet) {
+			packet = {av_packet_alloc(), [](AVPacket* ptr) { av_packet_free(&ptr); }};
+		}
+
+		int res = 0;
+		{
+			::streamfx::ffmpeg::hwapi::graphics_lock<streamfx::obs::gs::context> gctx(_hwinst);
+			res = avcodec_receive_packet(_context, packet.get());
+		}
+		if (res != 0) {
+			if ((res != AVERROR(EAGAIN)) && (res != AVERROR_EOF)) {
 				DLOG_ERROR("Failed to receive packet: %s (%" PRId32 ").", ::streamfx::ffmpeg::tools::get_error_description(res), res);
-				return false;
+				_encode_failed = true;
 			}
+
+			std::lock_guard<std::mutex> lg(_output_lock);
+			_free_packets.push_back(packet);
+			break;
 		}
 
-		if (!sent_frame || !recv_packet) {
-			std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		{
+			std::lock_guard<std::mutex> lg(_output_lock);
+			_output_packets.push_back(packet);
+			_output_depth_max = std::max(_output_depth_max, _output_packets.size());
 		}
+		count++;
 	}
 
-	if (!sent_frame)
-		push_free_frame(frame);
-
-	return true;
+	return count;
 }
 
 bool ffmpeg_instance::is_hardware_encode()
@@ -784,6 +811,11 @@ AVCodecContext* ffmpeg_instance::get_avcodeccontext()
 	return _context;
 }
 
+uint64_t ffmpeg_instance::get_parameter_set_generation()
+{
+	return _parameter_sets.generation();
+}
+
 void ffmpeg_instance::parse_ffmpeg_commandline(std::string_view text)
 {
 	// Steps to properly parse a command line:
@@ -1001,6 +1033,7 @@ void ffmpeg_factory::get_defaults2(obs_data_t* settings)
 		obs_data_set_default_string(settings, ST_KEY_FFMPEG_CUSTOMSETTINGS, "");
 		obs_data_set_default_int(settings, ST_KEY_FFMPEG_THREADS, 0);
 		obs_data_set_default_int(settings, ST_KEY_FFMPEG_GPU, -1);
+		obs_data_set_default_int(settings, ST_KEY_FFMPEG_SCALER, static_cast<int64_t>(::streamfx::ffmpeg::swscale_quality::QUALITY));
 	}
 }
 
@@ -1085,6 +1118,13 @@ obs_properties_t* ffmpeg_factory::get_properties2(instance_t* data)
 			auto p = obs_properties_add_int_slider(grp, ST_KEY_FFMPEG_THREADS, D_TRANSLATE(ST_I18N_FFMPEG_THREADS), 0, static_cast<int64_t>(std::thread::hardware_concurrency()) * 2, 1);
 		}
 
+		{ // Color Conversion
+			auto p = obs_properties_add_list(grp, ST_KEY_FFMPEG_SCALER, D_TRANSLATE(ST_I18N_FFMPEG_SCALER), OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_INT);
+			obs_property_list_add_int(p, D_TRANSLATE(ST_I18N_FFMPEG_SCALER_("Fast")), static_cast<int64_t>(::streamfx::ffmpeg::swscale_quality::FAST));
+			obs_property_list_add_int(p, D_TRANSLATE(ST_I18N_FFMPEG_SCALER_("Balanced")), static_cast<int64_t>(::streamfx::ffmpeg::swscale_quality::BALANCED));
+			obs_property_list_add_int(p, D_TRANSLATE(ST_I18N_FFMPEG_SCALER_("Quality")), static_cast<int64_t>(::streamfx::ffmpeg::swscale_quality::QUALITY));
+		}
+
 		{ // Frame Skipping
 			obs_video_info ovi;
 			if (!obs_get_video_info(&ovi)) {
@@ -1188,6 +1228,7 @@ bool ffmpeg_manager::has_handler(std::string_view codec)
 static std::shared_ptr<ffmpeg_manager> loader_instance;
 
 static auto loader = streamfx::loader(
+	"encoder-ffmpeg",
 	[]() { // Initalizer
 		loader_instance = ffmpeg_manager::instance();
 	},
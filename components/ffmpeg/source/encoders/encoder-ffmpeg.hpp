@@ -6,17 +6,19 @@
 #pragma once
 #include "common.hpp"
 #include "encoders/ffmpeg/handler.hpp"
-#include "ffmpeg/avframe-queue.hpp"
+#include "ffmpeg/avframe-pool.hpp"
 #include "ffmpeg/hwapi/base.hpp"
+#include "ffmpeg/parameter-set-cache.hpp"
 #include "ffmpeg/swscale.hpp"
 #include "obs/obs-encoder-factory.hpp"
 
 #include "warning-disable.hpp"
+#include <array>
+#include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <map>
 #include <mutex>
-#include <queue>
-#include <stack>
 #include <string>
 #include <string_view>
 #include <thread>
@@ -45,19 +47,36 @@ namespace streamfx::encoder::ffmpeg {
 		std::shared_ptr<::streamfx::ffmpeg::hwapi::base>     _hwapi;
 		std::shared_ptr<::streamfx::ffmpeg::hwapi::instance> _hwinst;
 
-		std::size_t _lag_in_frames;
-		std::size_t _sent_frames;
 		std::size_t _framerate_divisor;
 
 		// Extra Data
-		bool                 _have_first_frame;
-		std::vector<uint8_t> _extra_data;
-		std::vector<uint8_t> _sei_data;
-
-		// Frame Stack and Queue
-		std::stack<std::shared_ptr<AVFrame>>           _free_frames;
-		std::queue<std::shared_ptr<AVFrame>>           _used_frames;
-		std::chrono::high_resolution_clock::time_point _free_frames_last_used;
+		bool                                      _have_first_frame;
+		::streamfx::ffmpeg::parameter_set_cache _parameter_sets;
+		uint64_t                                  _parameter_sets_generation;
+
+		// Frame Pool
+		std::shared_ptr<::streamfx::ffmpeg::avframe_pool> _frame_pool;
+
+		// Encode Thread
+		std::thread                            _encode_thread;
+		std::mutex                             _context_lock;
+		std::atomic<bool>                      _encode_stop;
+		std::atomic<bool>                      _encode_failed;
+		std::mutex                             _input_lock;
+		std::condition_variable                _input_cv;
+		std::condition_variable                _input_space_cv;
+		std::deque<std::shared_ptr<AVFrame>>   _input_frames;
+		bool                                   _input_busy;
+		std::mutex                             _output_lock;
+		std::deque<std::shared_ptr<AVPacket>>  _output_packets;
+		std::vector<std::shared_ptr<AVPacket>> _free_packets;
+
+		// Statistics
+		std::shared_ptr<::streamfx::util::profiler>                     _latency;
+		std::shared_ptr<::streamfx::util::profiler>                     _convert_time;
+		std::array<std::chrono::high_resolution_clock::time_point, 256> _latency_start;
+		std::size_t                                                     _input_depth_max;
+		std::size_t                                                     _output_depth_max;
 
 		public:
 		ffmpeg_instance(obs_data_t* settings, obs_encoder_t* self, bool is_hw);
@@ -86,18 +105,18 @@ namespace streamfx::encoder::ffmpeg {
 		void initialize_sw(obs_data_t* settings);
 		void initialize_hw(obs_data_t* settings);
 
-		void                     push_free_frame(std::shared_ptr<AVFrame> frame);
 		std::shared_ptr<AVFrame> pop_free_frame();
 
-		void                     push_used_frame(std::shared_ptr<AVFrame> frame);
-		std::shared_ptr<AVFrame> pop_used_frame();
-
 		int receive_packet(bool* received_packet, struct encoder_packet* packet);
 
 		int send_frame(std::shared_ptr<AVFrame> frame);
 
 		bool encode_avframe(std::shared_ptr<AVFrame> frame, struct encoder_packet* packet, bool* received_packet);
 
+		void encode_thread();
+
+		std::size_t receive_packets();
+
 		public: // Handler API
 		bool is_hardware_encode();
 
@@ -105,6 +124,9 @@ namespace streamfx::encoder::ffmpeg {
 
 		AVCodecContext* get_avcodeccontext();
 
+		/** Number of times the codec headers changed so far, outputs can compare this to notice mid-stream changes. */
+		uint64_t get_parameter_set_generation();
+
 		void parse_ffmpeg_commandline(std::string_view text);
 	};
 
@@ -0,0 +1,197 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2020-2023 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "avframe-pool.hpp"
+
+#include "warning-disable.hpp"
+#include <map>
+#include <stdexcept>
+#include <tuple>
+#include "warning-enable.hpp"
+
+extern "C" {
+#include "warning-disable.hpp"
+#include <libavutil/imgutils.h>
+#include <libavutil/pixdesc.h>
+#include "warning-enable.hpp"
+}
+
+using namespace streamfx::ffmpeg;
+
+// Number of unused AVFrame structures to keep around for reuse.
+static constexpr std::size_t frame_cache_size = 32;
+
+// Extra rows and bytes allocated per plane, as some encoders read past the visible area.
+static constexpr int         height_alignment = 32;
+static constexpr std::size_t plane_padding    = 64;
+
+static inline int32_t align_up(int32_t value, int32_t align)
+{
+	return (value + align - 1) & ~(align - 1);
+}
+
+static inline int32_t plane_height(const AVPixFmtDescriptor* desc, std::size_t plane, int32_t height)
+{
+	// Only the chroma planes are subsampled, luma and alpha are always full height.
+	if ((plane == 1) || (plane == 2)) {
+		return -((-height) >> desc->log2_chroma_h);
+	}
+	return height;
+}
+
+avframe_pool::avframe_pool(int32_t width, int32_t height, AVPixelFormat format) : _width(width), _height(height), _format(format), _linesize(), _buffers(), _lock(), _frames()
+{
+	const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(format);
+	if (!desc || (desc->flags & AV_PIX_FMT_FLAG_HWACCEL) || (width <= 0) || (height <= 0)) {
+		throw std::invalid_argument("Unsupported frame size or format for pooling.");
+	}
+
+	// Find the smallest padded width which gives every plane an aligned line size, same as av_frame_get_buffer.
+	for (int32_t align = 1; align <= static_cast<int32_t>(alignment); align *= 2) {
+		if (av_image_fill_linesizes(_linesize.data(), format, align_up(width, align)) < 0) {
+			throw std::invalid_argument("Unsupported frame size or format for pooling.");
+		}
+
+		bool aligned = true;
+		for (auto ls : _linesize) {
+			aligned &= (ls % static_cast<int>(alignment)) == 0;
+		}
+		if (aligned) {
+			break;
+		}
+	}
+
+	int32_t padded_height = align_up(height, height_alignment);
+	for (std::size_t idx = 0; idx < _buffers.size(); idx++) {
+		if (_linesize[idx] <= 0) {
+			continue;
+		}
+
+		std::size_t size = static_cast<std::size_t>(_linesize[idx]) * static_cast<std::size_t>(plane_height(desc, idx, padded_height)) + plane_padding;
+		_buffers[idx]    = av_buffer_pool_init(size, av_buffer_allocz);
+		if (!_buffers[idx]) {
+			for (auto& pool : _buffers) {
+				av_buffer_pool_uninit(&pool);
+			}
+			throw std::bad_alloc();
+		}
+	}
+}
+
+avframe_pool::~avframe_pool()
+{
+	for (auto frame : _frames) {
+		av_frame_free(&frame);
+	}
+	_frames.clear();
+
+	// Buffers that are still in use keep their pool alive until they are returned.
+	for (auto& pool : _buffers) {
+		av_buffer_pool_uninit(&pool);
+	}
+}
+
+int32_t avframe_pool::width()
+{
+	return _width;
+}
+
+int32_t avframe_pool::height()
+{
+	return _height;
+}
+
+AVPixelFormat avframe_pool::format()
+{
+	return _format;
+}
+
+int avframe_pool::linesize(std::size_t plane)
+{
+	return _linesize.at(plane);
+}
+
+std::shared_ptr<AVFrame> avframe_pool::allocate_frame()
+{
+	AVFrame* frame = nullptr;
+	{
+		std::lock_guard<std::mutex> lg(_lock);
+		if (!_frames.empty()) {
+			frame = _frames.back();
+			_frames.pop_back();
+		}
+	}
+	if (!frame) {
+		frame = av_frame_alloc();
+		if (!frame) {
+			throw std::bad_alloc();
+		}
+	}
+
+	return std::shared_ptr<AVFrame>(frame, [wpool = weak_from_this()](AVFrame* frame) {
+		// Dropping the references hands the plane memory back to its pool.
+		av_frame_unref(frame);
+
+		if (auto pool = wpool.lock(); pool) {
+			std::lock_guard<std::mutex> lg(pool->_lock);
+			if (pool->_frames.size() < frame_cache_size) {
+				pool->_frames.push_back(frame);
+				return;
+			}
+		}
+		av_frame_free(&frame);
+	});
+}
+
+std::shared_ptr<AVFrame> avframe_pool::pop()
+{
+	auto frame    = allocate_frame();
+	frame->width  = _width;
+	frame->height = _height;
+	frame->format = _format;
+
+	for (std::size_t idx = 0; idx < _buffers.size(); idx++) {
+		if (!_buffers[idx]) {
+			continue;
+		}
+
+		frame->buf[idx] = av_buffer_pool_get(_buffers[idx]);
+		if (!frame->buf[idx]) {
+			throw std::bad_alloc();
+		}
+		frame->data[idx]     = frame->buf[idx]->data;
+		frame->linesize[idx] = _linesize[idx];
+	}
+	frame->extended_data = frame->data;
+
+	return frame;
+}
+
+std::shared_ptr<avframe_pool> avframe_pool::instance(int32_t width, int32_t height, AVPixelFormat format)
+{
+	static std::map<std::tuple<int32_t, int32_t, AVPixelFormat>, std::weak_ptr<avframe_pool>> instances;
+	static std::mutex                                                                          mtx;
+
+	std::unique_lock<decltype(mtx)> lock(mtx);
+
+	// Forget about pools nobody uses anymore.
+	for (auto iter = instances.begin(); iter != instances.end();) {
+		if (iter->second.expired()) {
+			iter = instances.erase(iter);
+		} else {
+			++iter;
+		}
+	}
+
+	auto key = std::make_tuple(width, height, format);
+	if (auto iter = instances.find(key); iter != instances.end()) {
+		if (auto instance = iter->second.lock(); instance) {
+			return instance;
+		}
+	}
+
+	auto instance  = std::make_shared<avframe_pool>(width, height, format);
+	instances[key] = instance;
+	return instance;
+}
@@ -0,0 +1,66 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2020-2023 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "common.hpp"
+
+#include "warning-disable.hpp"
+#include <array>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "warning-enable.hpp"
+
+extern "C" {
+#include "warning-disable.hpp"
+#include <libavutil/buffer.h>
+#include <libavutil/frame.h>
+#include <libavutil/pixfmt.h>
+#include "warning-enable.hpp"
+}
+
+namespace streamfx::ffmpeg {
+	/** Pool of identically sized AVFrames.
+	 *
+	 * Plane memory comes from one av_buffer_pool per plane, so it returns to the pool as soon as the last reference
+	 * to a frame is dropped, even if an encoder is still holding onto it. Pools are shared by every user that asks for
+	 * the same resolution and format through instance().
+	 */
+	class avframe_pool : public std::enable_shared_from_this<avframe_pool> {
+		int32_t       _width;
+		int32_t       _height;
+		AVPixelFormat _format;
+
+		std::array<int, AV_NUM_DATA_POINTERS>           _linesize;
+		std::array<AVBufferPool*, AV_NUM_DATA_POINTERS> _buffers;
+
+		std::mutex            _lock;
+		std::vector<AVFrame*> _frames;
+
+		std::shared_ptr<AVFrame> allocate_frame();
+
+		public:
+		avframe_pool(int32_t width, int32_t height, AVPixelFormat format);
+		~avframe_pool();
+
+		int32_t       width();
+		int32_t       height();
+		AVPixelFormat format();
+
+		/** Line size in bytes that frames from this pool use for the given plane. */
+		int linesize(std::size_t plane);
+
+		/** Alignment in bytes of both plane pointers and line sizes for frames from this pool. */
+		static constexpr std::size_t alignment = 64;
+
+		/** Retrieve a frame with freshly referenced plane memory.
+		 *
+		 * Only the frame size and format are set, everything else is reset.
+		 */
+		std::shared_ptr<AVFrame> pop();
+
+		public:
+		static std::shared_ptr<avframe_pool> instance(int32_t width, int32_t height, AVPixelFormat format);
+	};
+} // namespace streamfx::ffmpeg
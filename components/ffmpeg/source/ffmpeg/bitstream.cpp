@@ -0,0 +1,177 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2023 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "bitstream.hpp"
+
+#include "warning-disable.hpp"
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define ST_BITSTREAM_AVX2
+#define ST_BITSTREAM_SSE2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#include <emmintrin.h>
+#define ST_BITSTREAM_SSE2
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#include <arm_neon.h>
+#define ST_BITSTREAM_NEON
+#endif
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#include "warning-enable.hpp"
+
+using namespace streamfx::ffmpeg;
+
+#if defined(ST_BITSTREAM_SSE2)
+static inline uint32_t least_significant_bit(uint32_t value)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward(&index, value);
+	return static_cast<uint32_t>(index);
+#else
+	return static_cast<uint32_t>(__builtin_ctz(value));
+#endif
+}
+#endif
+
+const uint8_t* bitstream::find_start_code(const uint8_t* ptr, const uint8_t* end)
+{
+	// Compare each position against 0x00, the next against 0x00 and the one after that against 0x01 at once. The two
+	// extra bytes each unaligned load reads are why every loop stops that far from the end.
+#if defined(ST_BITSTREAM_AVX2)
+	{
+		const __m256i zero = _mm256_setzero_si256();
+		const __m256i one  = _mm256_set1_epi8(1);
+		for (; (end - ptr) >= (32 + 2); ptr += 32) {
+			__m256i a = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr)), zero);
+			__m256i b = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr + 1)), zero);
+			__m256i c = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr + 2)), one);
+			if (uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_and_si256(a, b), c))); mask != 0) {
+				return ptr + least_significant_bit(mask);
+			}
+		}
+	}
+#endif
+#if defined(ST_BITSTREAM_SSE2)
+	{
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i one  = _mm_set1_epi8(1);
+		for (; (end - ptr) >= (16 + 2); ptr += 16) {
+			__m128i a = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr)), zero);
+			__m128i b = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr + 1)), zero);
+			__m128i c = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr + 2)), one);
+			if (uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(_mm_and_si128(a, b), c))); mask != 0) {
+				return ptr + least_significant_bit(mask);
+			}
+		}
+	}
+#elif defined(ST_BITSTREAM_NEON)
+	{
+		const uint8x16_t zero = vdupq_n_u8(0);
+		const uint8x16_t one  = vdupq_n_u8(1);
+		for (; (end - ptr) >= (16 + 2); ptr += 16) {
+			uint8x16_t a = vceqq_u8(vld1q_u8(ptr), zero);
+			uint8x16_t b = vceqq_u8(vld1q_u8(ptr + 1), zero);
+			uint8x16_t c = vceqq_u8(vld1q_u8(ptr + 2), one);
+			uint64x2_t m = vreinterpretq_u64_u8(vandq_u8(vandq_u8(a, b), c));
+			if ((vgetq_lane_u64(m, 0) | vgetq_lane_u64(m, 1)) != 0) {
+				// NEON has no movemask, but start codes are rare enough to just look at the 16 bytes again.
+				break;
+			}
+		}
+	}
+#endif
+
+	for (; (end - ptr) >= 3; ptr++) {
+		if (ptr[2] > 1) {
+			// No start code can begin at any of these three positions, as the third byte is neither 0x00 nor 0x01.
+			ptr += 2;
+			continue;
+		}
+		if ((ptr[0] == 0x00) && (ptr[1] == 0x00) && (ptr[2] == 0x01)) {
+			return ptr;
+		}
+	}
+
+	return end;
+}
+
+void bitstream::split_annexb(uint8_t* data, std::size_t size, std::vector<unit>& units)
+{
+	units.clear();
+
+	uint8_t* end = data + size;
+	uint8_t* ptr = const_cast<uint8_t*>(find_start_code(data, end));
+	while (ptr < end) {
+		// A four byte start code is a zero_byte followed by the three byte one.
+		uint8_t* prefix = ((ptr > data) && (ptr[-1] == 0x00)) ? ptr - 1 : ptr;
+		uint8_t* nal    = ptr + 3;
+		uint8_t* next   = const_cast<uint8_t*>(find_start_code(nal, end));
+
+		// Trailing zero bytes belong to the byte stream, not the NAL unit.
+		uint8_t* nal_end = next;
+		while ((nal_end > nal) && (nal_end[-1] == 0x00)) {
+			nal_end--;
+		}
+
+		if (nal_end > nal) {
+			units.push_back({prefix, nal, static_cast<std::size_t>(nal_end - nal)});
+		}
+
+		ptr = next;
+	}
+}
+
+bool bitstream::split_obu(uint8_t* data, std::size_t size, std::vector<unit>& units)
+{
+	units.clear();
+
+	uint8_t* end = data + size;
+	for (uint8_t* ptr = data; ptr < end;) {
+		// See AV1 Bitstream & Decoding Process Specification, 5.3 OBU syntax.
+		uint8_t header = ptr[0];
+		if ((header & 0x80) != 0) { // obu_forbidden_bit
+			return false;
+		}
+
+		std::size_t header_size = ((header & 0x04) != 0) ? 2 : 1; // obu_extension_flag
+		if (static_cast<std::size_t>(end - ptr) < header_size) {
+			return false;
+		}
+
+		std::size_t obu_size = static_cast<std::size_t>(end - ptr);
+		if ((header & 0x02) != 0) { // obu_has_size_field
+			// leb128(), at most 8 bytes.
+			uint64_t    value = 0;
+			std::size_t len   = 0;
+			for (; len < 8; len++) {
+				if ((ptr + header_size + len) >= end) {
+					return false;
+				}
+
+				uint8_t byte = ptr[header_size + len];
+				value |= static_cast<uint64_t>(byte & 0x7F) << (len * 7);
+				if ((byte & 0x80) == 0) {
+					len++;
+					break;
+				}
+			}
+			if ((len == 0) || ((ptr[header_size + len - 1] & 0x80) != 0)) {
+				return false;
+			}
+
+			std::size_t available = static_cast<std::size_t>(end - ptr) - header_size - len;
+			if (value > available) {
+				return false;
+			}
+			obu_size = header_size + len + static_cast<std::size_t>(value);
+		}
+
+		units.push_back({ptr, ptr, obu_size});
+		ptr += obu_size;
+	}
+
+	return true;
+}
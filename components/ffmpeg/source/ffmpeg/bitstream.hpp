@@ -0,0 +1,63 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2023 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "common.hpp"
+
+#include "warning-disable.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "warning-enable.hpp"
+
+namespace streamfx::ffmpeg::bitstream {
+	/** A single NAL unit or OBU inside of a packet.
+	 *
+	 * For Annex-B streams, 'prefix' points at the start code (including the optional zero_byte) and 'data' at the NAL
+	 * unit header. For AV1 both point at the OBU header. 'size' counts from 'data' to the end of the unit, excluding
+	 * any trailing zero bytes.
+	 */
+	struct unit {
+		uint8_t*    prefix;
+		uint8_t*    data;
+		std::size_t size;
+
+		inline uint8_t* begin() const
+		{
+			return prefix;
+		}
+
+		inline uint8_t* end() const
+		{
+			return data + size;
+		}
+	};
+
+	/** Find the next Annex-B start code (0x000001).
+	 *
+	 * Uses AVX2, SSE2 or NEON if the build targets them.
+	 *
+	 * \param ptr Beginning of the search range.
+	 * \param end End of the search range (exclusive).
+	 *
+	 * \return Pointer to the first byte of the start code, or \ref end if there is none.
+	 */
+	const uint8_t* find_start_code(const uint8_t* ptr, const uint8_t* end);
+
+	/** Split an Annex-B byte stream (H.264, HEVC) into its NAL units in a single pass.
+	 *
+	 * Anything before the first start code is skipped.
+	 *
+	 * \param units Receives the NAL units in stream order, existing content is cleared.
+	 */
+	void split_annexb(uint8_t* data, std::size_t size, std::vector<unit>& units);
+
+	/** Split a low overhead AV1 bitstream into its OBUs.
+	 *
+	 * \param units Receives the OBUs in stream order, existing content is cleared.
+	 *
+	 * \return false if the stream is malformed, in which case units contains the OBUs up to that point.
+	 */
+	bool split_obu(uint8_t* data, std::size_t size, std::vector<unit>& units);
+} // namespace streamfx::ffmpeg::bitstream
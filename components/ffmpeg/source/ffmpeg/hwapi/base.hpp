@@ -8,6 +8,8 @@
 
 #include "warning-disable.hpp"
 #include <list>
+#include <memory>
+#include <optional>
 #include <utility>
 #include "warning-enable.hpp"
 
@@ -37,6 +39,23 @@ namespace streamfx::ffmpeg::hwapi {
 		virtual std::shared_ptr<AVFrame> avframe_from_obs(AVBufferRef* frames, uint32_t handle, uint64_t lock_key, uint64_t* next_lock_key) = 0;
 	};
 
+	/** Holds a graphics context for as long as it lives, but only if there is a hardware instance.
+	 *
+	 * Only hardware contexts share the graphics device with OBS, software encoders must not stall the renderer.
+	 */
+	template<typename Context>
+	class graphics_lock {
+		std::optional<Context> _context;
+
+		public:
+		graphics_lock(const std::shared_ptr<instance>& hwinst) : _context()
+		{
+			if (hwinst) {
+				_context.emplace();
+			}
+		}
+	};
+
 	class base {
 		public:
 		virtual ~base(){};
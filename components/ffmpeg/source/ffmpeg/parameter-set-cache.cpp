@@ -0,0 +1,123 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2023 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "parameter-set-cache.hpp"
+
+using namespace streamfx::ffmpeg;
+
+parameter_set_cache::parameter_set_cache() : _lock(), _header(), _header_index(0), _header_hash(hash(nullptr, 0)), _sei(), _sei_hash(hash(nullptr, 0)), _generation(0), _units() {}
+
+parameter_set_cache::~parameter_set_cache() = default;
+
+bool parameter_set_cache::set_header(const uint8_t* data, std::size_t size)
+{
+	if (size == 0) {
+		return false;
+	}
+
+	uint64_t new_hash = hash(data, size);
+	if ((new_hash == _header_hash) && (size == _header[_header_index].size())) {
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lg(_lock);
+	auto&                       buffer = _header[_header_index ^ 1];
+	buffer.assign(data, data + size);
+	_header_index ^= 1;
+	_header_hash = new_hash;
+	_generation.fetch_add(1, std::memory_order_release);
+	return true;
+}
+
+bool parameter_set_cache::update(uint8_t* data, std::size_t size, bool annexb, classifier_t classify, bool with_sei)
+{
+	if (annexb) {
+		bitstream::split_annexb(data, size, _units);
+	} else {
+		bitstream::split_obu(data, size, _units);
+	}
+
+	// Hash whatever the packet carries in place, nothing is copied unless it differs from what we have.
+	uint64_t    header_hash = hash(nullptr, 0);
+	uint64_t    sei_hash    = hash(nullptr, 0);
+	std::size_t header_size = 0;
+	std::size_t sei_size    = 0;
+	for (auto& unit : _units) {
+		switch (classify(unit)) {
+		case unit_type::HEADER:
+			header_hash = hash(unit.begin(), static_cast<std::size_t>(unit.end() - unit.begin()), header_hash);
+			header_size += static_cast<std::size_t>(unit.end() - unit.begin());
+			break;
+		case unit_type::SEI:
+			sei_hash = hash(unit.begin(), static_cast<std::size_t>(unit.end() - unit.begin()), sei_hash);
+			sei_size += static_cast<std::size_t>(unit.end() - unit.begin());
+			break;
+		default:
+			break;
+		}
+	}
+
+	bool header_changed = (header_size > 0) && ((header_hash != _header_hash) || (header_size != _header[_header_index].size()));
+	bool sei_changed    = with_sei && (sei_size > 0) && ((sei_hash != _sei_hash) || (sei_size != _sei.size()));
+	if (!header_changed && !sei_changed) {
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lg(_lock);
+	if (header_changed) {
+		auto& buffer = _header[_header_index ^ 1];
+		buffer.clear();
+		for (auto& unit : _units) {
+			if (classify(unit) == unit_type::HEADER) {
+				buffer.insert(buffer.end(), unit.begin(), unit.end());
+			}
+		}
+		_header_index ^= 1;
+		_header_hash = header_hash;
+		_generation.fetch_add(1, std::memory_order_release);
+	}
+	if (sei_changed) {
+		_sei.clear();
+		for (auto& unit : _units) {
+			if (classify(unit) == unit_type::SEI) {
+				_sei.insert(_sei.end(), unit.begin(), unit.end());
+			}
+		}
+		_sei_hash = sei_hash;
+	}
+	return true;
+}
+
+bool parameter_set_cache::header(uint8_t** data, std::size_t* size)
+{
+	std::lock_guard<std::mutex> lg(_lock);
+	auto&                       buffer = _header[_header_index];
+	*data                              = buffer.data();
+	*size                              = buffer.size();
+	return !buffer.empty();
+}
+
+bool parameter_set_cache::sei(uint8_t** data, std::size_t* size)
+{
+	std::lock_guard<std::mutex> lg(_lock);
+	*data = _sei.data();
+	*size = _sei.size();
+	return !_sei.empty();
+}
+
+uint64_t parameter_set_cache::generation()
+{
+	return _generation.load(std::memory_order_acquire);
+}
+
+uint64_t parameter_set_cache::hash(const uint8_t* data, std::size_t size, uint64_t seed)
+{
+	// FNV-1a, parameter sets are a few dozen bytes so anything fancier would not pay off.
+	uint64_t value = seed;
+	for (std::size_t idx = 0; idx < size; idx++) {
+		value ^= data[idx];
+		value *= 0x100000001B3ull;
+	}
+	return value;
+}
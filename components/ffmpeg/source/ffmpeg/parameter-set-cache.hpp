@@ -0,0 +1,75 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2023 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "common.hpp"
+#include "bitstream.hpp"
+
+#include "warning-disable.hpp"
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include "warning-enable.hpp"
+
+namespace streamfx::ffmpeg {
+	/** Tracks the codec headers (parameter sets) and SEI of a stream.
+	 *
+	 * Incoming data is compared by content hash, so the stored copy is only rebuilt and the generation only advances if
+	 * something actually changed. Headers are double buffered: a pointer handed out by header() stays valid until the
+	 * headers changed twice more, which gives outputs reading them on another thread time to notice.
+	 */
+	class parameter_set_cache {
+		public:
+		enum class unit_type {
+			OTHER,
+			HEADER,
+			SEI,
+		};
+		typedef unit_type (*classifier_t)(const bitstream::unit& unit);
+
+		private:
+		std::mutex                          _lock;
+		std::array<std::vector<uint8_t>, 2> _header;
+		std::size_t                         _header_index;
+		uint64_t                            _header_hash;
+		std::vector<uint8_t>                _sei;
+		uint64_t                            _sei_hash;
+		std::atomic<uint64_t>               _generation;
+
+		std::vector<bitstream::unit> _units;
+
+		public:
+		parameter_set_cache();
+		~parameter_set_cache();
+
+		/** Replace the headers with an already complete set, for example from AV_PKT_DATA_NEW_EXTRADATA.
+		 *
+		 * \return true if the headers changed.
+		 */
+		bool set_header(const uint8_t* data, std::size_t size);
+
+		/** Pick up headers and SEI carried in-band in a packet.
+		 *
+		 * Packets without any headers leave the current ones untouched.
+		 *
+		 * \param annexb true for Annex-B byte streams (H.264, HEVC), false for AV1 OBUs.
+		 * \param classify Decides which units are headers or SEI.
+		 * \param with_sei Also update the SEI, usually only wanted for the first packet.
+		 *
+		 * \return true if the headers or SEI changed.
+		 */
+		bool update(uint8_t* data, std::size_t size, bool annexb, classifier_t classify, bool with_sei);
+
+		bool header(uint8_t** data, std::size_t* size);
+
+		bool sei(uint8_t** data, std::size_t* size);
+
+		/** Number of times the headers changed, 0 if there are none yet. */
+		uint64_t generation();
+
+		public:
+		static uint64_t hash(const uint8_t* data, std::size_t size, uint64_t seed = 0xCBF29CE484222325ull);
+	};
+} // namespace streamfx::ffmpeg
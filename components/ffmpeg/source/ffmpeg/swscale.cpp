@@ -6,11 +6,57 @@
 #include "swscale.hpp"
 
 #include "warning-disable.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <stdexcept>
+#include <thread>
 #include "warning-enable.hpp"
 
+extern "C" {
+#include "warning-disable.hpp"
+#include <libavutil/pixdesc.h>
+#include "warning-enable.hpp"
+}
+
 using namespace streamfx::ffmpeg;
 
+// Bands smaller than this spend more time on synchronization than on conversion.
+static constexpr int32_t     slice_minimum_rows = 128;
+static constexpr std::size_t slice_maximum      = 16;
+
+namespace {
+	struct slice_job {
+		const uint8_t* source_data[4];
+		int            source_stride[4];
+		int            source_shift[4];
+		uint8_t*       target_data[4];
+		int            target_stride[4];
+		int            target_shift[4];
+
+		const void* slices;
+		std::size_t count;
+
+		std::atomic<std::size_t> next{0};
+		std::atomic<int32_t>     rows{0};
+		std::atomic<int>         error{0};
+		std::mutex               lock;
+		std::condition_variable  finished_cv;
+		std::size_t              finished = 0;
+	};
+
+	void plane_shifts(AVPixelFormat format, int shift[4])
+	{
+		const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(format);
+		for (std::size_t idx = 0; idx < 4; idx++) {
+			// Only the chroma planes are subsampled, luma and alpha are always full height.
+			shift[idx] = ((idx == 1) || (idx == 2)) ? desc->log2_chroma_h : 0;
+		}
+	}
+} // namespace
+
 swscale::swscale() = default;
 
 swscale::~swscale()
@@ -144,7 +190,7 @@ bool swscale::is_target_full_range()
 	return this->target_full_range;
 }
 
-bool swscale::initialize(int flags)
+bool swscale::initialize(int flags, std::size_t slice_count)
 {
 	if (this->context) {
 		return false;
@@ -163,11 +209,51 @@ bool swscale::initialize(int flags)
 
 	sws_setColorspaceDetails(this->context, sws_getCoefficients(source_colorspace), source_full_range ? 1 : 0, sws_getCoefficients(target_colorspace), target_full_range ? 1 : 0, 1L << 16 | 0L, 1L << 16 | 0L, 1L << 16 | 0L);
 
+	// Slicing only works if every row of the output depends on the same row of the input.
+	const AVPixFmtDescriptor* source_desc = av_pix_fmt_desc_get(source_format);
+	const AVPixFmtDescriptor* target_desc = av_pix_fmt_desc_get(target_format);
+	if ((source_size != target_size) || !source_desc || !target_desc || (source_desc->log2_chroma_h != target_desc->log2_chroma_h) || (source_desc->flags & AV_PIX_FMT_FLAG_PAL) || (target_desc->flags & AV_PIX_FMT_FLAG_PAL)) {
+		slice_count = 1;
+	}
+
+	int32_t height = static_cast<int32_t>(source_size.second);
+	if (slice_count == 0) {
+		slice_count = std::min<std::size_t>(std::max<unsigned int>(std::thread::hardware_concurrency(), 1), static_cast<std::size_t>(height / slice_minimum_rows));
+	}
+	slice_count = std::clamp<std::size_t>(slice_count, 1, slice_maximum);
+
+	if (slice_count > 1) {
+		// Bands have to start on a row that also exists in the subsampled planes, and on a multiple of the 8 row
+		// ordered dither pattern in every plane. Otherwise each band restarts the pattern and output is not identical
+		// to an unsliced conversion.
+		int32_t alignment = 8 << source_desc->log2_chroma_h;
+		int32_t rows      = (((height + static_cast<int32_t>(slice_count) - 1) / static_cast<int32_t>(slice_count)) + alignment - 1) & ~(alignment - 1);
+
+		for (int32_t row = 0; row < height; row += rows) {
+			slice band   = {nullptr, row, std::min(rows, height - row)};
+			band.context = sws_getContext(static_cast<int>(source_size.first), band.rows, source_format, static_cast<int>(target_size.first), band.rows, target_format, flags, nullptr, nullptr, nullptr);
+			if (!band.context) {
+				finalize();
+				return false;
+			}
+			sws_setColorspaceDetails(band.context, sws_getCoefficients(source_colorspace), source_full_range ? 1 : 0, sws_getCoefficients(target_colorspace), target_full_range ? 1 : 0, 1L << 16 | 0L, 1L << 16 | 0L, 1L << 16 | 0L);
+			this->slices.push_back(band);
+		}
+
+		this->threadpool = ::streamfx::util::threadpool::threadpool::instance();
+	}
+
 	return true;
 }
 
 bool swscale::finalize()
 {
+	for (auto& band : this->slices) {
+		sws_freeContext(band.context);
+	}
+	this->slices.clear();
+	this->threadpool.reset();
+
 	if (this->context) {
 		sws_freeContext(this->context);
 		this->context = nullptr;
@@ -176,11 +262,89 @@ bool swscale::finalize()
 	return false;
 }
 
+std::size_t swscale::get_slice_count()
+{
+	return std::max<std::size_t>(this->slices.size(), 1);
+}
+
+int swscale::get_flags(swscale_quality quality)
+{
+	switch (quality) {
+	case swscale_quality::FAST:
+		return SWS_FAST_BILINEAR;
+	case swscale_quality::BALANCED:
+		return SWS_BICUBIC | SWS_FULL_CHR_H_INT | SWS_ACCURATE_RND;
+	case swscale_quality::QUALITY:
+	default:
+		return SWS_SINC | SWS_FULL_CHR_H_INT | SWS_FULL_CHR_H_INP | SWS_ACCURATE_RND | SWS_BITEXACT;
+	}
+}
+
+void swscale::convert_slices(std::shared_ptr<void> data)
+{
+	auto job    = std::static_pointer_cast<slice_job>(data);
+	auto slices = reinterpret_cast<const swscale::slice*>(job->slices);
+
+	for (std::size_t idx = job->next.fetch_add(1); idx < job->count; idx = job->next.fetch_add(1)) {
+		auto& band = slices[idx];
+
+		const uint8_t* source_data[4];
+		uint8_t*       target_data[4];
+		for (std::size_t plane = 0; plane < 4; plane++) {
+			source_data[plane] = job->source_data[plane] ? job->source_data[plane] + static_cast<ptrdiff_t>(band.row >> job->source_shift[plane]) * job->source_stride[plane] : nullptr;
+			target_data[plane] = job->target_data[plane] ? job->target_data[plane] + static_cast<ptrdiff_t>(band.row >> job->target_shift[plane]) * job->target_stride[plane] : nullptr;
+		}
+
+		int res = sws_scale(band.context, source_data, job->source_stride, 0, band.rows, target_data, job->target_stride);
+		if (res < 0) {
+			job->error = res;
+		} else {
+			job->rows += res;
+		}
+
+		{
+			std::lock_guard<std::mutex> lg(job->lock);
+			job->finished++;
+		}
+		job->finished_cv.notify_all();
+	}
+}
+
 int32_t swscale::convert(const uint8_t* const source_data[], const int source_stride[], int32_t source_row, int32_t source_rows, uint8_t* const target_data[], const int target_stride[])
 {
 	if (!this->context) {
 		return 0;
 	}
-	int height = sws_scale(this->context, source_data, source_stride, source_row, source_rows, target_data, target_stride);
-	return height;
+
+	// Partial conversions and small frames take the single context.
+	if ((this->slices.size() <= 1) || (source_row != 0) || (source_rows != static_cast<int32_t>(source_size.second))) {
+		int height = sws_scale(this->context, source_data, source_stride, source_row, source_rows, target_data, target_stride);
+		return height;
+	}
+
+	auto job = std::make_shared<slice_job>();
+	for (std::size_t plane = 0; plane < 4; plane++) {
+		job->source_data[plane]   = source_data[plane];
+		job->source_stride[plane] = source_stride[plane];
+		job->target_data[plane]   = target_data[plane];
+		job->target_stride[plane] = target_stride[plane];
+	}
+	plane_shifts(source_format, job->source_shift);
+	plane_shifts(target_format, job->target_shift);
+	job->slices = this->slices.data();
+	job->count  = this->slices.size();
+
+	// Let the threadpool help out, while this thread works on whatever bands are left. Tasks which start after all
+	// bands are taken return immediately, so a busy threadpool never delays us beyond doing all the work ourselves.
+	for (std::size_t idx = 1; idx < job->count; idx++) {
+		this->threadpool->push(&swscale::convert_slices, job, ::streamfx::util::threadpool::priority::REALTIME);
+	}
+	convert_slices(job);
+
+	{
+		std::unique_lock<std::mutex> ul(job->lock);
+		job->finished_cv.wait(ul, [&job]() { return job->finished == job->count; });
+	}
+
+	return (job->error != 0) ? job->error.load() : job->rows.load();
 }
@@ -4,9 +4,12 @@
 
 #pragma once
 #include "common.hpp"
+#include "util/util-threadpool.hpp"
 
 #include "warning-disable.hpp"
+#include <memory>
 #include <utility>
+#include <vector>
 #include "warning-enable.hpp"
 
 extern "C" {
@@ -17,6 +20,12 @@ extern "C" {
 }
 
 namespace streamfx::ffmpeg {
+	enum class swscale_quality : int64_t {
+		FAST     = 0,
+		BALANCED = 1,
+		QUALITY  = 2,
+	};
+
 	class swscale {
 		std::pair<uint32_t, uint32_t> source_size;
 		AVPixelFormat                 source_format     = AV_PIX_FMT_NONE;
@@ -30,6 +39,16 @@ namespace streamfx::ffmpeg {
 
 		SwsContext* context = nullptr;
 
+		struct slice {
+			SwsContext* context;
+			int32_t     row;
+			int32_t     rows;
+		};
+		std::vector<slice>                                        slices;
+		std::shared_ptr<::streamfx::util::threadpool::threadpool> threadpool;
+
+		static void convert_slices(std::shared_ptr<void> data);
+
 		public:
 		swscale();
 		~swscale();
@@ -60,9 +79,20 @@ namespace streamfx::ffmpeg {
 		void                          set_target_full_range(bool full_range);
 		bool                          is_target_full_range();
 
-		bool initialize(int flags);
+		/** Create the conversion context.
+		 *
+		 * @param flags SWS_* flags to use for conversion, see get_flags().
+		 * @param slice_count Number of row bands to convert in parallel on the threadpool. 0 picks a count based on the
+		 *                    frame size and available threads. Conversions that scale or resample chroma vertically are
+		 *                    never sliced, as the bands would show seams.
+		 */
+		bool initialize(int flags, std::size_t slice_count = 1);
 		bool finalize();
 
+		std::size_t get_slice_count();
+
+		static int get_flags(swscale_quality quality);
+
 		int32_t convert(const uint8_t* const source_data[], const int source_stride[], int32_t source_row, int32_t source_rows, uint8_t* const target_data[], const int target_stride[]);
 	};
 } // namespace streamfx::ffmpeg
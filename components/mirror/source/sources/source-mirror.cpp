@@ -62,7 +62,10 @@ using namespace streamfx::source::mirror;
 
 static constexpr std::string_view HELP_URL = "https://github.com/Xaymar/obs-StreamFX/wiki/Source-Mirror";
 
-mirror_audio_data::mirror_audio_data(const audio_data* audio, speaker_layout layout)
+// Number of audio packets that may be waiting to be forwarded, roughly 340ms at 48kHz.
+static constexpr size_t audio_queue_size = 16;
+
+void mirror_audio_data::assign(const audio_data* audio, speaker_layout layout)
 {
 	// Build a clone of a packet.
 	audio_t*                 oad = obs_get_audio();
@@ -72,20 +75,23 @@ mirror_audio_data::mirror_audio_data(const audio_data* audio, speaker_layout lay
 	osa.speakers                 = layout;
 	osa.format                   = aoi->format;
 	osa.samples_per_sec          = aoi->samples_per_sec;
-	data.resize(MAX_AV_PLANES);
 	for (std::size_t idx = 0; idx < MAX_AV_PLANES; idx++) {
 		if (!audio->data[idx]) {
 			osa.data[idx] = nullptr;
 			continue;
 		}
 
+		// Storage only ever grows, so after the first few packets this no longer allocates.
 		data[idx].resize(audio->frames * get_audio_bytes_per_channel(osa.format));
 		memcpy(data[idx].data(), audio->data[idx], data[idx].size());
 		osa.data[idx] = data[idx].data();
 	}
+
+	// The packet should be forwarded before the next one arrives.
+	deadline = std::chrono::high_resolution_clock::now() + std::chrono::nanoseconds((static_cast<int64_t>(osa.frames) * 1000000000ll) / osa.samples_per_sec);
 }
 
-mirror_instance::mirror_instance(obs_data_t* settings, obs_source_t* self) : obs::source_instance(settings, self), _source(), _source_child(), _signal_rename(), _audio_enabled(false), _audio_layout(SPEAKERS_UNKNOWN)
+mirror_instance::mirror_instance(obs_data_t* settings, obs_source_t* self) : obs::source_instance(settings, self), _source(), _source_child(), _signal_rename(), _audio_enabled(false), _audio_layout(SPEAKERS_UNKNOWN), _audio_queue(audio_queue_size), _audio_draining(false), _audio_task(), _audio_dropped(0), _audio_late(0)
 {
 	update(settings);
 }
@@ -93,6 +99,15 @@ mirror_instance::mirror_instance(obs_data_t* settings, obs_source_t* self) : obs
 mirror_instance::~mirror_instance()
 {
 	release();
+
+	// A drain may still be in flight, and it needs this instance.
+	if (_audio_task) {
+		_audio_task->wait();
+	}
+
+	if ((_audio_dropped > 0) || (_audio_late > 0)) {
+		D_LOG_WARNING("'%s' dropped %" PRIu64 " and late forwarded %" PRIu64 " audio packets.", obs_source_get_name(_self), _audio_dropped.load(), _audio_late.load());
+	}
 }
 
 uint32_t mirror_instance::get_width()
@@ -253,22 +268,37 @@ void mirror_instance::on_audio(::streamfx::obs::source, const audio_data* audio,
 		}
 	}
 
-	{
-		std::unique_lock<std::mutex> ul(_audio_queue_lock);
-		_audio_queue.emplace(audio, detected_layout);
+	// Create a clone of the audio data, or drop it if the drain can't keep up.
+	auto slot = _audio_queue.back();
+	if (!slot) {
+		_audio_dropped.fetch_add(1, std::memory_order_relaxed);
+		return;
 	}
+	slot->assign(audio, detected_layout);
+	_audio_queue.push();
 
-	// Create a clone of the audio data and push it to the thread pool.
-	streamfx::threadpool()->push(std::bind(&mirror_instance::audio_output, this, std::placeholders::_1), nullptr);
+	// Only push a drain to the thread pool if none is in flight, as a running drain picks up new packets by itself.
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (!_audio_draining.exchange(true)) {
+		_audio_task = streamfx::threadpool()->push(std::bind(&mirror_instance::audio_output, this, std::placeholders::_1), nullptr, streamfx::util::threadpool::priority::REALTIME, slot->deadline);
+	}
 }
 
 void mirror_instance::audio_output(std::shared_ptr<void> data)
 {
-	std::unique_lock<std::mutex> ul(_audio_queue_lock);
-	while (_audio_queue.size() > 0) {
-		obs_source_output_audio(_self, &((_audio_queue.front()).osa));
-		_audio_queue.pop();
-	}
+	do {
+		for (auto slot = _audio_queue.front(); slot != nullptr; slot = _audio_queue.front()) {
+			if (std::chrono::high_resolution_clock::now() > slot->deadline) {
+				_audio_late.fetch_add(1, std::memory_order_relaxed);
+			}
+			obs_source_output_audio(_self, &slot->osa);
+			_audio_queue.pop();
+		}
+
+		// A packet may have been queued after the last check, but before the flag was cleared.
+		_audio_draining.store(false);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+	} while (!_audio_queue.empty() && !_audio_draining.exchange(true));
 }
 
 mirror_factory::mirror_factory()
@@ -394,6 +424,7 @@ std::shared_ptr<mirror_factory> mirror_factory::instance()
 static std::shared_ptr<mirror_factory> loader_instance;
 
 static auto loader = streamfx::loader(
+	"source-mirror",
 	[]() { // Initalizer
 		loader_instance = mirror_factory::instance();
 	},
@@ -12,21 +12,23 @@
 #include "obs/obs-source-factory.hpp"
 #include "obs/obs-source.hpp"
 #include "obs/obs-tools.hpp"
+#include "util/util-ringbuffer.hpp"
 
 #include "warning-disable.hpp"
-#include <condition_variable>
-#include <mutex>
-#include <queue>
-#include <thread>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <vector>
 #include "warning-enable.hpp"
 
 namespace streamfx::source::mirror {
 	struct mirror_audio_data {
-		mirror_audio_data(const audio_data*, speaker_layout);
+		obs_source_audio                                osa;
+		std::array<std::vector<uint8_t>, MAX_AV_PLANES> data;
+		std::chrono::high_resolution_clock::time_point  deadline;
 
-		obs_source_audio                  osa;
-		std::vector<std::vector<uint8_t>> data;
+		// Copy a packet into this slot, reusing the plane storage.
+		void assign(const audio_data*, speaker_layout);
 	};
 
 	class mirror_instance : public obs::source_instance {
@@ -38,10 +40,13 @@ namespace streamfx::source::mirror {
 		std::pair<uint32_t, uint32_t>                         _source_size;
 
 		// Audio
-		bool                          _audio_enabled;
-		speaker_layout                _audio_layout;
-		std::mutex                    _audio_queue_lock;
-		std::queue<mirror_audio_data> _audio_queue;
+		bool                                               _audio_enabled;
+		speaker_layout                                     _audio_layout;
+		streamfx::util::spsc_ringbuffer<mirror_audio_data> _audio_queue;
+		std::atomic<bool>                                  _audio_draining;
+		std::shared_ptr<streamfx::util::threadpool::task>  _audio_task;
+		std::atomic<uint64_t>                              _audio_dropped;
+		std::atomic<uint64_t>                              _audio_late;
 
 		public:
 		mirror_instance(obs_data_t* settings, obs_source_t* self);
@@ -3,6 +3,7 @@
 // AUTOGENERATED COPYRIGHT HEADER END
 
 #include "nvidia/cuda/nvidia-cuda.hpp"
+#include "plugin.hpp"
 #include "util/util-logging.hpp"
 
 #include "warning-disable.hpp"
@@ -254,3 +255,21 @@ std::shared_ptr<streamfx::nvidia::cuda::cuda> streamfx::nvidia::cuda::cuda::get(
 	}
 	return instance.lock();
 }
+
+static std::shared_ptr<streamfx::nvidia::cuda::cuda> loader_instance;
+
+static auto loader = streamfx::loader(
+	"nvidia-cuda",
+	[]() { // Initalizer
+		// Loading the driver and cuInit() can take a while, so get it out of the way while everything else loads.
+		try {
+			loader_instance = streamfx::nvidia::cuda::cuda::get();
+		} catch (const std::exception& ex) {
+			// Not fatal here, whatever needs CUDA will try again and report it.
+			D_LOG_DEBUG("Failed to preload CUDA: %s", ex.what());
+		}
+	},
+	[]() { // Finalizer
+		loader_instance.reset();
+	},
+	streamfx::loader_priority::HIGH, streamfx::loader_flags::ASYNC);
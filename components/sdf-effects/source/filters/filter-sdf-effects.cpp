@@ -4,10 +4,12 @@
 
 #include "filter-sdf-effects.hpp"
 #include "strings.hpp"
+#include "gfx/gfx-sdf-jump-flood.hpp"
 #include "obs/gs/gs-helper.hpp"
 #include "util/util-logging.hpp"
 
 #include "warning-disable.hpp"
+#include <list>
 #include <stdexcept>
 #include "warning-enable.hpp"
 
@@ -97,12 +99,87 @@
 #define ST_KEY_SDF_SCALE "Filter.SDFEffects.SDF.Scale"
 #define ST_I18N_SDF_THRESHOLD "Filter.SDFEffects.SDF.Threshold"
 #define ST_KEY_SDF_THRESHOLD "Filter.SDFEffects.SDF.Threshold"
+#define ST_I18N_SDF_MODE "Filter.SDFEffects.SDF.Mode"
+#define ST_KEY_SDF_MODE "Filter.SDFEffects.SDF.Mode"
+#define ST_I18N_SDF_MODE_PROGRESSIVE "Filter.SDFEffects.SDF.Mode.Progressive"
+#define ST_I18N_SDF_MODE_JUMPFLOODING "Filter.SDFEffects.SDF.Mode.JumpFlooding"
+#define ST_I18N_SDF_PRECISION "Filter.SDFEffects.SDF.Precision"
+#define ST_KEY_SDF_PRECISION "Filter.SDFEffects.SDF.Precision"
+#define ST_I18N_SDF_PRECISION_FULL "Filter.SDFEffects.SDF.Precision.Full"
+#define ST_I18N_SDF_PRECISION_HALF "Filter.SDFEffects.SDF.Precision.Half"
+#define ST_I18N_SDF_REBUILD "Filter.SDFEffects.SDF.Rebuild"
+#define ST_KEY_SDF_REBUILD "Filter.SDFEffects.SDF.Rebuild"
+#define ST_I18N_SDF_REBUILD_ALWAYS "Filter.SDFEffects.SDF.Rebuild.Always"
+#define ST_I18N_SDF_REBUILD_AUTOMATIC "Filter.SDFEffects.SDF.Rebuild.Automatic"
+#define ST_I18N_SDF_REBUILD_STATIC "Filter.SDFEffects.SDF.Rebuild.Static"
+
+// sdf-producer.effect stores distances divided by this, everything else stores them in texels.
+#define ST_PROGRESSIVE_DISTANCE 65536.0f
 
 using namespace streamfx::filter::sdf_effects;
 
 static constexpr std::string_view HELP_URL = "https://github.com/Xaymar/obs-StreamFX/wiki/Filter-SDF-Effects";
 
-sdf_effects_instance::sdf_effects_instance(obs_data_t* settings, obs_source_t* self) : obs::source_instance(settings, self), _gfx_util(::streamfx::gfx::util::get()), _source_rendered(false), _sdf_scale(1.0), _sdf_threshold(), _output_rendered(false), _inner_shadow(false), _inner_shadow_color(), _inner_shadow_range_min(), _inner_shadow_range_max(), _inner_shadow_offset_x(), _inner_shadow_offset_y(), _outer_shadow(false), _outer_shadow_color(), _outer_shadow_range_min(), _outer_shadow_range_max(), _outer_shadow_offset_x(), _outer_shadow_offset_y(), _inner_glow(false), _inner_glow_color(), _inner_glow_width(), _inner_glow_sharpness(), _inner_glow_sharpness_inv(), _outer_glow(false), _outer_glow_color(), _outer_glow_width(), _outer_glow_sharpness(), _outer_glow_sharpness_inv(), _outline(false), _outline_color(), _outline_width(), _outline_offset(), _outline_sharpness(), _outline_sharpness_inv()
+// Parameters of sdf-producer.effect, same order as producer_param_names.
+enum class producer_param : std::size_t {
+	Image,
+	Size,
+	SDF,
+	Threshold,
+};
+static constexpr std::array<const char*, 4> producer_param_names = {"_image", "_size", "_sdf", "_threshold"};
+
+// Parameters of sdf-jfa.effect, same order as jfa_param_names.
+enum class jfa_param : std::size_t {
+	Image,
+	Threshold,
+	Seeds,
+	Size,
+	Step,
+};
+static constexpr std::array<const char*, 5> jfa_param_names = {"pImage", "pThreshold", "pSeeds", "pSize", "pStep"};
+
+// Parameters of sdf-consumer.effect, same order as consumer_param_names.
+enum class consumer_param : std::size_t {
+	SDFTexture,
+	SDFThreshold,
+	SDFMultiplier,
+	ImageTexture,
+	ShadowOuterColor,
+	ShadowOuterMin,
+	ShadowOuterMax,
+	ShadowOuterOffset,
+	ShadowInnerColor,
+	ShadowInnerMin,
+	ShadowInnerMax,
+	ShadowInnerOffset,
+	GlowOuterColor,
+	GlowOuterWidth,
+	GlowOuterSharpness,
+	GlowOuterSharpnessInverse,
+	GlowInnerColor,
+	GlowInnerWidth,
+	GlowInnerSharpness,
+	GlowInnerSharpnessInverse,
+	OutlineColor,
+	OutlineWidth,
+	OutlineOffset,
+	OutlineSharpness,
+	OutlineSharpnessInverse,
+};
+static constexpr std::array<const char*, 25> consumer_param_names = {"pSDFTexture", "pSDFThreshold", "pSDFMultiplier", "pImageTexture", "pShadowOuterColor", "pShadowOuterMin", "pShadowOuterMax", "pShadowOuterOffset", "pShadowInnerColor", "pShadowInnerMin", "pShadowInnerMax", "pShadowInnerOffset", "pGlowOuterColor", "pGlowOuterWidth", "pGlowOuterSharpness", "pGlowOuterSharpnessInverse", "pGlowInnerColor", "pGlowInnerWidth", "pGlowInnerSharpness", "pGlowInnerSharpnessInverse", "pOutlineColor", "pOutlineWidth", "pOutlineOffset", "pOutlineSharpness", "pOutlineSharpnessInverse"};
+
+// Effects drawn by a permutation of sdf-consumer.effect, one bit each, same order as consumer_variant_defines.
+enum consumer_variant : uint32_t {
+	ShadowOuter = 1 << 0,
+	ShadowInner = 1 << 1,
+	GlowOuter   = 1 << 2,
+	GlowInner   = 1 << 3,
+	Outline     = 1 << 4,
+};
+static constexpr std::array<const char*, 5> consumer_variant_defines = {"SHADOW_OUTER", "SHADOW_INNER", "GLOW_OUTER", "GLOW_INNER", "OUTLINE"};
+
+sdf_effects_instance::sdf_effects_instance(obs_data_t* settings, obs_source_t* self) : obs::source_instance(settings, self), _sdf_consumer_variant(0), _gfx_util(::streamfx::gfx::util::get()), _rt_pool(::streamfx::gfx::rendertarget_pool::get()), _source_rendered(false), _sdf_scale(1.0), _sdf_threshold(), _sdf_mode(sdf_mode::JumpFlooding), _sdf_built_mode(sdf_mode::Progressive), _sdf_precision(sdf_precision::Half), _sdf_rebuild(sdf_rebuild::Always), _sdf_input(self), _sdf_dirty(true), _sdf_signature(0), _output_rendered(false), _inner_shadow(false), _inner_shadow_color(), _inner_shadow_range_min(), _inner_shadow_range_max(), _inner_shadow_offset_x(), _inner_shadow_offset_y(), _outer_shadow(false), _outer_shadow_color(), _outer_shadow_range_min(), _outer_shadow_range_max(), _outer_shadow_offset_x(), _outer_shadow_offset_y(), _inner_glow(false), _inner_glow_color(), _inner_glow_width(), _inner_glow_sharpness(), _inner_glow_sharpness_inv(), _outer_glow(false), _outer_glow_color(), _outer_glow_width(), _outer_glow_sharpness(), _outer_glow_sharpness_inv(), _outline(false), _outline_color(), _outline_width(), _outline_offset(), _outline_sharpness(), _outline_sharpness_inv()
 {
 	{
 		auto gctx        = streamfx::obs::gs::context();
@@ -121,7 +198,7 @@ sdf_effects_instance::sdf_effects_instance(obs_data_t* settings, obs_source_t* s
 
 		std::pair<const char*, streamfx::obs::gs::effect&> load_arr[] = {
 			{"effects/sdf/sdf-producer.effect", _sdf_producer_effect},
-			{"effects/sdf/sdf-consumer.effect", _sdf_consumer_effect},
+			{"effects/sdf/sdf-jfa.effect", _sdf_jfa_effect},
 		};
 		for (auto& kv : load_arr) {
 			auto file = streamfx::data_file_path(kv.first);
@@ -132,6 +209,8 @@ sdf_effects_instance::sdf_effects_instance(obs_data_t* settings, obs_source_t* s
 				throw;
 			}
 		}
+		_sdf_producer_params.bind(_sdf_producer_effect, producer_param_names);
+		_sdf_jfa_params.bind(_sdf_jfa_effect, jfa_param_names);
 	}
 
 	update(settings);
@@ -272,24 +351,71 @@ void sdf_effects_instance::update(obs_data_t* data)
 
 	_sdf_scale     = double_t(obs_data_get_double(data, ST_KEY_SDF_SCALE) / 100.0);
 	_sdf_threshold = float(obs_data_get_double(data, ST_KEY_SDF_THRESHOLD) / 100.0);
+	_sdf_mode      = static_cast<sdf_mode>(obs_data_get_int(data, ST_KEY_SDF_MODE));
+	_sdf_precision = static_cast<sdf_precision>(obs_data_get_int(data, ST_KEY_SDF_PRECISION));
+	_sdf_rebuild   = static_cast<sdf_rebuild>(obs_data_get_int(data, ST_KEY_SDF_REBUILD));
+	_sdf_input.invalidate();
 }
 
 void sdf_effects_instance::video_tick(float)
 {
+	{ // Pick the permutation of the consumer ahead of rendering, so that only the first use of each one compiles it.
+		// SDF Effects Stack:
+		//   Normal Source
+		//   Outer Shadow
+		//   Inner Shadow
+		//   Outer Glow
+		//   Inner Glow
+		//   Outline
+		uint32_t variant = 0;
+		variant |= _outer_shadow ? uint32_t(consumer_variant::ShadowOuter) : 0u;
+		variant |= _inner_shadow ? uint32_t(consumer_variant::ShadowInner) : 0u;
+		variant |= _outer_glow ? uint32_t(consumer_variant::GlowOuter) : 0u;
+		variant |= _inner_glow ? uint32_t(consumer_variant::GlowInner) : 0u;
+		variant |= _outline ? uint32_t(consumer_variant::Outline) : 0u;
+
+		if (variant != _sdf_consumer_variant) {
+			_sdf_consumer_effect = {};
+			_sdf_consumer_params.reset();
+			if (variant != 0) {
+				_sdf_consumer_effect = sdf_effects_factory::instance()->get_consumer_effect(variant);
+				if (_sdf_consumer_effect) {
+					_sdf_consumer_params.bind(_sdf_consumer_effect, consumer_param_names);
+				}
+			}
+			_sdf_consumer_variant = variant;
+		}
+	}
+
 	if (obs_source_t* target = obs_filter_get_target(_self); target != nullptr) {
-		_source_rendered = false;
-		_output_rendered = false;
+		// A complete distance field stays valid for as long as the input does not change. The progressive one is never
+		// complete, so it always has to continue.
+		bool reuse = false;
+		if ((_sdf_mode == sdf_mode::JumpFlooding) && (_sdf_rebuild != sdf_rebuild::Always)) {
+			uint64_t signature = 0;
+			bool     dirty     = _sdf_dirty.exchange(false);
+			if (_sdf_input.signature(_sdf_rebuild == sdf_rebuild::Automatic, signature)) {
+				reuse          = !dirty && (signature == _sdf_signature);
+				_sdf_signature = signature;
+			} else {
+				_sdf_dirty = true;
+			}
+		}
+
+		if (!reuse) {
+			_source_rendered = false;
+			_output_rendered = false;
+		}
 	}
 }
 
 void sdf_effects_instance::video_render(gs_effect_t* effect)
 {
-	obs_source_t* parent         = obs_filter_get_parent(_self);
-	obs_source_t* target         = obs_filter_get_target(_self);
-	uint32_t      baseW          = obs_source_get_base_width(target);
-	uint32_t      baseH          = obs_source_get_base_height(target);
-	gs_effect_t*  final_effect   = effect ? effect : obs_get_base_effect(obs_base_effect::OBS_EFFECT_DEFAULT);
-	gs_effect_t*  default_effect = obs_get_base_effect(obs_base_effect::OBS_EFFECT_DEFAULT);
+	obs_source_t* parent       = obs_filter_get_parent(_self);
+	obs_source_t* target       = obs_filter_get_target(_self);
+	uint32_t      baseW        = obs_source_get_base_width(target);
+	uint32_t      baseH        = obs_source_get_base_height(target);
+	gs_effect_t*  final_effect = effect ? effect : obs_get_base_effect(obs_base_effect::OBS_EFFECT_DEFAULT);
 
 	if (!_self || !parent || !target || !baseW || !baseH || !final_effect) {
 		obs_source_skip_video_filter(_self);
@@ -342,15 +468,6 @@ void sdf_effects_instance::video_render(gs_effect_t* effect)
 
 			// Generate SDF Buffers
 			{
-				_sdf_read->get_texture(_sdf_texture);
-				if (!_sdf_texture) {
-					throw std::runtime_error("SDF Backbuffer empty");
-				}
-
-				if (!_sdf_producer_effect) {
-					throw std::runtime_error("SDF Effect no loaded");
-				}
-
 				// Scale SDF Size
 				double_t sdfW, sdfH;
 				sdfW = baseW * _sdf_scale;
@@ -362,26 +479,34 @@ void sdf_effects_instance::video_render(gs_effect_t* effect)
 					sdfH = 1.0;
 				}
 
+				// Start over if the generator or its precision changed, as the buffers hold something else entirely then.
+				bool            half         = (_sdf_mode == sdf_mode::JumpFlooding) && (_sdf_precision == sdf_precision::Half);
+				gs_color_format seed_format  = half ? GS_RGBA16 : GS_RGBA32F;
+				gs_color_format field_format = half ? GS_RG16F : GS_RG32F;
+				if ((_sdf_built_mode != _sdf_mode) || (_sdf_write->get_color_format() != seed_format)) {
+					_sdf_write = std::make_shared<streamfx::obs::gs::rendertarget>(seed_format, GS_ZS_NONE);
+					_sdf_read  = std::make_shared<streamfx::obs::gs::rendertarget>(seed_format, GS_ZS_NONE);
+					{
+						auto op = _sdf_read->render(1, 1);
+						gs_clear(GS_CLEAR_COLOR | GS_CLEAR_DEPTH, &color_transparent, 0, 0);
+					}
+					_sdf_built_mode = _sdf_mode;
+				}
+				if ((_sdf_mode == sdf_mode::JumpFlooding) && (!_sdf_field || (_sdf_field->get_color_format() != field_format))) {
+					_sdf_field = std::make_shared<streamfx::obs::gs::rendertarget>(field_format, GS_ZS_NONE);
+				}
+
 				{
 #if defined(ENABLE_PROFILING) && !defined(D_PLATFORM_MAC) && _DEBUG
 					streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_convert, "Update Distance Field"};
 #endif
 
-					auto op = _sdf_write->render(uint32_t(sdfW), uint32_t(sdfH));
-					gs_ortho(0, 1, 0, 1, -1, 1);
-					gs_clear(GS_CLEAR_COLOR | GS_CLEAR_DEPTH, &color_transparent, 0, 0);
-
-					_sdf_producer_effect.get_parameter("_image").set_texture(_source_texture);
-					_sdf_producer_effect.get_parameter("_size").set_float2(float(sdfW), float(sdfH));
-					_sdf_producer_effect.get_parameter("_sdf").set_texture(_sdf_texture);
-					_sdf_producer_effect.get_parameter("_threshold").set_float(_sdf_threshold);
-
-					while (gs_effect_loop(_sdf_producer_effect.get_object(), "Draw")) {
-						_gfx_util->draw_fullscreen_triangle();
+					if (_sdf_mode == sdf_mode::JumpFlooding) {
+						generate_jump_flood(uint32_t(sdfW), uint32_t(sdfH));
+					} else {
+						generate_progressive(uint32_t(sdfW), uint32_t(sdfH));
 					}
 				}
-				std::swap(_sdf_read, _sdf_write);
-				_sdf_read->get_texture(_sdf_texture);
 				if (!_sdf_texture) {
 					throw std::runtime_error("SDF Backbuffer empty");
 				}
@@ -400,113 +525,76 @@ void sdf_effects_instance::video_render(gs_effect_t* effect)
 	if (!_output_rendered) {
 		_output_texture = _source_texture;
 
-		if (!_sdf_consumer_effect) {
-			obs_source_skip_video_filter(_self);
-			return;
-		}
-
-		gs_blend_state_push();
-		gs_reset_blend_state();
-		gs_enable_color(true, true, true, true);
-		gs_enable_depth_test(false);
-		gs_set_cull_mode(GS_NEITHER);
+		if (_sdf_consumer_variant != 0) {
+			if (!_sdf_consumer_effect) {
+				obs_source_skip_video_filter(_self);
+				return;
+			}
 
-		// SDF Effects Stack:
-		//   Normal Source
-		//   Outer Shadow
-		//   Inner Shadow
-		//   Outer Glow
-		//   Inner Glow
-		//   Outline
+			gs_blend_state_push();
+			gs_reset_blend_state();
+			gs_enable_color(true, true, true, true);
+			gs_enable_depth_test(false);
+			gs_set_cull_mode(GS_NEITHER);
+			gs_enable_blending(false);
+			gs_blend_function(GS_BLEND_ONE, GS_BLEND_ZERO);
 
-		// Optimized Render path.
-		try {
+			try {
 #if defined(ENABLE_PROFILING) && !defined(D_PLATFORM_MAC) && _DEBUG
-			streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_convert, "Calculate"};
+				streamfx::obs::gs::debug_marker gdm{streamfx::obs::gs::debug_color_convert, "Calculate"};
 #endif
 
-			auto op = _output_rt->render(baseW, baseH);
-			gs_ortho(0, 1, 0, 1, 0, 1);
+				auto op = _output_rt->render(baseW, baseH);
+				gs_ortho(0, 1, 0, 1, 0, 1);
 
-			gs_enable_blending(false);
-			gs_blend_function(GS_BLEND_ONE, GS_BLEND_ZERO);
-			auto param = gs_effect_get_param_by_name(default_effect, "image");
-			if (param) {
-				gs_effect_set_texture(param, _output_texture->get_object());
-			}
-			while (gs_effect_loop(default_effect, "Draw")) {
-				_gfx_util->draw_fullscreen_triangle();
-			}
+				float sdf_multiplier = (_sdf_built_mode == sdf_mode::Progressive) ? ST_PROGRESSIVE_DISTANCE : 1.0f;
 
-			gs_enable_blending(true);
-			gs_blend_function_separate(GS_BLEND_SRCALPHA, GS_BLEND_INVSRCALPHA, GS_BLEND_ONE, GS_BLEND_ONE);
-			if (_outer_shadow) {
-				_sdf_consumer_effect.get_parameter("pSDFTexture").set_texture(_sdf_texture);
-				_sdf_consumer_effect.get_parameter("pSDFThreshold").set_float(_sdf_threshold);
-				_sdf_consumer_effect.get_parameter("pImageTexture").set_texture(_source_texture->get_object());
-				_sdf_consumer_effect.get_parameter("pShadowColor").set_float4(_outer_shadow_color);
-				_sdf_consumer_effect.get_parameter("pShadowMin").set_float(_outer_shadow_range_min);
-				_sdf_consumer_effect.get_parameter("pShadowMax").set_float(_outer_shadow_range_max);
-				_sdf_consumer_effect.get_parameter("pShadowOffset").set_float2(_outer_shadow_offset_x / float(baseW), _outer_shadow_offset_y / float(baseH));
-				while (gs_effect_loop(_sdf_consumer_effect.get_object(), "ShadowOuter")) {
-					_gfx_util->draw_fullscreen_triangle();
+				_sdf_consumer_params[consumer_param::SDFTexture].set_texture(_sdf_texture);
+				_sdf_consumer_params[consumer_param::SDFThreshold].set_float(_sdf_threshold);
+				_sdf_consumer_params[consumer_param::SDFMultiplier].set_float(sdf_multiplier);
+				_sdf_consumer_params[consumer_param::ImageTexture].set_texture(_source_texture->get_object());
+				if (_outer_shadow) {
+					_sdf_consumer_params[consumer_param::ShadowOuterColor].set_float4(_outer_shadow_color);
+					_sdf_consumer_params[consumer_param::ShadowOuterMin].set_float(_outer_shadow_range_min);
+					_sdf_consumer_params[consumer_param::ShadowOuterMax].set_float(_outer_shadow_range_max);
+					_sdf_consumer_params[consumer_param::ShadowOuterOffset].set_float2(_outer_shadow_offset_x / float(baseW), _outer_shadow_offset_y / float(baseH));
 				}
-			}
-			if (_inner_shadow) {
-				_sdf_consumer_effect.get_parameter("pSDFTexture").set_texture(_sdf_texture);
-				_sdf_consumer_effect.get_parameter("pSDFThreshold").set_float(_sdf_threshold);
-				_sdf_consumer_effect.get_parameter("pImageTexture").set_texture(_source_texture->get_object());
-				_sdf_consumer_effect.get_parameter("pShadowColor").set_float4(_inner_shadow_color);
-				_sdf_consumer_effect.get_parameter("pShadowMin").set_float(_inner_shadow_range_min);
-				_sdf_consumer_effect.get_parameter("pShadowMax").set_float(_inner_shadow_range_max);
-				_sdf_consumer_effect.get_parameter("pShadowOffset").set_float2(_inner_shadow_offset_x / float(baseW), _inner_shadow_offset_y / float(baseH));
-				while (gs_effect_loop(_sdf_consumer_effect.get_object(), "ShadowInner")) {
-					_gfx_util->draw_fullscreen_triangle();
+				if (_inner_shadow) {
+					_sdf_consumer_params[consumer_param::ShadowInnerColor].set_float4(_inner_shadow_color);
+					_sdf_consumer_params[consumer_param::ShadowInnerMin].set_float(_inner_shadow_range_min);
+					_sdf_consumer_params[consumer_param::ShadowInnerMax].set_float(_inner_shadow_range_max);
+					_sdf_consumer_params[consumer_param::ShadowInnerOffset].set_float2(_inner_shadow_offset_x / float(baseW), _inner_shadow_offset_y / float(baseH));
 				}
-			}
-			if (_outer_glow) {
-				_sdf_consumer_effect.get_parameter("pSDFTexture").set_texture(_sdf_texture);
-				_sdf_consumer_effect.get_parameter("pSDFThreshold").set_float(_sdf_threshold);
-				_sdf_consumer_effect.get_parameter("pImageTexture").set_texture(_source_texture->get_object());
-				_sdf_consumer_effect.get_parameter("pGlowColor").set_float4(_outer_glow_color);
-				_sdf_consumer_effect.get_parameter("pGlowWidth").set_float(_outer_glow_width);
-				_sdf_consumer_effect.get_parameter("pGlowSharpness").set_float(_outer_glow_sharpness);
-				_sdf_consumer_effect.get_parameter("pGlowSharpnessInverse").set_float(_outer_glow_sharpness_inv);
-				while (gs_effect_loop(_sdf_consumer_effect.get_object(), "GlowOuter")) {
-					_gfx_util->draw_fullscreen_triangle();
+				if (_outer_glow) {
+					_sdf_consumer_params[consumer_param::GlowOuterColor].set_float4(_outer_glow_color);
+					_sdf_consumer_params[consumer_param::GlowOuterWidth].set_float(_outer_glow_width);
+					_sdf_consumer_params[consumer_param::GlowOuterSharpness].set_float(_outer_glow_sharpness);
+					_sdf_consumer_params[consumer_param::GlowOuterSharpnessInverse].set_float(_outer_glow_sharpness_inv);
 				}
-			}
-			if (_inner_glow) {
-				_sdf_consumer_effect.get_parameter("pSDFTexture").set_texture(_sdf_texture);
-				_sdf_consumer_effect.get_parameter("pSDFThreshold").set_float(_sdf_threshold);
-				_sdf_consumer_effect.get_parameter("pImageTexture").set_texture(_source_texture->get_object());
-				_sdf_consumer_effect.get_parameter("pGlowColor").set_float4(_inner_glow_color);
-				_sdf_consumer_effect.get_parameter("pGlowWidth").set_float(_inner_glow_width);
-				_sdf_consumer_effect.get_parameter("pGlowSharpness").set_float(_inner_glow_sharpness);
-				_sdf_consumer_effect.get_parameter("pGlowSharpnessInverse").set_float(_inner_glow_sharpness_inv);
-				while (gs_effect_loop(_sdf_consumer_effect.get_object(), "GlowInner")) {
-					_gfx_util->draw_fullscreen_triangle();
+				if (_inner_glow) {
+					_sdf_consumer_params[consumer_param::GlowInnerColor].set_float4(_inner_glow_color);
+					_sdf_consumer_params[consumer_param::GlowInnerWidth].set_float(_inner_glow_width);
+					_sdf_consumer_params[consumer_param::GlowInnerSharpness].set_float(_inner_glow_sharpness);
+					_sdf_consumer_params[consumer_param::GlowInnerSharpnessInverse].set_float(_inner_glow_sharpness_inv);
 				}
-			}
-			if (_outline) {
-				_sdf_consumer_effect.get_parameter("pSDFTexture").set_texture(_sdf_texture);
-				_sdf_consumer_effect.get_parameter("pSDFThreshold").set_float(_sdf_threshold);
-				_sdf_consumer_effect.get_parameter("pImageTexture").set_texture(_source_texture->get_object());
-				_sdf_consumer_effect.get_parameter("pOutlineColor").set_float4(_outline_color);
-				_sdf_consumer_effect.get_parameter("pOutlineWidth").set_float(_outline_width);
-				_sdf_consumer_effect.get_parameter("pOutlineOffset").set_float(_outline_offset);
-				_sdf_consumer_effect.get_parameter("pOutlineSharpness").set_float(_outline_sharpness);
-				_sdf_consumer_effect.get_parameter("pOutlineSharpnessInverse").set_float(_outline_sharpness_inv);
-				while (gs_effect_loop(_sdf_consumer_effect.get_object(), "Outline")) {
+				if (_outline) {
+					_sdf_consumer_params[consumer_param::OutlineColor].set_float4(_outline_color);
+					_sdf_consumer_params[consumer_param::OutlineWidth].set_float(_outline_width);
+					_sdf_consumer_params[consumer_param::OutlineOffset].set_float(_outline_offset);
+					_sdf_consumer_params[consumer_param::OutlineSharpness].set_float(_outline_sharpness);
+					_sdf_consumer_params[consumer_param::OutlineSharpnessInverse].set_float(_outline_sharpness_inv);
+				}
+				while (gs_effect_loop(_sdf_consumer_effect.get_object(), "Draw")) {
 					_gfx_util->draw_fullscreen_triangle();
 				}
+			} catch (...) {
 			}
-		} catch (...) {
-		}
 
-		_output_rt->get_texture(_output_texture);
+			_output_rt->get_texture(_output_texture);
+
+			gs_blend_state_pop();
+		}
 
-		gs_blend_state_pop();
 		_output_rendered = true;
 	}
 
@@ -530,6 +618,76 @@ void sdf_effects_instance::video_render(gs_effect_t* effect)
 	}
 }
 
+void sdf_effects_instance::generate_progressive(uint32_t width, uint32_t height)
+{
+	if (!_sdf_producer_effect) {
+		throw std::runtime_error("SDF Effect no loaded");
+	}
+
+	_sdf_read->get_texture(_sdf_texture);
+	if (!_sdf_texture) {
+		throw std::runtime_error("SDF Backbuffer empty");
+	}
+
+	{
+		vec4 color_transparent = {0, 0, 0, 0};
+		auto op                = _sdf_write->render(width, height);
+		gs_ortho(0, 1, 0, 1, -1, 1);
+		gs_clear(GS_CLEAR_COLOR | GS_CLEAR_DEPTH, &color_transparent, 0, 0);
+
+		_sdf_producer_params[producer_param::Image].set_texture(_source_texture);
+		_sdf_producer_params[producer_param::Size].set_float2(float(width), float(height));
+		_sdf_producer_params[producer_param::SDF].set_texture(_sdf_texture);
+		_sdf_producer_params[producer_param::Threshold].set_float(_sdf_threshold);
+
+		while (gs_effect_loop(_sdf_producer_effect.get_object(), "Draw")) {
+			_gfx_util->draw_fullscreen_triangle();
+		}
+	}
+	std::swap(_sdf_read, _sdf_write);
+	_sdf_read->get_texture(_sdf_texture);
+}
+
+void sdf_effects_instance::generate_jump_flood(uint32_t width, uint32_t height)
+{
+	if (!_sdf_jfa_effect) {
+		throw std::runtime_error("SDF Effect no loaded");
+	}
+
+	_sdf_jfa_params[jfa_param::Image].set_texture(_source_texture);
+	_sdf_jfa_params[jfa_param::Threshold].set_float(_sdf_threshold);
+	_sdf_jfa_params[jfa_param::Size].set_float2(float(width), float(height));
+
+	// The seeds are only needed while flooding, so they are borrowed instead of being kept around like the field.
+	auto seed_format = _sdf_write->get_color_format();
+	auto read        = _rt_pool->acquire(seed_format, width, height);
+	auto write       = _rt_pool->acquire(seed_format, width, height);
+
+	auto draw = [this, width, height](std::shared_ptr<streamfx::obs::gs::rendertarget>& rt, const char* technique) {
+		auto op = rt->render(width, height);
+		gs_ortho(0, 1, 0, 1, -1, 1);
+		while (gs_effect_loop(_sdf_jfa_effect.get_object(), technique)) {
+			_gfx_util->draw_fullscreen_triangle();
+		}
+	};
+
+	draw(write, "Seed");
+	std::swap(read, write);
+
+	for (uint32_t pass = 0, passes = streamfx::gfx::sdf::jump_flood_passes(width, height); pass < passes; pass++) {
+		read->get_texture(_sdf_texture);
+		_sdf_jfa_params[jfa_param::Seeds].set_texture(_sdf_texture);
+		_sdf_jfa_params[jfa_param::Step].set_float(float(streamfx::gfx::sdf::jump_flood_step(width, height, pass)));
+		draw(write, "Flood");
+		std::swap(read, write);
+	}
+
+	read->get_texture(_sdf_texture);
+	_sdf_jfa_params[jfa_param::Seeds].set_texture(_sdf_texture);
+	draw(_sdf_field, "Resolve");
+	_sdf_field->get_texture(_sdf_texture);
+}
+
 sdf_effects_factory::sdf_effects_factory()
 {
 	_info.id           = S_PREFIX "filter-sdf-effects";
@@ -543,6 +701,31 @@ sdf_effects_factory::sdf_effects_factory()
 
 sdf_effects_factory::~sdf_effects_factory() {}
 
+streamfx::obs::gs::effect sdf_effects_factory::get_consumer_effect(uint32_t variant)
+{
+	std::lock_guard<std::mutex> lg(_consumer_lock);
+
+	// libobs keeps every effect compiled from a file until it shuts down, so each permutation is only compiled once and
+	// then kept around, instead of compiling it again whenever it comes back into use.
+	auto& effect = _consumer_effects.at(variant);
+	if (!effect) {
+		std::list<std::string> defines;
+		for (std::size_t idx = 0; idx < consumer_variant_defines.size(); idx++) {
+			if (variant & (1u << idx)) {
+				defines.emplace_back(consumer_variant_defines[idx]);
+			}
+		}
+
+		auto file = streamfx::data_file_path("effects/sdf/sdf-consumer.effect");
+		try {
+			effect = streamfx::obs::gs::effect::create(file, defines);
+		} catch (std::exception& ex) {
+			D_LOG_ERROR("Error loading '%s': %s", file.u8string().c_str(), ex.what());
+		}
+	}
+	return effect;
+}
+
 const char* sdf_effects_factory::get_name()
 {
 	return D_TRANSLATE(ST_I18N);
@@ -587,6 +770,9 @@ void sdf_effects_factory::get_defaults2(obs_data_t* data)
 
 	obs_data_set_default_double(data, ST_KEY_SDF_SCALE, 100.0);
 	obs_data_set_default_double(data, ST_KEY_SDF_THRESHOLD, 50.0);
+	obs_data_set_default_int(data, ST_KEY_SDF_MODE, static_cast<int64_t>(sdf_mode::JumpFlooding));
+	obs_data_set_default_int(data, ST_KEY_SDF_PRECISION, static_cast<int64_t>(sdf_precision::Half));
+	obs_data_set_default_int(data, ST_KEY_SDF_REBUILD, static_cast<int64_t>(sdf_rebuild::Always));
 }
 
 obs_properties_t* sdf_effects_factory::get_properties2(sdf_effects_instance* data)
@@ -662,6 +848,20 @@ obs_properties_t* sdf_effects_factory::get_properties2(sdf_effects_instance* dat
 
 		obs_properties_add_float_slider(pr, ST_KEY_SDF_SCALE, D_TRANSLATE(ST_I18N_SDF_SCALE), 0.1, 500.0, 0.1);
 		obs_properties_add_float_slider(pr, ST_KEY_SDF_THRESHOLD, D_TRANSLATE(ST_I18N_SDF_THRESHOLD), 0.0, 100.0, 0.01);
+
+		p = obs_properties_add_list(pr, ST_KEY_SDF_MODE, D_TRANSLATE(ST_I18N_SDF_MODE), OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_INT);
+		obs_property_list_add_int(p, D_TRANSLATE(ST_I18N_SDF_MODE_PROGRESSIVE), static_cast<int64_t>(sdf_mode::Progressive));
+		obs_property_list_add_int(p, D_TRANSLATE(ST_I18N_SDF_MODE_JUMPFLOODING), static_cast<int64_t>(sdf_mode::JumpFlooding));
+		obs_property_set_modified_callback2(p, on_mode_modified, nullptr);
+
+		p = obs_properties_add_list(pr, ST_KEY_SDF_PRECISION, D_TRANSLATE(ST_I18N_SDF_PRECISION), OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_INT);
+		obs_property_list_add_int(p, D_TRANSLATE(ST_I18N_SDF_PRECISION_FULL), static_cast<int64_t>(sdf_precision::Full));
+		obs_property_list_add_int(p, D_TRANSLATE(ST_I18N_SDF_PRECISION_HALF), static_cast<int64_t>(sdf_precision::Half));
+
+		p = obs_properties_add_list(pr, ST_KEY_SDF_REBUILD, D_TRANSLATE(ST_I18N_SDF_REBUILD), OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_INT);
+		obs_property_list_add_int(p, D_TRANSLATE(ST_I18N_SDF_REBUILD_ALWAYS), static_cast<int64_t>(sdf_rebuild::Always));
+		obs_property_list_add_int(p, D_TRANSLATE(ST_I18N_SDF_REBUILD_AUTOMATIC), static_cast<int64_t>(sdf_rebuild::Automatic));
+		obs_property_list_add_int(p, D_TRANSLATE(ST_I18N_SDF_REBUILD_STATIC), static_cast<int64_t>(sdf_rebuild::Static));
 	}
 
 	return prs;
@@ -681,6 +881,15 @@ bool sdf_effects_factory::on_manual_open(obs_properties_t* props, obs_property_t
 	}
 }
 
+bool sdf_effects_factory::on_mode_modified(void* priv, obs_properties_t* props, obs_property_t* property, obs_data_t* settings)
+{
+	// Only the jump flooding generator finishes within a frame, so only it can be stored differently or kept around.
+	bool jump_flooding = static_cast<sdf_mode>(obs_data_get_int(settings, ST_KEY_SDF_MODE)) == sdf_mode::JumpFlooding;
+	obs_property_set_visible(obs_properties_get(props, ST_KEY_SDF_PRECISION), jump_flooding);
+	obs_property_set_visible(obs_properties_get(props, ST_KEY_SDF_REBUILD), jump_flooding);
+	return true;
+}
+
 std::shared_ptr<sdf_effects_factory> sdf_effects_factory::instance()
 {
 	static std::weak_ptr<sdf_effects_factory> winst;
@@ -698,6 +907,7 @@ std::shared_ptr<sdf_effects_factory> sdf_effects_factory::instance()
 static std::shared_ptr<sdf_effects_factory> loader_instance;
 
 static auto loader = streamfx::loader(
+	"filter-sdf-effects",
 	[]() { // Initalizer
 		loader_instance = sdf_effects_factory::instance();
 	},
@@ -4,19 +4,49 @@
 
 #pragma once
 #include "common.hpp"
+#include "gfx/gfx-rendertarget-pool.hpp"
 #include "gfx/gfx-util.hpp"
 #include "obs/gs/gs-effect.hpp"
 #include "obs/gs/gs-rendertarget.hpp"
 #include "obs/gs/gs-sampler.hpp"
 #include "obs/gs/gs-texture.hpp"
 #include "obs/gs/gs-vertexbuffer.hpp"
+#include "obs/obs-filter-input-tracker.hpp"
 #include "obs/obs-source-factory.hpp"
 
+#include "warning-disable.hpp"
+#include <array>
+#include <atomic>
+#include <mutex>
+#include "warning-enable.hpp"
+
 namespace streamfx::filter::sdf_effects {
+	enum class sdf_mode : int64_t {
+		Progressive,
+		JumpFlooding,
+	};
+
+	enum class sdf_precision : int64_t {
+		Full,
+		Half,
+	};
+
+	enum class sdf_rebuild : int64_t {
+		Always,
+		Automatic,
+		Static,
+	};
+
 	class sdf_effects_instance : public obs::source_instance {
-		streamfx::obs::gs::effect            _sdf_producer_effect;
-		streamfx::obs::gs::effect            _sdf_consumer_effect;
-		std::shared_ptr<streamfx::gfx::util> _gfx_util;
+		streamfx::obs::gs::effect                         _sdf_producer_effect;
+		streamfx::obs::gs::effect_bindings<4>             _sdf_producer_params;
+		streamfx::obs::gs::effect                         _sdf_jfa_effect;
+		streamfx::obs::gs::effect_bindings<5>             _sdf_jfa_params;
+		streamfx::obs::gs::effect                         _sdf_consumer_effect;
+		streamfx::obs::gs::effect_bindings<25>            _sdf_consumer_params;
+		uint32_t                                          _sdf_consumer_variant;
+		std::shared_ptr<streamfx::gfx::util>              _gfx_util;
+		std::shared_ptr<streamfx::gfx::rendertarget_pool> _rt_pool;
 
 		// Input
 		std::shared_ptr<streamfx::obs::gs::rendertarget> _source_rt;
@@ -26,9 +56,17 @@ namespace streamfx::filter::sdf_effects {
 		// Distance Field
 		std::shared_ptr<streamfx::obs::gs::rendertarget> _sdf_write;
 		std::shared_ptr<streamfx::obs::gs::rendertarget> _sdf_read;
+		std::shared_ptr<streamfx::obs::gs::rendertarget> _sdf_field;
 		std::shared_ptr<streamfx::obs::gs::texture>      _sdf_texture;
 		double_t                                         _sdf_scale;
 		float                                          _sdf_threshold;
+		sdf_mode                                         _sdf_mode;
+		sdf_mode                                         _sdf_built_mode;
+		sdf_precision                                    _sdf_precision;
+		sdf_rebuild                                      _sdf_rebuild;
+		streamfx::obs::filter_input_tracker              _sdf_input;
+		std::atomic<bool>                                _sdf_dirty;
+		uint64_t                                         _sdf_signature;
 
 		// Effects
 		bool                                             _output_rendered;
@@ -78,13 +116,27 @@ namespace streamfx::filter::sdf_effects {
 
 		virtual void video_tick(float) override;
 		virtual void video_render(gs_effect_t*) override;
+
+		private:
+		void generate_progressive(uint32_t width, uint32_t height);
+
+		void generate_jump_flood(uint32_t width, uint32_t height);
 	};
 
 	class sdf_effects_factory : public obs::source_factory<filter::sdf_effects::sdf_effects_factory, filter::sdf_effects::sdf_effects_instance> {
+		std::mutex                                _consumer_lock;
+		std::array<streamfx::obs::gs::effect, 32> _consumer_effects;
+
 		public:
 		sdf_effects_factory();
 		virtual ~sdf_effects_factory();
 
+		/** The permutation of sdf-consumer.effect which draws the given combination of effects.
+		 *
+		 * Compiled on first use, and kept until the plugin is unloaded. Empty if it failed to compile.
+		 */
+		streamfx::obs::gs::effect get_consumer_effect(uint32_t variant);
+
 		virtual const char* get_name() override;
 
 		virtual void get_defaults2(obs_data_t* data) override;
@@ -93,6 +145,8 @@ namespace streamfx::filter::sdf_effects {
 
 		static bool on_manual_open(obs_properties_t* props, obs_property_t* property, void* data);
 
+		static bool on_mode_modified(void* priv, obs_properties_t* props, obs_property_t* property, obs_data_t* settings);
+
 		public: // Singleton
 		static void initialize();
 
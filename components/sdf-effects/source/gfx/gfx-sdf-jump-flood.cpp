@@ -0,0 +1,117 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2023 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "gfx-sdf-jump-flood.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "warning-enable.hpp"
+
+// Same as MAX_DISTANCE in sdf-jfa.effect, the largest finite 16-bit float.
+static constexpr float max_distance = 65504.f;
+
+uint32_t streamfx::gfx::sdf::jump_flood_passes(uint32_t width, uint32_t height)
+{
+	uint32_t size   = std::max(width, height);
+	uint32_t passes = 0;
+	while ((uint64_t(1) << passes) < size) {
+		passes++;
+	}
+	return passes;
+}
+
+uint32_t streamfx::gfx::sdf::jump_flood_step(uint32_t width, uint32_t height, uint32_t pass)
+{
+	uint32_t passes = jump_flood_passes(width, height);
+	if (pass >= passes) {
+		return 1;
+	}
+	return uint32_t(1) << (passes - pass - 1);
+}
+
+streamfx::gfx::sdf::jump_flood_field streamfx::gfx::sdf::jump_flood(const uint8_t* alpha, uint32_t width, uint32_t height, std::size_t stride, uint8_t threshold)
+{
+	// Nearest inside (first) and outside (second) texel, -1 if there is none yet.
+	struct seed {
+		int32_t x[2];
+		int32_t y[2];
+	};
+
+	std::size_t       count = std::size_t(width) * height;
+	std::vector<seed> read(count);
+	std::vector<seed> write(count);
+
+	// Seed
+	for (uint32_t y = 0; y < height; y++) {
+		for (uint32_t x = 0; x < width; x++) {
+			bool  is_inside = alpha[y * stride + x] > threshold;
+			seed& here      = read[std::size_t(y) * width + x];
+			here.x[0]       = is_inside ? int32_t(x) : -1;
+			here.y[0]       = is_inside ? int32_t(y) : -1;
+			here.x[1]       = is_inside ? -1 : int32_t(x);
+			here.y[1]       = is_inside ? -1 : int32_t(y);
+		}
+	}
+
+	// Flood
+	auto distance = [](int32_t x, int32_t y, int32_t tx, int32_t ty) {
+		float dx = float(tx - x);
+		float dy = float(ty - y);
+		return std::sqrt(dx * dx + dy * dy);
+	};
+
+	uint32_t passes = jump_flood_passes(width, height);
+	for (uint32_t pass = 0; pass < passes; pass++) {
+		int32_t step = int32_t(jump_flood_step(width, height, pass));
+
+		for (int32_t y = 0; y < int32_t(height); y++) {
+			for (int32_t x = 0; x < int32_t(width); x++) {
+				seed  best    = {{-1, -1}, {-1, -1}};
+				float dist[2] = {std::numeric_limits<float>::infinity(), std::numeric_limits<float>::infinity()};
+
+				for (int32_t oy = -1; oy <= 1; oy++) {
+					for (int32_t ox = -1; ox <= 1; ox++) {
+						// Same as the clamped sampler in the effect.
+						int32_t     sx    = std::clamp(x + ox * step, 0, int32_t(width) - 1);
+						int32_t     sy    = std::clamp(y + oy * step, 0, int32_t(height) - 1);
+						const seed& other = read[std::size_t(sy) * width + sx];
+
+						for (std::size_t idx = 0; idx < 2; idx++) {
+							if (other.x[idx] < 0) {
+								continue;
+							}
+
+							float d = distance(x, y, other.x[idx], other.y[idx]);
+							if (d < dist[idx]) {
+								dist[idx]   = d;
+								best.x[idx] = other.x[idx];
+								best.y[idx] = other.y[idx];
+							}
+						}
+					}
+				}
+
+				write[std::size_t(y) * width + x] = best;
+			}
+		}
+
+		std::swap(read, write);
+	}
+
+	// Resolve
+	jump_flood_field field{width, height, passes, std::vector<float>(count), std::vector<float>(count)};
+	for (int32_t y = 0; y < int32_t(height); y++) {
+		for (int32_t x = 0; x < int32_t(width); x++) {
+			std::size_t idx  = std::size_t(y) * width + x;
+			const seed& here = read[idx];
+
+			field.outside[idx] = (here.x[0] < 0) ? max_distance : std::min(distance(x, y, here.x[0], here.y[0]), max_distance);
+			field.inside[idx]  = (here.x[1] < 0) ? max_distance : std::min(distance(x, y, here.x[1], here.y[1]), max_distance);
+		}
+	}
+
+	return field;
+}
@@ -0,0 +1,39 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2023 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "common.hpp"
+
+#include "warning-disable.hpp"
+#include <cinttypes>
+#include <cstddef>
+#include <vector>
+#include "warning-enable.hpp"
+
+namespace streamfx::gfx::sdf {
+	/** Number of Flood passes needed before every texel has seen every other texel. */
+	uint32_t jump_flood_passes(uint32_t width, uint32_t height);
+
+	/** Distance in texels that the Flood pass with the given index looks at, halving with every pass down to 1. */
+	uint32_t jump_flood_step(uint32_t width, uint32_t height, uint32_t pass);
+
+	struct jump_flood_field {
+		uint32_t width;
+		uint32_t height;
+		uint32_t passes;
+
+		/** Distance from each outside texel to the nearest inside texel, 0 for inside texels. */
+		std::vector<float> outside;
+
+		/** Distance from each inside texel to the nearest outside texel, 0 for outside texels. */
+		std::vector<float> inside;
+	};
+
+	/** Reference implementation of sdf-jfa.effect, following the same Seed, Flood and Resolve steps.
+	 *
+	 * Meant for checking the results and pass counts of the GPU version without a graphics context. A texel is inside if
+	 * its alpha is above the threshold, and distances without anything to measure against are reported as 65504.
+	 */
+	jump_flood_field jump_flood(const uint8_t* alpha, uint32_t width, uint32_t height, std::size_t stride, uint8_t threshold);
+} // namespace streamfx::gfx::sdf
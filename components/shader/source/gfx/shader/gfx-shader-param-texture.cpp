@@ -59,7 +59,7 @@ streamfx::gfx::shader::texture_field_type streamfx::gfx::shader::get_texture_fie
 	return texture_field_type::Input;
 }
 
-streamfx::gfx::shader::texture_parameter::texture_parameter(streamfx::gfx::shader::shader* parent, streamfx::obs::gs::effect_parameter param, std::string prefix) : parameter(parent, param, prefix), _field_type(texture_field_type::Input), _keys(), _values(), _type(texture_type::File), _active(false), _visible(false), _dirty(true), _dirty_ts(std::chrono::high_resolution_clock::now()), _file_path(), _file_texture(), _source_name(), _source(), _source_child(), _source_active(), _source_visible(), _source_rendertarget()
+streamfx::gfx::shader::texture_parameter::texture_parameter(streamfx::gfx::shader::shader* parent, streamfx::obs::gs::effect_parameter param, std::string prefix) : parameter(parent, param, prefix), _field_type(texture_field_type::Input), _keys(), _values(), _type(texture_type::File), _active(false), _visible(false), _dirty(true), _dirty_ts(std::chrono::high_resolution_clock::now()), _file_path(), _file_cache(streamfx::gfx::texture_cache::get()), _file_texture(), _source_name(), _source(), _source_child(), _source_active(), _source_visible(), _source_rendertarget()
 {
 	char string_buffer[256];
 
@@ -268,7 +268,8 @@ void streamfx::gfx::shader::texture_parameter::assign()
 
 			if (((field_type() == texture_field_type::Input) && (_type == texture_type::File)) || (field_type() == texture_field_type::Enum)) {
 				if (!_file_path.empty()) {
-					_file_texture = std::make_shared<streamfx::obs::gs::texture>(streamfx::util::platform::native_to_utf8(_file_path).generic_u8string().c_str());
+					// Decoded in the background, the placeholder is shown until then.
+					_file_texture = _file_cache->load(_file_path);
 				}
 			} else if ((field_type() == texture_field_type::Input) && (_type == texture_type::Source)) {
 				// Try and grab the source itself.
@@ -349,9 +350,20 @@ void streamfx::gfx::shader::texture_parameter::assign()
 			get_parameter().set_texture(nullptr, false);
 		}
 	} else if (_type == texture_type::File) {
+		if (_file_texture && _file_texture->failed()) {
+			// Try again later, just like if the file could not be found.
+			_file_texture.reset();
+			_dirty    = true;
+			_dirty_ts = std::chrono::high_resolution_clock::now() + std::chrono::milliseconds(5000);
+		}
+
 		if (_file_texture) {
 			// Loaded files are always linear.
-			get_parameter().set_texture(_file_texture, false);
+			if (auto tex = _file_texture->get(); tex) {
+				get_parameter().set_texture(tex, false);
+			} else {
+				get_parameter().set_texture(_file_cache->placeholder(), false);
+			}
 		} else {
 			get_parameter().set_texture(nullptr, false);
 		}
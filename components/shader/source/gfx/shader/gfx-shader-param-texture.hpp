@@ -7,6 +7,7 @@
 #pragma once
 #include "common.hpp"
 #include "gfx-shader-param.hpp"
+#include "gfx/gfx-texture-cache.hpp"
 #include "obs/gs/gs-rendertarget.hpp"
 #include "obs/gs/gs-texture.hpp"
 #include "obs/obs-source-active-child.hpp"
@@ -62,8 +63,9 @@ namespace streamfx::gfx {
 			std::chrono::high_resolution_clock::time_point _dirty_ts;
 
 			// Data: File
-			std::filesystem::path                       _file_path;
-			std::shared_ptr<streamfx::obs::gs::texture> _file_texture;
+			std::filesystem::path                                _file_path;
+			std::shared_ptr<streamfx::gfx::texture_cache>        _file_cache;
+			std::shared_ptr<streamfx::gfx::texture_cache::entry> _file_texture;
 
 			// Data: Source
 			std::string                                              _source_name;
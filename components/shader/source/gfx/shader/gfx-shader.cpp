@@ -8,11 +8,15 @@
 #include "obs/gs/gs-helper.hpp"
 #include "obs/obs-tools.hpp"
 #include "plugin.hpp"
+#include "util/util-file-watcher.hpp"
+#include "util/util-threadpool.hpp"
 
 #include "warning-disable.hpp"
 #include <algorithm>
+#include <atomic>
 #include <cstdio>
 #include <cstring>
+#include <mutex>
 #include "warning-enable.hpp"
 
 #define ST_I18N "Shader"
@@ -35,10 +39,44 @@
 #define ST_I18N_PARAMETERS ST_I18N ".Parameters"
 #define ST_KEY_PARAMETERS "Shader.Parameters"
 
+// Parameters provided by StreamFX itself, all of them are optional.
+enum class builtin : std::size_t {
+	Time,
+	ViewSize,
+	Random,
+	RandomSeed,
+	TransitionTime,
+	TransitionSize,
+	InputA,
+	InputB,
+};
+static constexpr std::array<const char*, 8> builtin_names = {"Time", "ViewSize", "Random", "RandomSeed", "TransitionTime", "TransitionSize", "InputA", "InputB"};
+
+// Shaders may declare a built-in parameter with a different type, in which case it is left alone.
+static constexpr std::array<streamfx::obs::gs::effect_parameter::type, 8> builtin_types = {
+	streamfx::obs::gs::effect_parameter::type::Float4,
+	streamfx::obs::gs::effect_parameter::type::Float4,
+	streamfx::obs::gs::effect_parameter::type::Matrix,
+	streamfx::obs::gs::effect_parameter::type::Integer,
+	streamfx::obs::gs::effect_parameter::type::Float,
+	streamfx::obs::gs::effect_parameter::type::Integer2,
+	streamfx::obs::gs::effect_parameter::type::Texture,
+	streamfx::obs::gs::effect_parameter::type::Texture,
+};
+
+// Shared with the file watcher and the threadpool, which may both outlive the shader.
+struct streamfx::gfx::shader::shader::reload {
+	std::mutex                lock;
+	std::filesystem::path     file;
+	uint64_t                  generation = 0;
+	streamfx::obs::gs::effect effect;
+	std::atomic<bool>         ready{false};
+};
+
 streamfx::gfx::shader::shader::shader(obs_source_t* self, shader_mode mode)
 	: _self(self), _gfx_util(::streamfx::gfx::util::get()), _mode(mode), _base_width(1), _base_height(1), _active(true),
 
-	  _shader(), _shader_file(), _shader_tech("Draw"), _shader_file_mt(), _shader_file_sz(), _shader_file_tick(0),
+	  _shader(), _shader_builtins(), _shader_file(), _shader_tech("Draw"), _shader_params(), _shader_reload(std::make_shared<reload>()), _shader_watch(),
 
 	  _width_type(size_type::Percent), _width_value(1.0), _height_type(size_type::Percent), _height_value(1.0),
 
@@ -53,32 +91,16 @@ streamfx::gfx::shader::shader::shader(obs_source_t* self, shader_mode mode)
 	}
 }
 
-streamfx::gfx::shader::shader::~shader() = default;
+streamfx::gfx::shader::shader::~shader()
+{
+	// Stop listening for changes first, anything still in flight only holds on to the reload state.
+	_shader_watch.reset();
+}
 
 bool streamfx::gfx::shader::shader::is_shader_different(const std::filesystem::path& file)
 {
-	try {
-		if (std::filesystem::exists(file)) {
-			// Check if the file name differs.
-			if (file != _shader_file)
-				return true;
-		}
-
-		if (std::filesystem::exists(_shader_file)) {
-			// Is the file write time different?
-			if (std::filesystem::last_write_time(_shader_file) != _shader_file_mt)
-				return true;
-
-			// Is the file size different?
-			if (std::filesystem::file_size(_shader_file) != _shader_file_sz)
-				return true;
-		}
-
-		return false;
-	} catch (const std::exception& ex) {
-		DLOG_ERROR("Loading shader '%s' failed with error: %s", file.c_str(), ex.what());
-		return false;
-	}
+	// Changes to the file itself are reported by the file watcher, no need to look at the disk here.
+	return file != _shader_file;
 }
 
 bool streamfx::gfx::shader::shader::is_technique_different(std::string_view tech)
@@ -101,64 +123,12 @@ bool streamfx::gfx::shader::shader::load_shader(const std::filesystem::path& fil
 
 		// Update Shader
 		if (shader_dirty) {
-			_shader           = streamfx::obs::gs::effect(file);
-			_shader_file_mt   = std::filesystem::last_write_time(file);
-			_shader_file_sz   = std::filesystem::file_size(file);
-			_shader_file      = file;
-			_shader_file_tick = 0;
+			apply_shader(streamfx::obs::gs::effect(file), file);
 		}
 
 		// Update Params
 		if (param_dirty) {
-			auto settings = std::shared_ptr<obs_data_t>(obs_source_get_settings(_self), [](obs_data_t* p) { obs_data_release(p); });
-
-			bool have_valid_tech = false;
-			for (std::size_t idx = 0; idx < _shader.count_techniques(); idx++) {
-				if (_shader.get_technique(idx).name() == tech) {
-					have_valid_tech = true;
-					break;
-				}
-			}
-			if (have_valid_tech) {
-				_shader_tech = tech;
-			} else {
-				_shader_tech = _shader.get_technique(0).name();
-
-				// Update source data.
-				obs_data_set_string(settings.get(), ST_KEY_SHADER_TECHNIQUE, _shader_tech.c_str());
-			}
-
-			// Clear the shader parameters map and rebuild.
-			_shader_params.clear();
-			auto etech = _shader.get_technique(_shader_tech);
-			for (std::size_t idx = 0; idx < etech.count_passes(); idx++) {
-				auto pass         = etech.get_pass(idx);
-				auto fetch_params = [&](std::size_t count, std::function<streamfx::obs::gs::effect_parameter(std::size_t)> get_func) {
-					for (std::size_t vidx = 0; vidx < count; vidx++) {
-						auto el = get_func(vidx);
-						if (!el)
-							continue;
-
-						auto el_name = el.get_name();
-						auto fnd     = _shader_params.find(el_name);
-						if (fnd != _shader_params.end())
-							continue;
-
-						auto param = streamfx::gfx::shader::parameter::make_parameter(this, el, ST_KEY_PARAMETERS);
-
-						if (param) {
-							_shader_params.insert_or_assign(el_name, param);
-							param->defaults(settings.get());
-							param->update(settings.get());
-						}
-					}
-				};
-
-				auto gvp = [&](std::size_t idx) { return pass.get_vertex_parameter(idx); };
-				fetch_params(pass.count_vertex_parameters(), gvp);
-				auto gpp = [&](std::size_t idx) { return pass.get_pixel_parameter(idx); };
-				fetch_params(pass.count_pixel_parameters(), gpp);
-			}
+			apply_technique(tech);
 		}
 
 		return true;
@@ -170,6 +140,148 @@ bool streamfx::gfx::shader::shader::load_shader(const std::filesystem::path& fil
 	}
 }
 
+void streamfx::gfx::shader::shader::apply_shader(streamfx::obs::gs::effect effect, const std::filesystem::path& file)
+{
+	_shader = effect;
+
+	// Resolve the built-in parameters once, instead of searching for them every frame.
+	_shader_builtins.bind(_shader, builtin_names);
+	for (std::size_t idx = 0; idx < builtin_names.size(); idx++) {
+		if (_shader_builtins.has(idx) && (_shader_builtins[idx].get_type() != builtin_types[idx])) {
+			_shader_builtins[idx] = streamfx::obs::gs::effect_parameter();
+		}
+	}
+
+	// Older shaders use different names for their inputs.
+	std::pair<builtin, std::array<const char*, 2>> input_aliases[] = {
+		{builtin::InputA, {"image", "tex_a"}},
+		{builtin::InputB, {"image2", "tex_b"}},
+	};
+	for (auto& kv : input_aliases) {
+		for (auto name : kv.second) {
+			if (_shader_builtins.has(kv.first)) {
+				break;
+			}
+			if (auto el = _shader.get_parameter(name); el && (el.get_type() == streamfx::obs::gs::effect_parameter::type::Texture)) {
+				_shader_builtins[kv.first] = el;
+			}
+		}
+	}
+
+	if (file == _shader_file) {
+		return;
+	}
+	_shader_file = file;
+
+	// Anything still being reloaded belongs to the previous file.
+	streamfx::obs::gs::effect stale;
+	{
+		std::lock_guard<std::mutex> lg(_shader_reload->lock);
+		_shader_reload->file = file;
+		_shader_reload->generation++;
+		std::swap(_shader_reload->effect, stale);
+		_shader_reload->ready = false;
+	}
+
+	// Only the reload state is captured, as the watcher and the threadpool may both outlive this shader.
+	_shader_watch.reset();
+	_shader_watch = streamfx::util::file_watcher::instance()->watch(file, [weak = std::weak_ptr<reload>(_shader_reload)](const std::filesystem::path&) {
+		uint64_t generation;
+		if (auto state = weak.lock(); state) {
+			std::lock_guard<std::mutex> lg(state->lock);
+			generation = ++state->generation;
+		} else {
+			return;
+		}
+
+		// Compile off-thread, only the swap happens in tick().
+		streamfx::threadpool()->push(
+			[weak, generation](streamfx::util::threadpool::task_data_t) {
+				auto state = weak.lock();
+				if (!state) {
+					return;
+				}
+
+				std::filesystem::path file;
+				{
+					std::lock_guard<std::mutex> lg(state->lock);
+					if (state->generation != generation) {
+						return; // Changed again in the meantime.
+					}
+					file = state->file;
+				}
+
+				streamfx::obs::gs::effect effect;
+				try {
+					effect = streamfx::obs::gs::effect(file);
+				} catch (const std::exception& ex) {
+					DLOG_ERROR("Reloading shader '%s' failed with error: %s", file.c_str(), ex.what());
+					return;
+				}
+
+				std::lock_guard<std::mutex> lg(state->lock);
+				if (state->generation == generation) {
+					std::swap(state->effect, effect);
+					state->ready = true;
+				}
+			},
+			nullptr, streamfx::util::threadpool::priority::BACKGROUND);
+	});
+}
+
+void streamfx::gfx::shader::shader::apply_technique(std::string_view tech)
+{
+	auto settings = std::shared_ptr<obs_data_t>(obs_source_get_settings(_self), [](obs_data_t* p) { obs_data_release(p); });
+
+	bool have_valid_tech = false;
+	for (std::size_t idx = 0; idx < _shader.count_techniques(); idx++) {
+		if (_shader.get_technique(idx).name() == tech) {
+			have_valid_tech = true;
+			break;
+		}
+	}
+	if (have_valid_tech) {
+		_shader_tech = tech;
+	} else {
+		_shader_tech = _shader.get_technique(0).name();
+
+		// Update source data.
+		obs_data_set_string(settings.get(), ST_KEY_SHADER_TECHNIQUE, _shader_tech.c_str());
+	}
+
+	// Clear the shader parameters map and rebuild.
+	_shader_params.clear();
+	auto etech = _shader.get_technique(_shader_tech);
+	for (std::size_t idx = 0; idx < etech.count_passes(); idx++) {
+		auto pass         = etech.get_pass(idx);
+		auto fetch_params = [&](std::size_t count, std::function<streamfx::obs::gs::effect_parameter(std::size_t)> get_func) {
+			for (std::size_t vidx = 0; vidx < count; vidx++) {
+				auto el = get_func(vidx);
+				if (!el)
+					continue;
+
+				auto el_name = el.get_name();
+				auto fnd     = _shader_params.find(el_name);
+				if (fnd != _shader_params.end())
+					continue;
+
+				auto param = streamfx::gfx::shader::parameter::make_parameter(this, el, ST_KEY_PARAMETERS);
+
+				if (param) {
+					_shader_params.insert_or_assign(el_name, param);
+					param->defaults(settings.get());
+					param->update(settings.get());
+				}
+			}
+		};
+
+		auto gvp = [&](std::size_t idx) { return pass.get_vertex_parameter(idx); };
+		fetch_params(pass.count_vertex_parameters(), gvp);
+		auto gpp = [&](std::size_t idx) { return pass.get_pixel_parameter(idx); };
+		fetch_params(pass.count_pixel_parameters(), gpp);
+	}
+}
+
 void streamfx::gfx::shader::shader::defaults(obs_data_t* data)
 {
 	obs_data_set_default_string(data, ST_KEY_SHADER_FILE, "");
@@ -401,11 +513,21 @@ uint32_t streamfx::gfx::shader::shader::base_height()
 
 bool streamfx::gfx::shader::shader::tick(float time)
 {
-	_shader_file_tick = static_cast<float>(static_cast<double_t>(_shader_file_tick) + static_cast<double_t>(time));
-	if (_shader_file_tick >= 1.0f / 3.0f) {
-		_shader_file_tick -= 1.0f / 3.0f;
-		bool v1, v2;
-		load_shader(_shader_file, _shader_tech, v1, v2);
+	// Swap in a shader that was reloaded in the background.
+	if (_shader_reload->ready.exchange(false)) {
+		streamfx::obs::gs::effect effect;
+		{
+			std::lock_guard<std::mutex> lg(_shader_reload->lock);
+			std::swap(_shader_reload->effect, effect);
+		}
+		if (effect) {
+			try {
+				apply_shader(effect, _shader_file);
+				apply_technique(_shader_tech);
+			} catch (const std::exception& ex) {
+				DLOG_ERROR("Reloading shader '%s' failed with error: %s", _shader_file.c_str(), ex.what());
+			}
+		}
 	}
 
 	// Update State
@@ -442,31 +564,23 @@ void streamfx::gfx::shader::shader::prepare_render()
 	}
 
 	// float4 Time: (Time in Seconds), (Time in Current Second), (Time in Seconds only), (Random Value)
-	if (streamfx::obs::gs::effect_parameter el = _shader.get_parameter("Time"); el != nullptr) {
-		if (el.get_type() == streamfx::obs::gs::effect_parameter::type::Float4) {
-			el.set_float4(_time, _time_loop, static_cast<float>(_loops), static_cast<float>(static_cast<double_t>(_random()) / static_cast<double_t>(_random.max())));
-		}
+	if (_shader_builtins.has(builtin::Time)) {
+		_shader_builtins[builtin::Time].set_float4(_time, _time_loop, static_cast<float>(_loops), static_cast<float>(static_cast<double_t>(_random()) / static_cast<double_t>(_random.max())));
 	}
 
 	// float4 ViewSize: (Width), (Height), (1.0 / Width), (1.0 / Height)
-	if (auto el = _shader.get_parameter("ViewSize"); el != nullptr) {
-		if (el.get_type() == streamfx::obs::gs::effect_parameter::type::Float4) {
-			el.set_float4(static_cast<float>(width()), static_cast<float>(height()), 1.0f / static_cast<float>(width()), 1.0f / static_cast<float>(height()));
-		}
+	if (_shader_builtins.has(builtin::ViewSize)) {
+		_shader_builtins[builtin::ViewSize].set_float4(static_cast<float>(width()), static_cast<float>(height()), 1.0f / static_cast<float>(width()), 1.0f / static_cast<float>(height()));
 	}
 
 	// float4x4 Random: float4[Per-Instance Random], float4[Per-Activation Random], float4x2[Per-Frame Random]
-	if (auto el = _shader.get_parameter("Random"); el != nullptr) {
-		if (el.get_type() == streamfx::obs::gs::effect_parameter::type::Matrix) {
-			el.set_value(_random_values, 16);
-		}
+	if (_shader_builtins.has(builtin::Random)) {
+		_shader_builtins[builtin::Random].set_value(_random_values, 16);
 	}
 
 	// int32 RandomSeed: Seed used for random generation
-	if (auto el = _shader.get_parameter("RandomSeed"); el != nullptr) {
-		if (el.get_type() == streamfx::obs::gs::effect_parameter::type::Integer) {
-			el.set_int(_random_seed);
-		}
+	if (_shader_builtins.has(builtin::RandomSeed)) {
+		_shader_builtins[builtin::RandomSeed].set_int(_random_seed);
 	}
 
 	return;
@@ -539,18 +653,8 @@ void streamfx::gfx::shader::shader::set_input_a(std::shared_ptr<streamfx::obs::g
 	if (!_shader)
 		return;
 
-	std::string_view params[] = {
-		"InputA",
-		"image",
-		"tex_a",
-	};
-	for (auto& name : params) {
-		if (streamfx::obs::gs::effect_parameter el = _shader.get_parameter(name.data()); el != nullptr) {
-			if (el.get_type() == streamfx::obs::gs::effect_parameter::type::Texture) {
-				el.set_texture(tex, srgb);
-				break;
-			}
-		}
+	if (_shader_builtins.has(builtin::InputA)) {
+		_shader_builtins[builtin::InputA].set_texture(tex, srgb);
 	}
 }
 
@@ -559,18 +663,8 @@ void streamfx::gfx::shader::shader::set_input_b(std::shared_ptr<streamfx::obs::g
 	if (!_shader)
 		return;
 
-	std::string_view params[] = {
-		"InputB",
-		"image2",
-		"tex_b",
-	};
-	for (auto& name : params) {
-		if (streamfx::obs::gs::effect_parameter el = _shader.get_parameter(name.data()); el != nullptr) {
-			if (el.get_type() == streamfx::obs::gs::effect_parameter::type::Texture) {
-				el.set_texture(tex, srgb);
-				break;
-			}
-		}
+	if (_shader_builtins.has(builtin::InputB)) {
+		_shader_builtins[builtin::InputB].set_texture(tex, srgb);
 	}
 }
 
@@ -579,10 +673,8 @@ void streamfx::gfx::shader::shader::set_transition_time(float t)
 	if (!_shader)
 		return;
 
-	if (streamfx::obs::gs::effect_parameter el = _shader.get_parameter("TransitionTime"); el != nullptr) {
-		if (el.get_type() == streamfx::obs::gs::effect_parameter::type::Float) {
-			el.set_float(t);
-		}
+	if (_shader_builtins.has(builtin::TransitionTime)) {
+		_shader_builtins[builtin::TransitionTime].set_float(t);
 	}
 }
 
@@ -590,10 +682,8 @@ void streamfx::gfx::shader::shader::set_transition_size(uint32_t w, uint32_t h)
 {
 	if (!_shader)
 		return;
-	if (streamfx::obs::gs::effect_parameter el = _shader.get_parameter("TransitionSize"); el != nullptr) {
-		if (el.get_type() == streamfx::obs::gs::effect_parameter::type::Integer2) {
-			el.set_int2(static_cast<int32_t>(w), static_cast<int32_t>(h));
-		}
+	if (_shader_builtins.has(builtin::TransitionSize)) {
+		_shader_builtins[builtin::TransitionSize].set_int2(static_cast<int32_t>(w), static_cast<int32_t>(h));
 	}
 }
 
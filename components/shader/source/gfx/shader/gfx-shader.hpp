@@ -15,6 +15,7 @@
 #include <filesystem>
 #include <list>
 #include <map>
+#include <memory>
 #include <random>
 #include "warning-enable.hpp"
 
@@ -46,13 +47,16 @@ namespace streamfx::gfx {
 			bool        _visible;
 
 			// Shader
-			streamfx::obs::gs::effect       _shader;
-			std::filesystem::path           _shader_file;
-			std::string                     _shader_tech;
-			std::filesystem::file_time_type _shader_file_mt;
-			uintmax_t                       _shader_file_sz;
-			float                         _shader_file_tick;
-			shader_param_map_t              _shader_params;
+			streamfx::obs::gs::effect             _shader;
+			streamfx::obs::gs::effect_bindings<8> _shader_builtins;
+			std::filesystem::path                 _shader_file;
+			std::string                           _shader_tech;
+			shader_param_map_t                    _shader_params;
+
+			// Reloading
+			struct reload;
+			std::shared_ptr<reload> _shader_reload;
+			std::shared_ptr<void>   _shader_watch;
 
 			// Options
 			size_type _width_type;
@@ -83,6 +87,12 @@ namespace streamfx::gfx {
 
 			bool load_shader(const std::filesystem::path& file, std::string_view tech, bool& shader_dirty, bool& param_dirty);
 
+			private:
+			void apply_shader(streamfx::obs::gs::effect effect, const std::filesystem::path& file);
+
+			void apply_technique(std::string_view tech);
+
+			public:
 			static void defaults(obs_data_t* data);
 
 			void properties(obs_properties_t* props);
@@ -191,6 +191,7 @@ std::shared_ptr<shader_factory> shader_factory::instance()
 static std::shared_ptr<shader_factory> loader_instance;
 
 static auto loader = streamfx::loader(
+	"transition-shader",
 	[]() { // Initalizer
 		loader_instance = shader_factory::instance();
 	},
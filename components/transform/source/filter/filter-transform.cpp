@@ -76,6 +76,10 @@
 #define ST_KEY_CORNERS_BOTTOMRIGHT "Corners.BottomRight."
 #define ST_I18N_MIPMAPPING ST_I18N ".Mipmapping"
 #define ST_KEY_MIPMAPPING "Mipmapping"
+#define ST_I18N_MIPMAPPING_METHOD ST_I18N_MIPMAPPING ".Method"
+#define ST_KEY_MIPMAPPING_METHOD "Mipmapping.Method"
+#define ST_I18N_MIPMAPPING_METHOD_NATIVE ST_I18N_MIPMAPPING_METHOD ".Native"
+#define ST_I18N_MIPMAPPING_METHOD_RENDER ST_I18N_MIPMAPPING_METHOD ".Render"
 
 using namespace streamfx::filter::transform;
 
@@ -141,6 +145,18 @@ transform_instance::transform_instance(obs_data_t* data, obs_source_t* context)
 
 transform_instance::~transform_instance()
 {
+#ifdef ENABLE_PROFILING
+	if (_mipmap_texture) {
+		// Native generation produces all levels after the first at once, so it only ever shows up as level 1.
+		DLOG_INFO("<%s> Mip-maps were last %s.", _self.name().data(), (_mipmapper.get_last_method() == streamfx::gfx::mipmapper::method::Native) ? "generated by the graphics API" : "rendered");
+		for (uint32_t level = 0, levels = _mipmapper.calculate_max_mip_level(_mipmap_texture->get_width(), _mipmap_texture->get_height()); level < levels; level++) {
+			if (auto profiler = _mipmapper.get_profiler(level); profiler->count() > 0) {
+				DLOG_INFO("<%s> Mip level %" PRIu32 " took %.3f ms average, %.3f ms 99th percentile CPU time over %" PRIu64 " rebuilds.", _self.name().data(), level, profiler->average_duration() / 1000000.0, static_cast<double_t>(profiler->percentile(0.99).count()) / 1000000.0, profiler->count());
+			}
+		}
+	}
+#endif
+
 	_vertex_buffer.reset();
 	_cache_rt.reset();
 	_cache_texture.reset();
@@ -235,6 +251,7 @@ void transform_instance::update(obs_data_t* settings)
 	// Mip-mapping
 	_mipmap_enabled = obs_data_get_bool(settings, ST_KEY_MIPMAPPING);
 	_sampler.set_filter(_mipmap_enabled ? GS_FILTER_ANISOTROPIC : GS_FILTER_LINEAR);
+	_mipmapper.set_method(static_cast<streamfx::gfx::mipmapper::method>(obs_data_get_int(settings, ST_KEY_MIPMAPPING_METHOD)));
 
 	_update_mesh = true;
 }
@@ -590,6 +607,7 @@ void transform_factory::get_defaults2(obs_data_t* settings)
 	obs_data_set_default_double(settings, ST_KEY_CORNERS_BOTTOMRIGHT "X", 100.);
 	obs_data_set_default_double(settings, ST_KEY_CORNERS_BOTTOMRIGHT "Y", 100.);
 	obs_data_set_default_bool(settings, ST_KEY_MIPMAPPING, false);
+	obs_data_set_default_int(settings, ST_KEY_MIPMAPPING_METHOD, static_cast<int64_t>(streamfx::gfx::mipmapper::method::Automatic));
 }
 
 static bool modified_camera_mode(obs_properties_t* pr, obs_property_t*, obs_data_t* d) noexcept
@@ -777,6 +795,12 @@ obs_properties_t* transform_factory::get_properties2(transform_instance* data)
 		{ // Mip-mapping
 			auto p = obs_properties_add_bool(grp, ST_KEY_MIPMAPPING, D_TRANSLATE(ST_I18N_MIPMAPPING));
 		}
+		{
+			auto p = obs_properties_add_list(grp, ST_KEY_MIPMAPPING_METHOD, D_TRANSLATE(ST_I18N_MIPMAPPING_METHOD), OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_INT);
+			obs_property_list_add_int(p, D_TRANSLATE(S_STATE_AUTOMATIC), static_cast<int64_t>(streamfx::gfx::mipmapper::method::Automatic));
+			obs_property_list_add_int(p, D_TRANSLATE(ST_I18N_MIPMAPPING_METHOD_NATIVE), static_cast<int64_t>(streamfx::gfx::mipmapper::method::Native));
+			obs_property_list_add_int(p, D_TRANSLATE(ST_I18N_MIPMAPPING_METHOD_RENDER), static_cast<int64_t>(streamfx::gfx::mipmapper::method::Render));
+		}
 
 		{ // Order
 			auto p = obs_properties_add_list(grp, ST_KEY_ROTATION_ORDER, D_TRANSLATE(ST_I18N_ROTATION_ORDER), OBS_COMBO_TYPE_LIST, OBS_COMBO_FORMAT_INT);
@@ -823,6 +847,7 @@ std::shared_ptr<transform_factory> transform_factory::instance()
 static std::shared_ptr<transform_factory> loader_instance;
 
 static auto loader = streamfx::loader(
+	"filter-transform",
 	[]() { // Initalizer
 		loader_instance = transform_factory::instance();
 	},
@@ -368,7 +368,7 @@ void streamfx::filter::upscaling::upscaling_instance::switch_provider(upscaling_
 	_provider     = provider;
 
 	// Then spawn a new task to switch provider.
-	_provider_task = streamfx::threadpool()->push(std::bind(&upscaling_instance::task_switch_provider, this, std::placeholders::_1), spd);
+	_provider_task = streamfx::threadpool()->push(std::bind(&upscaling_instance::task_switch_provider, this, std::placeholders::_1), spd, streamfx::util::threadpool::priority::BACKGROUND);
 }
 
 void streamfx::filter::upscaling::upscaling_instance::task_switch_provider(util::threadpool::task_data_t data)
@@ -639,10 +639,11 @@ std::shared_ptr<upscaling_factory> upscaling_factory::instance()
 static std::shared_ptr<upscaling_factory> loader_instance;
 
 static auto loader = streamfx::loader(
+	"filter-upscaling",
 	[]() { // Initalizer
 		loader_instance = upscaling_factory::instance();
 	},
 	[]() { // Finalizer
 		loader_instance.reset();
 	},
-	streamfx::loader_priority::NORMAL);
+	streamfx::loader_priority::NORMAL, streamfx::loader_flags::NONE, {"nvidia-cuda"});
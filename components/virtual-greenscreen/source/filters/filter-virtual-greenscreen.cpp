@@ -378,7 +378,7 @@ void streamfx::filter::virtual_greenscreen::virtual_greenscreen_instance::switch
 	_provider     = provider;
 
 	// Then spawn a new task to switch provider.
-	_provider_task = streamfx::threadpool()->push(std::bind(&virtual_greenscreen_instance::task_switch_provider, this, std::placeholders::_1), spd);
+	_provider_task = streamfx::threadpool()->push(std::bind(&virtual_greenscreen_instance::task_switch_provider, this, std::placeholders::_1), spd, streamfx::util::threadpool::priority::BACKGROUND);
 }
 
 void streamfx::filter::virtual_greenscreen::virtual_greenscreen_instance::task_switch_provider(util::threadpool::task_data_t data)
@@ -638,10 +638,11 @@ std::shared_ptr<virtual_greenscreen_factory> virtual_greenscreen_factory::instan
 static std::shared_ptr<virtual_greenscreen_factory> loader_instance;
 
 static auto loader = streamfx::loader(
+	"filter-virtual-greenscreen",
 	[]() { // Initalizer
 		loader_instance = virtual_greenscreen_factory::instance();
 	},
 	[]() { // Finalizer
 		loader_instance.reset();
 	},
-	streamfx::loader_priority::NORMAL);
+	streamfx::loader_priority::NORMAL, streamfx::loader_flags::NONE, {"nvidia-cuda"});
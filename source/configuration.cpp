@@ -72,7 +72,7 @@ void streamfx::configuration::save()
 			if (!obs_data_save_json_safe(_data.get(), _config_path.u8string().c_str(), ".tmp", path_backup_ext.data())) {
 				D_LOG_ERROR("Failed to save configuration file.", nullptr);
 			}
-		});
+		}, nullptr, streamfx::util::threadpool::priority::BACKGROUND);
 	}
 }
 
@@ -109,10 +109,11 @@ std::shared_ptr<streamfx::configuration> streamfx::configuration::instance()
 static std::shared_ptr<streamfx::configuration> loader_instance;
 
 static auto loader = streamfx::loader(
+	"configuration",
 	[]() { // Initalizer
 		loader_instance = streamfx::configuration::instance();
 	},
 	[]() { // Finalizer
 		loader_instance.reset();
 	},
-	streamfx::loader_priority::HIGHER); // Attempt to load after critical functionality.
+	streamfx::loader_priority::HIGHER, streamfx::loader_flags::ASYNC); // Only reads from disk, nothing needs it early.
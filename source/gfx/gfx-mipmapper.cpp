@@ -42,6 +42,34 @@ static void d3d_copy_subregion(d3d_info& info, std::shared_ptr<streamfx::obs::gs
 	info.context->CopySubresourceRegion(info.target, mip_level, 0, 0, 0, source_ref, 0, &box);
 }
 
+static bool d3d_generate_mips(d3d_info& info)
+{
+	// Only textures that are render targets and were created for it can do this, which libobs doesn't always do.
+	ID3D11Texture2D* texture = nullptr;
+	if (FAILED(info.target->QueryInterface(__uuidof(ID3D11Texture2D), reinterpret_cast<void**>(&texture)))) {
+		return false;
+	}
+	D3D11_TEXTURE2D_DESC desc;
+	texture->GetDesc(&desc);
+	texture->Release();
+
+	UINT support = 0;
+	if (((desc.BindFlags & D3D11_BIND_RENDER_TARGET) == 0) || ((desc.MiscFlags & D3D11_RESOURCE_MISC_GENERATE_MIPS) == 0)) {
+		return false;
+	}
+	if (FAILED(info.device->CheckFormatSupport(desc.Format, &support)) || ((support & D3D11_FORMAT_SUPPORT_MIP_AUTOGEN) == 0)) {
+		return false;
+	}
+
+	ID3D11ShaderResourceView* view = nullptr;
+	if (FAILED(info.device->CreateShaderResourceView(info.target, nullptr, &view))) {
+		return false;
+	}
+	info.context->GenerateMips(view);
+	view->Release();
+	return true;
+}
+
 #endif
 
 struct opengl_info {
@@ -163,40 +191,92 @@ static void opengl_copy_subregion(opengl_info& info, std::shared_ptr<streamfx::o
 	D_OPENGL_CHECK_ERROR("glBindFramebuffer(GL_READ_FRAMEBUFFER, 0);");
 }
 
-streamfx::gfx::mipmapper::~mipmapper()
+static void opengl_generate_mips(opengl_info& info)
 {
-	_rt.reset();
-	_effect.reset();
+	// Target -> Texture Unit 1
+	glActiveTexture(GL_TEXTURE1);
+	D_OPENGL_CHECK_ERROR("glActiveTexture(GL_TEXTURE1);");
+	glBindTexture(GL_TEXTURE_2D, info.target);
+	D_OPENGL_CHECK_ERROR("glBindTexture(GL_TEXTURE_2D, info.target);");
+
+	// Generate all levels from the first one.
+	glGenerateMipmap(GL_TEXTURE_2D);
+	D_OPENGL_CHECK_ERROR("glGenerateMipmap(GL_TEXTURE_2D);");
+
+	// Target -/-> Texture Unit 1
+	glBindTexture(GL_TEXTURE_2D, 0);
+	D_OPENGL_CHECK_ERROR("glBindTexture(GL_TEXTURE_2D, 0);");
+	glActiveTexture(GL_TEXTURE0);
+	D_OPENGL_CHECK_ERROR("glActiveTexture(GL_TEXTURE0);");
 }
 
-streamfx::gfx::mipmapper::mipmapper() : _gfx_util(::streamfx::gfx::util::get())
+static bool native_supports_format(gs_color_format format)
 {
-	auto gctx = streamfx::obs::gs::context();
+	switch (format) {
+	case GS_UNKNOWN:
+	case GS_DXT1:
+	case GS_DXT3:
+	case GS_DXT5:
+		return false;
+	default:
+		return true;
+	}
+}
 
-	{
-		auto file = streamfx::data_file_path("effects/mipgen.effect");
-		try {
-			_effect = streamfx::obs::gs::effect::create(file);
-		} catch (const std::exception& ex) {
-			DLOG_ERROR("Error loading '%s': %s", file.generic_u8string().c_str(), ex.what());
-		}
+static bool native_matches_render(gs_color_format format)
+{
+	// The effect filters 8-bit color in linear space when asked to, the backends filter whatever is stored.
+	if (!gs_get_linear_srgb()) {
+		return true;
+	}
+	switch (format) {
+	case GS_RGBA:
+	case GS_BGRA:
+	case GS_BGRX:
+		return false;
+	default:
+		return true;
 	}
 }
 
+streamfx::gfx::mipmapper::~mipmapper() {}
+
+streamfx::gfx::mipmapper::mipmapper() : _pyramid(::streamfx::gfx::pyramid::get()), _method(method::Automatic), _last_method(method::Automatic) {}
+
 uint32_t streamfx::gfx::mipmapper::calculate_max_mip_level(uint32_t width, uint32_t height)
 {
 	return static_cast<uint32_t>(1 + std::lroundl(floor(log2(std::max<GLint>(static_cast<GLint>(width), static_cast<GLint>(height))))));
 }
 
+void streamfx::gfx::mipmapper::set_method(method value)
+{
+	_method = value;
+}
+
+streamfx::gfx::mipmapper::method streamfx::gfx::mipmapper::get_last_method()
+{
+	return _last_method;
+}
+
+#ifdef ENABLE_PROFILING
+std::shared_ptr<streamfx::util::profiler> streamfx::gfx::mipmapper::get_profiler(std::size_t level)
+{
+	if (level >= _profilers.size()) {
+		_profilers.resize(level + 1);
+	}
+	if (!_profilers[level]) {
+		_profilers[level] = streamfx::util::profiler::create();
+	}
+	return _profilers[level];
+}
+#endif
+
 void streamfx::gfx::mipmapper::rebuild(std::shared_ptr<streamfx::obs::gs::texture> source, std::shared_ptr<streamfx::obs::gs::texture> target)
 {
 	{ // Validate arguments and structure.
 		if (!source || !target)
 			return; // Do nothing if source or target are missing.
 
-		if (!_effect)
-			return; // Do nothing if the necessary data failed to load.
-
 		// Ensure texture sizes match
 		if ((source->get_width() != target->get_width()) || (source->get_height() != target->get_height())) {
 			throw std::invalid_argument("source and target must have same size");
@@ -216,11 +296,6 @@ void streamfx::gfx::mipmapper::rebuild(std::shared_ptr<streamfx::obs::gs::textur
 	// Get a unique lock on the graphics context.
 	auto gctx = streamfx::obs::gs::context();
 
-	// Do we need to recreate the render target for a different format?
-	if ((!_rt) || (source->get_color_format() != _rt->get_color_format())) {
-		_rt = std::make_unique<streamfx::obs::gs::rendertarget>(source->get_color_format(), GS_ZS_NONE);
-	}
-
 	// Initialize API Handlers.
 	opengl_info oglinfo;
 	if (gs_get_device_type() == GS_DEVICE_OPENGL) {
@@ -243,6 +318,9 @@ void streamfx::gfx::mipmapper::rebuild(std::shared_ptr<streamfx::obs::gs::textur
 #if defined(ENABLE_PROFILING) && !defined(D_PLATFORM_MAC) && _DEBUG
 			auto cctr = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Mip Level %" PRId64 "", 0);
 #endif
+#ifdef ENABLE_PROFILING
+			auto profile = get_profiler(0)->track();
+#endif
 
 			// Retrieve maximum mip map level.
 #ifdef _WIN32
@@ -255,59 +333,84 @@ void streamfx::gfx::mipmapper::rebuild(std::shared_ptr<streamfx::obs::gs::textur
 			}
 		}
 
-		// Set up rendering state.
-		gs_blend_state_push();
-		gs_reset_blend_state();
-		gs_enable_blending(false);
-		gs_blend_function(GS_BLEND_ONE, GS_BLEND_ZERO);
-		gs_enable_color(true, true, true, true);
-		gs_enable_depth_test(false);
-		gs_enable_stencil_test(false);
-		gs_enable_stencil_write(false);
-		gs_set_cull_mode(GS_NEITHER);
-
-		// sRGB support.
-		bool old_srgb = gs_framebuffer_srgb_enabled();
-		gs_enable_framebuffer_srgb(gs_get_linear_srgb());
-
-		// Render each mip map level.
-		for (size_t mip = 1; mip < max_mip_level; mip++) {
+		// Let the backend generate the remaining levels if it can, and they'd be the same as rendering them.
+		_last_method = method::Render;
+		if ((max_mip_level > 1) && (_method != method::Render) && native_supports_format(source->get_color_format()) && ((_method == method::Native) || native_matches_render(source->get_color_format()))) {
 #if defined(ENABLE_PROFILING) && !defined(D_PLATFORM_MAC) && _DEBUG
-			auto cctr = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Mip Level %" PRIuMAX, mip);
+			auto cctr = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Mip Levels 1-%" PRIuMAX, max_mip_level - 1);
+#endif
+#ifdef ENABLE_PROFILING
+			auto profile = get_profiler(1)->track();
 #endif
 
-			uint32_t cwidth  = std::max<uint32_t>(width >> mip, 1);
-			uint32_t cheight = std::max<uint32_t>(height >> mip, 1);
-			float  iwidth  = 1.f / static_cast<float>(cwidth);
-			float  iheight = 1.f / static_cast<float>(cheight);
-
-			try {
-				auto op = _rt->render(cwidth, cheight);
-				gs_ortho(0, 1, 0, 1, 0, 1);
-
-				_effect.get_parameter("image").set_texture(target, gs_get_linear_srgb());
-				_effect.get_parameter("imageTexel").set_float2(iwidth, iheight);
-				_effect.get_parameter("level").set_int(int32_t(mip - 1));
-				while (gs_effect_loop(_effect.get_object(), "Draw")) {
-					_gfx_util->draw_fullscreen_triangle();
-				}
-			} catch (...) {
-			}
-
-			// Copy from the render target to the target mip level.
 #ifdef _WIN32
 			if (gs_get_device_type() == GS_DEVICE_DIRECT3D_11) {
-				d3d_copy_subregion(d3dinfo, _rt->get_texture(), static_cast<uint32_t>(mip), cwidth, cheight);
+				if (d3d_generate_mips(d3dinfo)) {
+					_last_method = method::Native;
+				}
 			}
 #endif
 			if (gs_get_device_type() == GS_DEVICE_OPENGL) {
-				opengl_copy_subregion(oglinfo, _rt->get_texture(), static_cast<uint32_t>(mip), cwidth, cheight);
+				opengl_generate_mips(oglinfo);
+				_last_method = method::Native;
 			}
+
+#ifdef ENABLE_PROFILING
+			if (_last_method != method::Native) {
+				profile->cancel();
+			}
+#endif
 		}
 
-		// Clean up rendering state.
-		gs_enable_framebuffer_srgb(old_srgb);
-		gs_blend_state_pop();
+		if (_last_method == method::Render) {
+			// Set up rendering state.
+			gs_blend_state_push();
+			gs_reset_blend_state();
+			gs_enable_blending(false);
+			gs_blend_function(GS_BLEND_ONE, GS_BLEND_ZERO);
+			gs_enable_color(true, true, true, true);
+			gs_enable_depth_test(false);
+			gs_enable_stencil_test(false);
+			gs_enable_stencil_write(false);
+			gs_set_cull_mode(GS_NEITHER);
+
+			// sRGB support.
+			bool old_srgb = gs_framebuffer_srgb_enabled();
+			gs_enable_framebuffer_srgb(gs_get_linear_srgb());
+
+			// Render each mip map level.
+			for (size_t mip = 1; mip < max_mip_level; mip++) {
+#if defined(ENABLE_PROFILING) && !defined(D_PLATFORM_MAC) && _DEBUG
+				auto cctr = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Mip Level %" PRIuMAX, mip);
+#endif
+#ifdef ENABLE_PROFILING
+				auto profile = get_profiler(mip)->track();
+#endif
+
+				uint32_t cwidth  = std::max<uint32_t>(width >> mip, 1);
+				uint32_t cheight = std::max<uint32_t>(height >> mip, 1);
+
+				// The pyramid may already have the level, if someone else asked for it this frame.
+				auto level = _pyramid->get_level(source, mip, streamfx::gfx::pyramid::filter::Box, source->get_color_format());
+				if (!level) {
+					break;
+				}
+
+				// Copy from the render target to the target mip level.
+#ifdef _WIN32
+				if (gs_get_device_type() == GS_DEVICE_DIRECT3D_11) {
+					d3d_copy_subregion(d3dinfo, level, static_cast<uint32_t>(mip), cwidth, cheight);
+				}
+#endif
+				if (gs_get_device_type() == GS_DEVICE_OPENGL) {
+					opengl_copy_subregion(oglinfo, level, static_cast<uint32_t>(mip), cwidth, cheight);
+				}
+			}
+
+			// Clean up rendering state.
+			gs_enable_framebuffer_srgb(old_srgb);
+			gs_blend_state_pop();
+		}
 
 	} else {
 		throw std::runtime_error("Only 2D Textures support Mip-mapping.");
@@ -4,11 +4,17 @@
 
 #pragma once
 #include "common.hpp"
+#include "gfx/gfx-pyramid.hpp"
 #include "gfx/gfx-util.hpp"
 #include "obs/gs/gs-effect.hpp"
 #include "obs/gs/gs-rendertarget.hpp"
 #include "obs/gs/gs-texture.hpp"
 #include "obs/gs/gs-vertexbuffer.hpp"
+#include "util/util-profiler.hpp"
+
+#include "warning-disable.hpp"
+#include <vector>
+#include "warning-enable.hpp"
 
 /* gs::mipmapper is an attempt at adding dynamic mip-map generation to a software
  *  which only supports static mip-maps. It is effectively an incredibly bad hack
@@ -20,13 +26,31 @@
  * 
  * So instead we render to a render target and copy from there to the actual
  *  resource. Super wasteful, but what else can we actually do?
+ *
+ * Well, let the backend do it whenever possible. Both APIs can generate mip-maps
+ *  on their own, as long as the texture and format allow for it. Rendering is
+ *  then only needed when the texture doesn't allow it.
  */
 
 namespace streamfx::gfx {
 	class mipmapper {
-		std::unique_ptr<streamfx::obs::gs::rendertarget> _rt;
-		streamfx::obs::gs::effect                        _effect;
-		std::shared_ptr<streamfx::gfx::util>             _gfx_util;
+		public:
+		enum class method {
+			/** Native if the backend supports it for the texture, otherwise Render. */
+			Automatic,
+			/** Let the backend generate all levels at once, falls back to Render if it can't. */
+			Native,
+			/** Render each level with the box filter of the pyramid and copy it into the texture. */
+			Render,
+		};
+
+		private:
+		std::shared_ptr<streamfx::gfx::pyramid> _pyramid;
+		method                                  _method;
+		method                                  _last_method;
+#ifdef ENABLE_PROFILING
+		std::vector<std::shared_ptr<streamfx::util::profiler>> _profilers;
+#endif
 
 		public:
 		~mipmapper();
@@ -34,6 +58,19 @@ namespace streamfx::gfx {
 
 		uint32_t calculate_max_mip_level(uint32_t width, uint32_t height);
 
+		void set_method(method value);
+
+		/** Method the last call to rebuild() actually used, which is never Automatic and may be Render after falling back. */
+		method get_last_method();
+
+#ifdef ENABLE_PROFILING
+		/** Time rebuild() spent on a level, measured on the CPU.
+		 *
+		 * Level 0 is the copy from the source. Native generation produces all other levels at once, which is tracked as level 1.
+		 */
+		std::shared_ptr<streamfx::util::profiler> get_profiler(std::size_t level);
+#endif
+
 		void rebuild(std::shared_ptr<streamfx::obs::gs::texture> source, std::shared_ptr<streamfx::obs::gs::texture> target);
 	};
 } // namespace streamfx::gfx
@@ -74,3 +74,17 @@ streamfx::gfx::opengl::~opengl()
 #endif
 	D_LOG_INFO("Finalized.", "");
 }
+
+static std::shared_ptr<streamfx::gfx::opengl> loader_instance;
+
+static auto loader = streamfx::loader(
+	"opengl",
+	[]() { // Initalizer
+		if (gs_get_device_type() == GS_DEVICE_OPENGL) {
+			loader_instance = streamfx::gfx::opengl::get();
+		}
+	},
+	[]() { // Finalizer
+		loader_instance.reset();
+	},
+	streamfx::loader_priority::HIGHEST, streamfx::loader_flags::GRAPHICS);
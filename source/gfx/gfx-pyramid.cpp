@@ -0,0 +1,180 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2023 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "gfx-pyramid.hpp"
+#include "obs/gs/gs-helper.hpp"
+#include "plugin.hpp"
+#include "util/util-logging.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <array>
+#include <mutex>
+#include "warning-enable.hpp"
+
+#ifdef _DEBUG
+#define ST_PREFIX "<%s> "
+#define D_LOG_ERROR(x, ...) P_LOG_ERROR(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_WARNING(x, ...) P_LOG_WARN(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_INFO(x, ...) P_LOG_INFO(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_DEBUG(x, ...) P_LOG_DEBUG(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#else
+#define ST_PREFIX "<gfx::pyramid> "
+#define D_LOG_ERROR(...) P_LOG_ERROR(ST_PREFIX __VA_ARGS__)
+#define D_LOG_WARNING(...) P_LOG_WARN(ST_PREFIX __VA_ARGS__)
+#define D_LOG_INFO(...) P_LOG_INFO(ST_PREFIX __VA_ARGS__)
+#define D_LOG_DEBUG(...) P_LOG_DEBUG(ST_PREFIX __VA_ARGS__)
+#endif
+
+// Parameters of mipgen.effect, same order as box_param_names.
+enum class box_param : std::size_t {
+	Image,
+	ImageTexel,
+	Level,
+};
+static constexpr std::array<const char*, 3> box_param_names = {"image", "imageTexel", "level"};
+
+// Parameters of blur/dual-filtering.effect, same order as dual_filtering_param_names.
+enum class dual_filtering_param : std::size_t {
+	Image,
+	ImageSize,
+	ImageTexel,
+};
+static constexpr std::array<const char*, 3> dual_filtering_param_names = {"pImage", "pImageSize", "pImageTexel"};
+
+streamfx::gfx::pyramid::pyramid() : _entries(), _gfx_util(::streamfx::gfx::util::get()), _rt_pool(::streamfx::gfx::rendertarget_pool::get())
+{
+	auto gctx = streamfx::obs::gs::context();
+
+	std::pair<const char*, streamfx::obs::gs::effect&> load_arr[] = {
+		{"effects/mipgen.effect", _box_effect},
+		{"effects/blur/dual-filtering.effect", _dual_filtering_effect},
+	};
+	for (auto& kv : load_arr) {
+		auto file = streamfx::data_file_path(kv.first);
+		try {
+			kv.second = streamfx::obs::gs::effect::create(file);
+		} catch (const std::exception& ex) {
+			D_LOG_ERROR("Error loading '%s': %s", file.generic_u8string().c_str(), ex.what());
+		}
+	}
+	_box_params.bind(_box_effect, box_param_names);
+	_dual_filtering_params.bind(_dual_filtering_effect, dual_filtering_param_names);
+
+	obs_add_tick_callback(&tick, this);
+}
+
+streamfx::gfx::pyramid::~pyramid()
+{
+	obs_remove_tick_callback(&tick, this);
+
+	auto gctx = streamfx::obs::gs::context();
+	_entries.clear();
+	_box_effect.reset();
+	_dual_filtering_effect.reset();
+}
+
+std::shared_ptr<streamfx::obs::gs::texture> streamfx::gfx::pyramid::get_level(std::shared_ptr<streamfx::obs::gs::texture> texture, std::size_t level, filter type, gs_color_format format)
+{
+	if (!texture || (level == 0)) {
+		return texture;
+	}
+
+	auto& effect = (type == filter::Box) ? _box_effect : _dual_filtering_effect;
+	if (!effect) {
+		return nullptr;
+	}
+
+	// Only the box filter follows the linear sRGB state, same as the mipmapper always did.
+	bool   srgb = (type == filter::Box) && gs_get_linear_srgb();
+	entry& item = _entries[std::make_tuple(texture->get_object(), texture->get_generation(), type, format, srgb)];
+	if (item.levels.size() < level) {
+		item.levels.resize(level);
+	}
+
+	if (item.built < level) {
+		gs_blend_state_push();
+		gs_reset_blend_state();
+		gs_enable_color(true, true, true, true);
+		gs_enable_blending(false);
+		gs_enable_depth_test(false);
+		gs_enable_stencil_test(false);
+		gs_enable_stencil_write(false);
+		gs_set_cull_mode(GS_NEITHER);
+		gs_blend_function(GS_BLEND_ONE, GS_BLEND_ZERO);
+
+		bool old_srgb = gs_framebuffer_srgb_enabled();
+		if (type == filter::Box) {
+			gs_enable_framebuffer_srgb(srgb);
+		}
+
+		uint32_t width  = texture->get_width();
+		uint32_t height = texture->get_height();
+		for (std::size_t n = item.built + 1; n <= level; n++) {
+#if defined(ENABLE_PROFILING) && !defined(D_PLATFORM_MAC) && _DEBUG
+			auto gdm = streamfx::obs::gs::debug_marker(streamfx::obs::gs::debug_color_azure_radiance, "Pyramid Level %" PRIuMAX, n);
+#endif
+
+			uint32_t owidth  = std::max<uint32_t>(width >> n, 1);
+			uint32_t oheight = std::max<uint32_t>(height >> n, 1);
+			auto&    rt      = item.levels[n - 1];
+			if (!rt) {
+				rt = _rt_pool->acquire(format, owidth, oheight);
+			}
+			auto input = (n > 1) ? item.levels[n - 2]->get_texture() : texture;
+
+			try {
+				auto op = rt->render(owidth, oheight);
+				gs_ortho(0, 1, 0, 1, 0, 1);
+
+				if (type == filter::Box) {
+					_box_params[box_param::Image].set_texture(input, srgb);
+					_box_params[box_param::ImageTexel].set_float2(1.f / static_cast<float>(owidth), 1.f / static_cast<float>(oheight));
+					_box_params[box_param::Level].set_int(0);
+					while (gs_effect_loop(effect.get_object(), "Draw")) {
+						_gfx_util->draw_fullscreen_triangle();
+					}
+				} else {
+					_dual_filtering_params[dual_filtering_param::Image].set_texture(input);
+					_dual_filtering_params[dual_filtering_param::ImageSize].set_float2(static_cast<float>(owidth), static_cast<float>(oheight));
+					_dual_filtering_params[dual_filtering_param::ImageTexel].set_float2(0.5f / static_cast<float>(owidth), 0.5f / static_cast<float>(oheight));
+					while (gs_effect_loop(effect.get_object(), "Down")) {
+						_gfx_util->draw_fullscreen_triangle();
+					}
+				}
+			} catch (const std::exception& ex) {
+				D_LOG_ERROR("Failed to build level %" PRIuMAX ": %s", n, ex.what());
+				break;
+			}
+
+			item.built = n;
+		}
+
+		gs_enable_framebuffer_srgb(old_srgb);
+		gs_blend_state_pop();
+	}
+
+	return (item.built >= level) ? item.levels[level - 1]->get_texture() : nullptr;
+}
+
+void streamfx::gfx::pyramid::tick(void* ptr, float) noexcept
+{
+	// Levels are only valid for a single frame, so hand their render targets back to the pool. This also happens if
+	// nobody renders anything, so that they can be reclaimed while sources are hidden.
+	reinterpret_cast<streamfx::gfx::pyramid*>(ptr)->_entries.clear();
+}
+
+std::shared_ptr<streamfx::gfx::pyramid> streamfx::gfx::pyramid::get()
+{
+	static std::weak_ptr<streamfx::gfx::pyramid> instance;
+	static std::mutex                            lock;
+
+	std::unique_lock<std::mutex> ul(lock);
+	if (instance.expired()) {
+		auto hard_instance = std::shared_ptr<streamfx::gfx::pyramid>(new streamfx::gfx::pyramid());
+		instance           = hard_instance;
+		return hard_instance;
+	}
+	return instance.lock();
+}
@@ -0,0 +1,72 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2023 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "common.hpp"
+#include "gfx/gfx-rendertarget-pool.hpp"
+#include "gfx/gfx-util.hpp"
+#include "obs/gs/gs-effect.hpp"
+#include "obs/gs/gs-rendertarget.hpp"
+#include "obs/gs/gs-texture.hpp"
+
+#include "warning-disable.hpp"
+#include <map>
+#include <memory>
+#include <tuple>
+#include <vector>
+#include "warning-enable.hpp"
+
+namespace streamfx::gfx {
+	/** Image pyramids, where every level is half the size of the level before it.
+	 *
+	 * Levels are built on demand from the level before them, and kept until the end of the frame in render targets
+	 * borrowed from the rendertarget_pool. Everyone who asks for the same texture, filter and format within a frame
+	 * shares a single set of draws, so no pyramid is built twice. Levels are identified by the texture they are built
+	 * from together with its generation, so re-rendering a render target, including one recycled by the pool, never
+	 * serves levels of its old content. Textures which do not come from a render target must not change during a
+	 * frame. Only usable within the graphics context.
+	 */
+	class pyramid {
+		public:
+		enum class filter {
+			/** Average of 2x2 texels, same as regular mip-maps. */
+			Box,
+			/** The down-sampling filter of the Dual Filtering blur. */
+			DualFiltering,
+		};
+
+		private:
+		typedef std::tuple<gs_texture_t*, uint64_t, filter, gs_color_format, bool> key_t;
+
+		struct entry {
+			std::vector<std::shared_ptr<streamfx::obs::gs::rendertarget>> levels;
+			std::size_t                                                   built; // Levels built this frame, excluding level 0.
+		};
+
+		std::map<key_t, entry>                            _entries;
+		streamfx::obs::gs::effect                         _box_effect;
+		streamfx::obs::gs::effect_bindings<3>             _box_params;
+		streamfx::obs::gs::effect                         _dual_filtering_effect;
+		streamfx::obs::gs::effect_bindings<3>             _dual_filtering_params;
+		std::shared_ptr<streamfx::gfx::util>              _gfx_util;
+		std::shared_ptr<streamfx::gfx::rendertarget_pool> _rt_pool;
+
+		pyramid();
+
+		public:
+		~pyramid();
+
+		/** A level of the pyramid built from texture, where level 0 is the texture itself.
+		 *
+		 * Any missing level up to the requested one is built in the given format. Levels never get smaller than 1x1.
+		 */
+		std::shared_ptr<streamfx::obs::gs::texture> get_level(std::shared_ptr<streamfx::obs::gs::texture> texture, std::size_t level, filter type, gs_color_format format);
+
+		private:
+		static void tick(void* ptr, float seconds) noexcept;
+
+		public: // Singleton
+		static std::shared_ptr<streamfx::gfx::pyramid> get();
+	};
+} // namespace streamfx::gfx
@@ -0,0 +1,148 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2023 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "gfx-rendertarget-pool.hpp"
+#include "obs/gs/gs-helper.hpp"
+#include "util/util-logging.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <mutex>
+#include "warning-enable.hpp"
+
+#ifdef _DEBUG
+#define ST_PREFIX "<%s> "
+#define D_LOG_ERROR(x, ...) P_LOG_ERROR(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_WARNING(x, ...) P_LOG_WARN(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_INFO(x, ...) P_LOG_INFO(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_DEBUG(x, ...) P_LOG_DEBUG(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#else
+#define ST_PREFIX "<gfx::rendertarget_pool> "
+#define D_LOG_ERROR(...) P_LOG_ERROR(ST_PREFIX __VA_ARGS__)
+#define D_LOG_WARNING(...) P_LOG_WARN(ST_PREFIX __VA_ARGS__)
+#define D_LOG_INFO(...) P_LOG_INFO(ST_PREFIX __VA_ARGS__)
+#define D_LOG_DEBUG(...) P_LOG_DEBUG(ST_PREFIX __VA_ARGS__)
+#endif
+
+#define ST_IDLE_FRAMES 60
+#define ST_REPORT_INTERVAL 10.f
+
+static uint64_t rendertarget_size(gs_color_format format, uint32_t width, uint32_t height)
+{
+	return (uint64_t(width) * uint64_t(height) * gs_get_format_bpp(format)) / 8;
+}
+
+streamfx::gfx::rendertarget_pool::rendertarget_pool() : _entries(), _statistics()
+{
+#ifdef ENABLE_PROFILING
+	_report_timer = 0;
+	_reported     = {};
+#endif
+
+	// Sources which are not shown are not rendered either, so the frames have to be counted from somewhere else.
+	obs_add_tick_callback(&tick, this);
+}
+
+streamfx::gfx::rendertarget_pool::~rendertarget_pool()
+{
+	obs_remove_tick_callback(&tick, this);
+
+	D_LOG_INFO("Lent out at most %zu render targets at once, out of at most %zu using %.2f MiB.", _statistics.lent_high_water, _statistics.count_high_water, static_cast<double_t>(_statistics.bytes_high_water) / 1048576.0);
+
+	auto gctx = streamfx::obs::gs::context();
+	_entries.clear();
+}
+
+std::shared_ptr<streamfx::obs::gs::rendertarget> streamfx::gfx::rendertarget_pool::acquire(gs_color_format format, uint32_t width, uint32_t height)
+{
+	std::shared_ptr<streamfx::obs::gs::rendertarget> rt;
+
+	auto key   = std::make_tuple(format, width, height);
+	auto range = _entries.equal_range(key);
+	for (auto iter = range.first; iter != range.second; ++iter) {
+		// Nobody but the pool holds on to it, so it's free to be lent out.
+		if (iter->second.rt.use_count() == 1) {
+			iter->second.idle = 0;
+			rt                = iter->second.rt;
+			break;
+		}
+	}
+
+	if (!rt) {
+		rt = std::make_shared<streamfx::obs::gs::rendertarget>(format, GS_ZS_NONE);
+		_entries.emplace(key, entry{rt, 0});
+	}
+
+	update_statistics();
+	return rt;
+}
+
+void streamfx::gfx::rendertarget_pool::next_frame(float seconds)
+{
+	for (auto iter = _entries.begin(); iter != _entries.end();) {
+		if (iter->second.rt.use_count() > 1) {
+			iter->second.idle = 0;
+			++iter;
+		} else if (++iter->second.idle > ST_IDLE_FRAMES) {
+			iter = _entries.erase(iter);
+		} else {
+			++iter;
+		}
+	}
+	update_statistics();
+
+#ifdef ENABLE_PROFILING
+	// Report every now and then, but only if something changed since.
+	if (_report_timer += seconds; _report_timer >= ST_REPORT_INTERVAL) {
+		_report_timer = 0;
+
+		if ((_statistics.count != _reported.count) || (_statistics.lent != _reported.lent) || (_statistics.bytes != _reported.bytes) || (_statistics.count_high_water != _reported.count_high_water)) {
+			D_LOG_INFO("%zu render targets using %.2f MiB, %zu of them lent out. At most %zu render targets using %.2f MiB, %zu of them lent out.", _statistics.count, static_cast<double_t>(_statistics.bytes) / 1048576.0, _statistics.lent, _statistics.count_high_water, static_cast<double_t>(_statistics.bytes_high_water) / 1048576.0, _statistics.lent_high_water);
+			_reported = _statistics;
+		}
+	}
+#endif
+}
+
+void streamfx::gfx::rendertarget_pool::update_statistics()
+{
+	_statistics.count = _entries.size();
+	_statistics.lent  = 0;
+	_statistics.bytes = 0;
+	for (auto& kv : _entries) {
+		if (kv.second.rt.use_count() > 1) {
+			_statistics.lent++;
+		}
+		_statistics.bytes += rendertarget_size(std::get<0>(kv.first), std::get<1>(kv.first), std::get<2>(kv.first));
+	}
+
+	_statistics.count_high_water = std::max(_statistics.count_high_water, _statistics.count);
+	_statistics.lent_high_water  = std::max(_statistics.lent_high_water, _statistics.lent);
+	_statistics.bytes_high_water = std::max(_statistics.bytes_high_water, _statistics.bytes);
+}
+
+void streamfx::gfx::rendertarget_pool::tick(void* ptr, float seconds) noexcept
+{
+	try {
+		reinterpret_cast<streamfx::gfx::rendertarget_pool*>(ptr)->next_frame(seconds);
+	} catch (const std::exception& ex) {
+		D_LOG_ERROR("Unexpected exception: %s", ex.what());
+	} catch (...) {
+		D_LOG_ERROR("Unexpected exception.", nullptr);
+	}
+}
+
+std::shared_ptr<streamfx::gfx::rendertarget_pool> streamfx::gfx::rendertarget_pool::get()
+{
+	static std::weak_ptr<streamfx::gfx::rendertarget_pool> instance;
+	static std::mutex                                      lock;
+
+	std::unique_lock<std::mutex> ul(lock);
+	if (instance.expired()) {
+		auto hard_instance = std::shared_ptr<streamfx::gfx::rendertarget_pool>(new streamfx::gfx::rendertarget_pool());
+		instance           = hard_instance;
+		return hard_instance;
+	}
+	return instance.lock();
+}
@@ -0,0 +1,68 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2023 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "common.hpp"
+#include "obs/gs/gs-rendertarget.hpp"
+
+#include "warning-disable.hpp"
+#include <map>
+#include <memory>
+#include <tuple>
+#include "warning-enable.hpp"
+
+namespace streamfx::gfx {
+	/** Render targets shared by everyone, so that scratch space only takes up memory while someone is using it.
+	 *
+	 * acquire() lends out a render target for as long as the returned pointer is held, which should be no longer than the
+	 * current frame. Render targets nobody has held for a number of frames are released, which is checked once per frame
+	 * even if nobody renders anything. Only usable from the graphics thread.
+	 */
+	class rendertarget_pool {
+		struct statistics {
+			std::size_t count;            // Render targets in the pool, lent out or not.
+			std::size_t count_high_water; // Highest count so far.
+			std::size_t lent;             // Render targets lent out right now.
+			std::size_t lent_high_water;  // Highest lent so far.
+			uint64_t    bytes;            // Approximate memory used by all render targets in the pool.
+			uint64_t    bytes_high_water; // Highest bytes so far.
+		};
+
+		typedef std::tuple<gs_color_format, uint32_t, uint32_t> key_t;
+
+		struct entry {
+			std::shared_ptr<streamfx::obs::gs::rendertarget> rt;
+			uint64_t                                         idle; // Frames since it was last lent out.
+		};
+
+		std::multimap<key_t, entry> _entries;
+		statistics                  _statistics;
+#ifdef ENABLE_PROFILING
+		float                       _report_timer;
+		statistics                  _reported;
+#endif
+
+		rendertarget_pool();
+
+		public:
+		~rendertarget_pool();
+
+		/** Borrow a render target with the given format, which must only ever be rendered at the given size.
+		 *
+		 * The render target is returned to the pool once the last copy of the pointer is gone. Its content is undefined
+		 * until it has been rendered to.
+		 */
+		std::shared_ptr<streamfx::obs::gs::rendertarget> acquire(gs_color_format format, uint32_t width, uint32_t height);
+
+		private:
+		void next_frame(float seconds);
+
+		void update_statistics();
+
+		static void tick(void* ptr, float seconds) noexcept;
+
+		public: // Singleton
+		static std::shared_ptr<streamfx::gfx::rendertarget_pool> get();
+	};
+} // namespace streamfx::gfx
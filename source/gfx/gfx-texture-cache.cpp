@@ -0,0 +1,164 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2023 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "gfx-texture-cache.hpp"
+#include "plugin.hpp"
+#include "util/util-logging.hpp"
+#include "util/util-platform.hpp"
+
+#include "warning-disable.hpp"
+#include <ios>
+#include "warning-enable.hpp"
+
+#ifdef _DEBUG
+#define ST_PREFIX "<%s> "
+#define D_LOG_ERROR(x, ...) P_LOG_ERROR(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_WARNING(x, ...) P_LOG_WARN(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_INFO(x, ...) P_LOG_INFO(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_DEBUG(x, ...) P_LOG_DEBUG(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#else
+#define ST_PREFIX "<gfx::texture_cache> "
+#define D_LOG_ERROR(...) P_LOG_ERROR(ST_PREFIX __VA_ARGS__)
+#define D_LOG_WARNING(...) P_LOG_WARN(ST_PREFIX __VA_ARGS__)
+#define D_LOG_INFO(...) P_LOG_INFO(ST_PREFIX __VA_ARGS__)
+#define D_LOG_DEBUG(...) P_LOG_DEBUG(ST_PREFIX __VA_ARGS__)
+#endif
+
+streamfx::gfx::texture_cache::entry::entry(const std::filesystem::path& path) : _path(path), _state(state::Loading), _lock(), _data(nullptr), _format(GS_UNKNOWN), _width(0), _height(0), _texture() {}
+
+streamfx::gfx::texture_cache::entry::~entry()
+{
+	if (_data) {
+		bfree(_data);
+	}
+}
+
+void streamfx::gfx::texture_cache::entry::decode()
+{
+	// Same as gs_texture_create_from_file(), minus the part that needs the graphics context.
+	auto            file   = streamfx::util::platform::native_to_utf8(_path).generic_u8string();
+	gs_color_format format = GS_UNKNOWN;
+	uint32_t        width  = 0;
+	uint32_t        height = 0;
+	uint8_t*        data   = gs_create_texture_file_data(file.c_str(), &format, &width, &height);
+	if (!data) {
+		D_LOG_WARNING("Failed to decode '%s'.", file.c_str());
+		_state = state::Failed;
+		return;
+	}
+
+	std::lock_guard<std::mutex> lg(_lock);
+	_data   = data;
+	_format = format;
+	_width  = width;
+	_height = height;
+	_state  = state::Decoded;
+}
+
+std::shared_ptr<streamfx::obs::gs::texture> streamfx::gfx::texture_cache::entry::get()
+{
+	if (_state == state::Decoded) {
+		std::lock_guard<std::mutex> lg(_lock);
+		if (_state == state::Decoded) {
+			try {
+				const uint8_t* mip_data[] = {_data};
+				_texture                  = std::make_shared<streamfx::obs::gs::texture>(_width, _height, _format, 1, mip_data, streamfx::obs::gs::texture::flags::None);
+				_state                    = state::Uploaded;
+			} catch (const std::exception& ex) {
+				D_LOG_WARNING("Failed to upload '%s': %s", _path.u8string().c_str(), ex.what());
+				_state = state::Failed;
+			}
+
+			// Nothing needs the decoded data anymore.
+			bfree(_data);
+			_data = nullptr;
+		}
+	}
+
+	return (_state == state::Uploaded) ? _texture : nullptr;
+}
+
+bool streamfx::gfx::texture_cache::entry::loading()
+{
+	auto value = _state.load();
+	return (value == state::Loading) || (value == state::Decoded);
+}
+
+bool streamfx::gfx::texture_cache::entry::failed()
+{
+	return _state == state::Failed;
+}
+
+streamfx::gfx::texture_cache::texture_cache() : _lock(), _entries(), _placeholder() {}
+
+streamfx::gfx::texture_cache::~texture_cache() = default;
+
+std::shared_ptr<streamfx::gfx::texture_cache::entry> streamfx::gfx::texture_cache::load(const std::filesystem::path& file)
+{
+	std::error_code ec;
+	auto            time = std::filesystem::last_write_time(file, ec);
+	if (ec) {
+		throw std::ios_base::failure(file.u8string());
+	}
+
+	std::shared_ptr<entry> item;
+	{
+		std::lock_guard<std::mutex> lg(_lock);
+
+		// Forget about anything no longer in use.
+		for (auto iter = _entries.begin(); iter != _entries.end();) {
+			if (iter->second.expired()) {
+				iter = _entries.erase(iter);
+			} else {
+				++iter;
+			}
+		}
+
+		auto key = std::make_pair(file, time);
+		if (auto kv = _entries.find(key); kv != _entries.end()) {
+			if (item = kv->second.lock(); item) {
+				return item;
+			}
+		}
+
+		item = std::shared_ptr<entry>(new entry(file));
+		_entries.insert_or_assign(key, item);
+	}
+
+	// If everyone lost interest before the task ran, there is no need to decode anything.
+	streamfx::threadpool()->push(
+		[weak = std::weak_ptr<entry>(item)](streamfx::util::threadpool::task_data_t) {
+			if (auto item = weak.lock(); item) {
+				item->decode();
+			}
+		},
+		nullptr, streamfx::util::threadpool::priority::BACKGROUND);
+
+	return item;
+}
+
+std::shared_ptr<streamfx::obs::gs::texture> streamfx::gfx::texture_cache::placeholder()
+{
+	std::lock_guard<std::mutex> lg(_lock);
+	if (!_placeholder) {
+		uint8_t        pixel[4]   = {0, 0, 0, 0};
+		const uint8_t* mip_data[] = {pixel};
+		_placeholder              = std::make_shared<streamfx::obs::gs::texture>(1u, 1u, GS_RGBA, 1u, mip_data, streamfx::obs::gs::texture::flags::None);
+	}
+	return _placeholder;
+}
+
+std::shared_ptr<streamfx::gfx::texture_cache> streamfx::gfx::texture_cache::get()
+{
+	static std::weak_ptr<streamfx::gfx::texture_cache> instance;
+	static std::mutex                                  lock;
+
+	std::unique_lock<std::mutex> ul(lock);
+	if (instance.expired()) {
+		auto hard_instance = std::shared_ptr<streamfx::gfx::texture_cache>(new streamfx::gfx::texture_cache());
+		instance           = hard_instance;
+		return hard_instance;
+	}
+	return instance.lock();
+}
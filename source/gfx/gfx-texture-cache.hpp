@@ -0,0 +1,90 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2023 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "common.hpp"
+#include "obs/gs/gs-texture.hpp"
+
+#include "warning-disable.hpp"
+#include <atomic>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include "warning-enable.hpp"
+
+namespace streamfx::gfx {
+	/** Loads image files into textures without stalling the render thread, and shares them between all users.
+	 *
+	 * Files are decoded on the threadpool, and uploaded by the first get() after that, which has to happen within the
+	 * graphics context. Entries are keyed by path and modification time, so a changed file is loaded anew while older
+	 * users keep what they have. An entry only lives as long as someone holds on to it.
+	 */
+	class texture_cache {
+		public:
+		class entry {
+			enum class state {
+				Loading,
+				Decoded,
+				Uploaded,
+				Failed,
+			};
+
+			std::filesystem::path _path;
+			std::atomic<state>    _state;
+
+			// Decoded data, only valid while Decoded.
+			std::mutex      _lock;
+			uint8_t*        _data;
+			gs_color_format _format;
+			uint32_t        _width;
+			uint32_t        _height;
+
+			std::shared_ptr<streamfx::obs::gs::texture> _texture;
+
+			public:
+			~entry();
+
+			private:
+			entry(const std::filesystem::path& path);
+
+			void decode();
+
+			public:
+			/** The texture, or nullptr while it is still loading or if loading failed. */
+			std::shared_ptr<streamfx::obs::gs::texture> get();
+
+			bool loading();
+
+			bool failed();
+
+			friend class texture_cache;
+		};
+
+		private:
+		std::mutex _lock;
+		std::map<std::pair<std::filesystem::path, std::filesystem::file_time_type>, std::weak_ptr<entry>> _entries;
+
+		std::shared_ptr<streamfx::obs::gs::texture> _placeholder;
+
+		public:
+		~texture_cache();
+
+		private:
+		texture_cache();
+
+		public:
+		/** Look up a file, and start loading it if nobody else has it loaded already.
+		 *
+		 * Throws if the file can not be accessed.
+		 */
+		std::shared_ptr<entry> load(const std::filesystem::path& file);
+
+		/** A fully transparent texture to show in place of one that is still loading. */
+		std::shared_ptr<streamfx::obs::gs::texture> placeholder();
+
+		public /* Singleton */:
+		static std::shared_ptr<streamfx::gfx::texture_cache> get();
+	};
+} // namespace streamfx::gfx
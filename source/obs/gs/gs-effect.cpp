@@ -5,86 +5,226 @@
 
 #include "gs-effect.hpp"
 #include "obs/gs/gs-helper.hpp"
+#include "plugin.hpp"
 #include "util/util-platform.hpp"
 
 #include "warning-disable.hpp"
+#include <atomic>
 #include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <map>
+#include <mutex>
 #include <sstream>
 #include <stdexcept>
+#include <tuple>
 #include <vector>
 #include "warning-enable.hpp"
 
 #define MAX_EFFECT_SIZE 32 * 1024 * 1024 // 32 MiB, big enough for everything.
 
-static std::string load_file_as_code(const std::filesystem::path& shader_file, bool is_top_level = true)
+namespace {
+	typedef std::vector<std::pair<std::filesystem::path, std::filesystem::file_time_type>> effect_files_t;
+
+	struct effect_source {
+		std::string    code;
+		effect_files_t files; // The file itself and everything it includes, as they were when loaded.
+	};
+
+	struct effect_cache {
+		std::mutex                                                            lock;
+		std::map<std::filesystem::path, std::shared_ptr<const effect_source>> sources;
+		std::map<std::tuple<std::filesystem::path, int, std::string>, std::pair<std::shared_ptr<const effect_source>, std::shared_ptr<gs_effect_t>>> effects;
+
+		static effect_cache& instance()
+		{
+			static effect_cache cache;
+			return cache;
+		}
+	};
+} // namespace
+
+static bool is_current(const effect_files_t& files)
+{
+	for (auto& file : files) {
+		std::error_code ec;
+		if ((std::filesystem::last_write_time(file.first, ec) != file.second) || ec) {
+			return false;
+		}
+	}
+	return true;
+}
+
+#ifdef ENABLE_EFFECT_DISK_CACHE
+static std::filesystem::path disk_cache_path(const std::filesystem::path& file)
+{
+	// FNV-1a of the path, so that every effect has its own file.
+	uint64_t hash = 0xCBF29CE484222325ull;
+	for (char ch : file.generic_u8string()) {
+		hash ^= static_cast<uint8_t>(ch);
+		hash *= 0x100000001B3ull;
+	}
+
+	std::stringstream name;
+	name << "cache/effects/" << std::hex << std::setw(16) << std::setfill('0') << hash << ".effect";
+	return streamfx::config_file_path(name.str());
+}
+
+static std::shared_ptr<const effect_source> load_from_disk(const std::filesystem::path& file)
+{
+	// Layout: Number of files, then one line per file with its modification time and path, then the code.
+	std::ifstream ifs(disk_cache_path(file), std::ios::in | std::ios::binary);
+	if (!ifs.is_open() || ifs.bad()) {
+		return nullptr;
+	}
+
+	auto        source = std::make_shared<effect_source>();
+	std::size_t count  = 0;
+	if (!(ifs >> count) || (count == 0)) {
+		return nullptr;
+	}
+	for (std::size_t idx = 0; idx < count; idx++) {
+		std::filesystem::file_time_type::rep time = 0;
+		std::string                          path;
+		if (!(ifs >> time) || !std::getline(ifs >> std::ws, path)) {
+			return nullptr;
+		}
+		source->files.emplace_back(std::filesystem::u8path(path), std::filesystem::file_time_type(std::filesystem::file_time_type::duration(time)));
+	}
+	if ((source->files.front().first != file) || !is_current(source->files)) {
+		return nullptr;
+	}
+
+	source->code.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+	return source;
+}
+
+static void save_to_disk(const std::filesystem::path& file, const effect_source& source)
+{
+	try {
+		auto path = disk_cache_path(file);
+		std::filesystem::create_directories(path.parent_path());
+
+		std::ofstream ofs(path, std::ios::out | std::ios::binary | std::ios::trunc);
+		ofs << source.files.size() << '\n';
+		for (auto& entry : source.files) {
+			ofs << entry.second.time_since_epoch().count() << ' ' << entry.first.generic_u8string() << '\n';
+		}
+		ofs << source.code;
+	} catch (...) {
+		// Only a cache, the next load will just pre-process the file again.
+	}
+}
+#endif
+
+static std::shared_ptr<const effect_source> load_file_as_code(const std::filesystem::path& shader_file, bool is_top_level = true)
 {
-	std::stringstream           shader_stream;
 	const std::filesystem::path shader_path = std::filesystem::absolute(shader_file.native());
 	const std::filesystem::path shader_root = std::filesystem::path(shader_path.native()).remove_filename();
 
+	// Includes such as shared.effect are used by almost everything, so only pre-process each file once.
+	auto& cache = effect_cache::instance();
+	{
+		std::lock_guard<std::mutex> lg(cache.lock);
+		if (auto kv = cache.sources.find(shader_path); (kv != cache.sources.end()) && is_current(kv->second->files)) {
+			return kv->second;
+		}
+	}
+
+#ifdef ENABLE_EFFECT_DISK_CACHE
+	if (is_top_level) {
+		if (auto source = load_from_disk(shader_path); source) {
+			std::lock_guard<std::mutex> lg(cache.lock);
+			cache.sources[shader_path] = source;
+			return source;
+		}
+	}
+#endif
+
 	// Ensure it meets size limits.
 	uintmax_t size = std::filesystem::file_size(shader_path);
 	if (size > MAX_EFFECT_SIZE) {
 		throw std::runtime_error("File is too large to be loaded.");
 	}
 
-	// Try to open as-is.
-	std::ifstream ifs(shader_path, std::ios::in);
-	if (!ifs.is_open() || ifs.bad()) {
-		throw std::runtime_error("Failed to open file.");
-	}
+	auto source = std::make_shared<effect_source>();
+	source->files.emplace_back(shader_path, std::filesystem::last_write_time(shader_path));
 
-	// Push Graphics API to shader.
-	if (is_top_level) {
-		auto gctx = streamfx::obs::gs::context();
-		switch (gs_get_device_type()) {
-		case GS_DEVICE_DIRECT3D_11:
-			shader_stream << "#define GS_DEVICE_DIRECT3D_11" << std::endl;
-			shader_stream << "#define GS_DEVICE_DIRECT3D" << std::endl;
-			break;
-		case GS_DEVICE_OPENGL:
-			shader_stream << "#define GS_DEVICE_OPENGL" << std::endl;
-			break;
+	// Try to open as-is, and read it in one go.
+	std::string content;
+	{
+		std::ifstream ifs(shader_path, std::ios::in);
+		if (!ifs.is_open() || ifs.bad()) {
+			throw std::runtime_error("Failed to open file.");
 		}
+		content.reserve(static_cast<std::size_t>(size));
+		content.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
 	}
+	source->code.reserve(content.size());
 
 	// Pre-process the shader.
-	std::string line;
-	while (std::getline(ifs, line)) {
-		std::string line_trimmed = line;
-
-		{ // Figure out the length of the trim.
-			size_t trim_length = 0;
-			for (size_t idx = 0, edx = line_trimmed.length(); idx < edx; idx++) {
-				char ch = line_trimmed.at(idx);
-				if ((ch != ' ') && (ch != '\t')) {
-					trim_length = idx;
-					break;
-				}
-			}
-			if (trim_length > 0) {
-				line_trimmed.erase(0, trim_length);
-			}
-		}
+	for (std::size_t pos = 0; pos < content.size();) {
+		std::size_t      end  = std::min(content.find('\n', pos), content.size());
+		std::string_view line = std::string_view(content).substr(pos, end - pos);
+		pos                   = end + 1;
 
 		// Handle '#include'
+		std::string_view line_trimmed = line.substr(std::min(line.find_first_not_of(" \t"), line.size()));
 		if (line_trimmed.substr(0, 8) == "#include") {
-			std::string           include_str  = line_trimmed.substr(10, line_trimmed.size() - 11); // '#include "'
+			std::string           include_str  = std::string(line_trimmed.substr(10, line_trimmed.size() - 11)); // '#include "'
 			std::filesystem::path include_path = include_str;
 
 			if (!include_path.is_absolute()) {
 				include_path = shader_root / include_str;
 			}
 
-			line = load_file_as_code(include_path, false);
+			auto include = load_file_as_code(include_path, false);
+			source->code.append(include->code);
+			source->files.insert(source->files.end(), include->files.begin(), include->files.end());
+		} else {
+			source->code.append(line);
 		}
+		source->code.push_back('\n');
+	}
 
-		shader_stream << line << std::endl;
+#ifdef ENABLE_EFFECT_DISK_CACHE
+	if (is_top_level) {
+		save_to_disk(shader_path, *source);
 	}
+#endif
+
+	std::lock_guard<std::mutex> lg(cache.lock);
+	cache.sources[shader_path] = source;
+	return source;
+}
+
+static int device_type()
+{
+	auto gctx = streamfx::obs::gs::context();
+	return gs_get_device_type();
+}
 
-	return shader_stream.str();
+static std::string device_defines(int device)
+{
+	// Push Graphics API to shader.
+	switch (device) {
+	case GS_DEVICE_DIRECT3D_11:
+		return "#define GS_DEVICE_DIRECT3D_11\n#define GS_DEVICE_DIRECT3D\n";
+	case GS_DEVICE_OPENGL:
+		return "#define GS_DEVICE_OPENGL\n";
+	}
+	return {};
 }
 
+#ifdef ENABLE_PROFILING
+static std::atomic<uint64_t> parameter_lookups{0};
+
+uint64_t streamfx::obs::gs::effect::lookup_count()
+{
+	return parameter_lookups.load(std::memory_order_relaxed);
+}
+#endif
+
 streamfx::obs::gs::effect::effect(std::string_view code, std::string_view name)
 {
 	auto gctx = streamfx::obs::gs::context();
@@ -99,7 +239,9 @@ streamfx::obs::gs::effect::effect(std::string_view code, std::string_view name)
 	reset(effect, [](gs_effect_t* ptr) { gs_effect_destroy(ptr); });
 }
 
-streamfx::obs::gs::effect::effect(std::filesystem::path file) : effect(load_file_as_code(file), streamfx::util::platform::utf8_to_native(std::filesystem::absolute(file)).generic_u8string()) {}
+streamfx::obs::gs::effect::effect(std::filesystem::path file) : effect(device_defines(device_type()) + load_file_as_code(file)->code, streamfx::util::platform::utf8_to_native(std::filesystem::absolute(file)).generic_u8string()) {}
+
+streamfx::obs::gs::effect::effect(std::shared_ptr<gs_effect_t> effect) : std::shared_ptr<gs_effect_t>(std::move(effect)) {}
 
 streamfx::obs::gs::effect::~effect()
 {
@@ -107,6 +249,38 @@ streamfx::obs::gs::effect::~effect()
 	reset();
 }
 
+streamfx::obs::gs::effect streamfx::obs::gs::effect::create(const std::filesystem::path& file)
+{
+	return create(file, {});
+}
+
+streamfx::obs::gs::effect streamfx::obs::gs::effect::create(const std::filesystem::path& file, const std::list<std::string>& defines)
+{
+	std::string prefix;
+	for (auto& define : defines) {
+		prefix.append("#define ").append(define).push_back('\n');
+	}
+
+	auto& cache  = effect_cache::instance();
+	auto  source = load_file_as_code(file);
+	auto  key    = std::make_tuple(std::filesystem::absolute(file), device_type(), prefix);
+
+	{ // Reuse the compiled effect if nothing changed since it was compiled.
+		std::lock_guard<std::mutex> lg(cache.lock);
+		if (auto kv = cache.effects.find(key); (kv != cache.effects.end()) && (kv->second.first == source)) {
+			return streamfx::obs::gs::effect(kv->second.second);
+		}
+	}
+
+	streamfx::obs::gs::effect effect{device_defines(std::get<1>(key)) + prefix + source->code, streamfx::util::platform::utf8_to_native(std::get<0>(key)).generic_u8string()};
+
+	// libobs keeps every effect compiled from a file until it shuts down, so hold on to it even while nobody uses it.
+	// Otherwise adding the same filter again would compile and keep yet another copy.
+	std::lock_guard<std::mutex> lg(cache.lock);
+	cache.effects[key] = {source, effect};
+	return effect;
+}
+
 std::size_t streamfx::obs::gs::effect::count_techniques()
 {
 	return static_cast<size_t>(get()->techniques.num);
@@ -156,6 +330,9 @@ streamfx::obs::gs::effect_parameter streamfx::obs::gs::effect::get_parameter(std
 
 streamfx::obs::gs::effect_parameter streamfx::obs::gs::effect::get_parameter(std::string_view name)
 {
+#ifdef ENABLE_PROFILING
+	parameter_lookups.fetch_add(1, std::memory_order_relaxed);
+#endif
 	for (std::size_t idx = 0; idx < count_parameters(); idx++) {
 		auto ptr = get()->params.array + idx;
 		if (strcmp(ptr->name, name.data()) == 0) {
@@ -180,3 +357,15 @@ bool streamfx::obs::gs::effect::has_parameter(std::string_view name, effect_para
 		return eprm.get_type() == type;
 	return false;
 }
+
+static auto loader = streamfx::loader(
+	"gs-effect-cache",
+	[]() { // Initalizer
+	},
+	[]() { // Finalizer
+		auto&                       cache = effect_cache::instance();
+		std::lock_guard<std::mutex> lg(cache.lock);
+		cache.effects.clear();
+		cache.sources.clear();
+	},
+	streamfx::loader_priority::HIGHEST, streamfx::loader_flags::GRAPHICS); // Finalized last, after everything that uses effects.
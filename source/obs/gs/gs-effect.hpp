@@ -9,8 +9,10 @@
 #include "gs-effect-technique.hpp"
 
 #include "warning-disable.hpp"
+#include <array>
 #include <filesystem>
 #include <list>
+#include <type_traits>
 #include "warning-enable.hpp"
 
 namespace streamfx::obs::gs {
@@ -21,6 +23,11 @@ namespace streamfx::obs::gs {
 		effect(std::filesystem::path file);
 		~effect();
 
+		private:
+		effect(std::shared_ptr<gs_effect_t> effect);
+
+		public:
+
 		std::size_t                         count_techniques();
 		streamfx::obs::gs::effect_technique get_technique(std::size_t idx);
 		streamfx::obs::gs::effect_technique get_technique(std::string_view name);
@@ -32,6 +39,12 @@ namespace streamfx::obs::gs {
 		bool                                has_parameter(std::string_view name);
 		bool                                has_parameter(std::string_view name, effect_parameter::type type);
 
+#ifdef ENABLE_PROFILING
+		public:
+		/** Total number of parameters looked up by name so far, on any effect. */
+		static uint64_t lookup_count();
+#endif
+
 		public /* Legacy Support */:
 		inline gs_effect_t* get_object()
 		{
@@ -45,12 +58,73 @@ namespace streamfx::obs::gs {
 
 		static streamfx::obs::gs::effect create(std::string_view file)
 		{
-			return streamfx::obs::gs::effect(std::filesystem::path(file));
+			return create(std::filesystem::path(file));
 		};
 
-		static streamfx::obs::gs::effect create(const std::filesystem::path& file)
+		/** Load an effect from a file, sharing the compiled effect with everyone else who loaded the same file.
+		 *
+		 * Parameter values are shared as well, so set everything the technique uses before each draw. Use the
+		 * constructor instead for a private copy. Compiled effects are kept until StreamFX is unloaded.
+		 */
+		static streamfx::obs::gs::effect create(const std::filesystem::path& file);
+
+		/** Same as create(file), but with the given names #define'd ahead of the code.
+		 *
+		 * Every distinct list of defines is compiled and shared separately, which lets one file provide many
+		 * permutations of a shader without paying for the ones nobody uses.
+		 */
+		static streamfx::obs::gs::effect create(const std::filesystem::path& file, const std::list<std::string>& defines);
+	};
+
+	/** Parameters of an effect, looked up by name once and then addressed by index.
+	 *
+	 * The names are declared at compile time next to an enum which indexes them, for example:
+	 *
+	 *   enum class param : std::size_t { Image, Size };
+	 *   static constexpr std::array<const char*, 2> param_names = {"Image", "Size"};
+	 *   streamfx::obs::gs::effect_bindings<2> params{effect, param_names};
+	 *   params[param::Size].set_float2(width, height);
+	 *
+	 * Parameters the effect does not have are left empty, check with has() before using optional ones. Rebind whenever
+	 * the effect is reloaded.
+	 */
+	template<std::size_t N>
+	class effect_bindings {
+		std::array<streamfx::obs::gs::effect_parameter, N> _params;
+
+		public:
+		effect_bindings() = default;
+
+		effect_bindings(streamfx::obs::gs::effect& effect, const std::array<const char*, N>& names)
 		{
-			return streamfx::obs::gs::effect(file);
-		};
+			bind(effect, names);
+		}
+
+		void bind(streamfx::obs::gs::effect& effect, const std::array<const char*, N>& names)
+		{
+			for (std::size_t idx = 0; idx < N; idx++) {
+				_params[idx] = effect ? effect.get_parameter(names[idx]) : streamfx::obs::gs::effect_parameter();
+			}
+		}
+
+		void reset()
+		{
+			for (auto& param : _params) {
+				param = streamfx::obs::gs::effect_parameter();
+			}
+		}
+
+		template<typename E>
+		inline bool has(E idx) const
+		{
+			return static_cast<bool>(_params[static_cast<std::size_t>(idx)]);
+		}
+
+		template<typename E>
+		inline streamfx::obs::gs::effect_parameter& operator[](E idx)
+		{
+			static_assert(std::is_enum_v<E> || std::is_integral_v<E>, "Parameters are addressed by enum or index.");
+			return _params[static_cast<std::size_t>(idx)];
+		}
 	};
 } // namespace streamfx::obs::gs
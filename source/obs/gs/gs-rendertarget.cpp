@@ -10,13 +10,25 @@
 #include <stdexcept>
 #include "warning-enable.hpp"
 
+// Shared by all render targets, so that a render target handed to someone else never repeats a generation.
+static uint64_t generation_counter = 0;
+
+#ifdef ENABLE_PROFILING
+static uint64_t pass_counter = 0;
+
+uint64_t streamfx::obs::gs::rendertarget::pass_count()
+{
+	return pass_counter;
+}
+#endif
+
 streamfx::obs::gs::rendertarget::~rendertarget()
 {
 	auto gctx = streamfx::obs::gs::context();
 	gs_texrender_destroy(_render_target);
 }
 
-streamfx::obs::gs::rendertarget::rendertarget(gs_color_format colorFormat, gs_zstencil_format zsFormat) : _color_format(colorFormat), _zstencil_format(zsFormat)
+streamfx::obs::gs::rendertarget::rendertarget(gs_color_format colorFormat, gs_zstencil_format zsFormat) : _color_format(colorFormat), _zstencil_format(zsFormat), _generation(0)
 {
 	_is_being_rendered = false;
 	auto gctx          = streamfx::obs::gs::context();
@@ -45,22 +57,22 @@ gs_texture_t* streamfx::obs::gs::rendertarget::get_object()
 
 std::shared_ptr<streamfx::obs::gs::texture> streamfx::obs::gs::rendertarget::get_texture()
 {
-	return std::make_shared<streamfx::obs::gs::texture>(get_object(), false);
+	return std::make_shared<streamfx::obs::gs::texture>(get_object(), false, _generation);
 }
 
 void streamfx::obs::gs::rendertarget::get_texture(streamfx::obs::gs::texture& tex)
 {
-	tex = streamfx::obs::gs::texture(get_object(), false);
+	tex = streamfx::obs::gs::texture(get_object(), false, _generation);
 }
 
 void streamfx::obs::gs::rendertarget::get_texture(std::shared_ptr<streamfx::obs::gs::texture>& tex)
 {
-	tex = std::make_shared<streamfx::obs::gs::texture>(get_object(), false);
+	tex = std::make_shared<streamfx::obs::gs::texture>(get_object(), false, _generation);
 }
 
 void streamfx::obs::gs::rendertarget::get_texture(std::unique_ptr<streamfx::obs::gs::texture>& tex)
 {
-	tex = std::make_unique<streamfx::obs::gs::texture>(get_object(), false);
+	tex = std::make_unique<streamfx::obs::gs::texture>(get_object(), false, _generation);
 }
 
 gs_color_format streamfx::obs::gs::rendertarget::get_color_format()
@@ -86,6 +98,10 @@ streamfx::obs::gs::rendertarget_op::rendertarget_op(streamfx::obs::gs::rendertar
 		throw std::runtime_error("Failed to begin rendering to render target.");
 	}
 	parent->_is_being_rendered = true;
+	parent->_generation        = ++generation_counter;
+#ifdef ENABLE_PROFILING
+	pass_counter++;
+#endif
 }
 
 streamfx::obs::gs::rendertarget_op::rendertarget_op(streamfx::obs::gs::rendertarget* rt, uint32_t width, uint32_t height, gs_color_space cs) : parent(rt)
@@ -101,6 +117,10 @@ streamfx::obs::gs::rendertarget_op::rendertarget_op(streamfx::obs::gs::rendertar
 		throw std::runtime_error("Failed to begin rendering to render target.");
 	}
 	parent->_is_being_rendered = true;
+	parent->_generation        = ++generation_counter;
+#ifdef ENABLE_PROFILING
+	pass_counter++;
+#endif
 }
 
 streamfx::obs::gs::rendertarget_op::rendertarget_op(streamfx::obs::gs::rendertarget_op&& r) noexcept
@@ -20,6 +20,8 @@ namespace streamfx::obs::gs {
 		gs_color_format    _color_format;
 		gs_zstencil_format _zstencil_format;
 
+		uint64_t _generation;
+
 		public:
 		~rendertarget();
 
@@ -42,6 +44,13 @@ namespace streamfx::obs::gs {
 		streamfx::obs::gs::rendertarget_op render(uint32_t width, uint32_t height);
 
 		streamfx::obs::gs::rendertarget_op render(uint32_t width, uint32_t height, gs_color_space cs);
+
+#ifdef ENABLE_PROFILING
+		public:
+		/** Total number of passes started on any render target so far. Only changes on the graphics thread.
+		 */
+		static uint64_t pass_count();
+#endif
 	};
 
 	class rendertarget_op {
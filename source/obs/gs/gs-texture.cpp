@@ -194,3 +194,8 @@ gs_color_format streamfx::obs::gs::texture::get_color_format()
 {
 	return gs_texture_get_color_format(_texture);
 }
+
+uint64_t streamfx::obs::gs::texture::get_generation()
+{
+	return _generation;
+}
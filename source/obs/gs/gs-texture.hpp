@@ -20,8 +20,9 @@ namespace streamfx::obs::gs {
 
 		protected:
 		gs_texture_t* _texture;
-		bool          _is_owner = true;
-		type          _type     = type::Normal;
+		bool          _is_owner   = true;
+		type          _type       = type::Normal;
+		uint64_t      _generation = 0;
 
 		public:
 		~texture();
@@ -76,8 +77,10 @@ namespace streamfx::obs::gs {
 
 		/*!
 		* \brief Create a texture from an existing gs_texture_t object.
+		*
+		* \param generation Identifies the content of tex, see get_generation().
 		*/
-		texture(gs_texture_t* tex, bool takeOwnership = false) : _texture(tex), _is_owner(takeOwnership) {}
+		texture(gs_texture_t* tex, bool takeOwnership = false, uint64_t generation = 0) : _texture(tex), _is_owner(takeOwnership), _generation(generation) {}
 
 		void load(int32_t unit);
 
@@ -92,6 +95,14 @@ namespace streamfx::obs::gs {
 		streamfx::obs::gs::texture::type get_type();
 
 		gs_color_format get_color_format();
+
+		/*!
+		* \brief Identifies the content of the texture.
+		*
+		* Textures retrieved from a render target get a new generation every time it is rendered to, even if the
+		* underlying gs_texture_t is reused. Any other texture is 0.
+		*/
+		uint64_t get_generation();
 	};
 } // namespace streamfx::obs::gs
 
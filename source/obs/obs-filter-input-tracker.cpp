@@ -0,0 +1,113 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2023 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "obs-filter-input-tracker.hpp"
+
+static constexpr const char* tracked_signals[] = {"update", "enable"};
+
+streamfx::obs::filter_input_tracker::filter_input_tracker(obs_source_t* filter) : _filter(filter), _generation(0), _sources(), _chain() {}
+
+streamfx::obs::filter_input_tracker::~filter_input_tracker()
+{
+	disconnect();
+}
+
+void streamfx::obs::filter_input_tracker::invalidate()
+{
+	_generation.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool streamfx::obs::filter_input_tracker::signature(bool paused_media, uint64_t& signature)
+{
+	obs_source_t* parent = obs_filter_get_parent(_filter);
+	obs_source_t* target = obs_filter_get_target(_filter);
+	if (!parent || !target) {
+		return false;
+	}
+
+	// Filters may be added, removed or moved at any time, so follow along with whatever is before us now.
+	_chain.clear();
+	for (obs_source_t* source = target; source; source = obs_filter_get_target(source)) {
+		_chain.push_back(source);
+		if (source == parent) {
+			break;
+		}
+	}
+	bool changed = (_chain.size() != _sources.size());
+	for (std::size_t idx = 0; !changed && (idx < _chain.size()); idx++) {
+		changed = (_chain[idx] != _sources[idx].first);
+	}
+	if (changed) {
+		disconnect();
+		connect();
+		invalidate();
+	}
+
+	// FNV-1a, this only has to tell apart consecutive frames.
+	signature = 0xCBF29CE484222325ull;
+	auto hash = [&signature](const void* data, std::size_t size) {
+		for (std::size_t idx = 0; idx < size; idx++) {
+			signature ^= reinterpret_cast<const uint8_t*>(data)[idx];
+			signature *= 0x100000001B3ull;
+		}
+	};
+
+	uint32_t size[2] = {obs_source_get_base_width(target), obs_source_get_base_height(target)};
+	hash(size, sizeof(size));
+
+	if (paused_media) {
+		// Only media which is not playing is known to not change on its own, and only without other filters before us.
+		if ((target != parent) || ((obs_source_get_output_flags(parent) & OBS_SOURCE_CONTROLLABLE_MEDIA) == 0)) {
+			return false;
+		}
+
+		switch (obs_source_media_get_state(parent)) {
+		case OBS_MEDIA_STATE_PAUSED:
+		case OBS_MEDIA_STATE_STOPPED:
+		case OBS_MEDIA_STATE_ENDED:
+			break;
+		default:
+			return false;
+		}
+
+		int64_t time = obs_source_media_get_time(parent);
+		hash(&time, sizeof(time));
+	}
+
+	// Beyond that, the source and any filters before us are assumed to only change along with their settings.
+	uint64_t generation = _generation.load(std::memory_order_relaxed);
+	hash(&generation, sizeof(generation));
+
+	return true;
+}
+
+void streamfx::obs::filter_input_tracker::connect()
+{
+	for (obs_source_t* source : _chain) {
+		signal_handler_t* sh = obs_source_get_signal_handler(source);
+		for (const char* name : tracked_signals) {
+			signal_handler_connect(sh, name, &handle_change, this);
+		}
+		_sources.emplace_back(source, ::streamfx::obs::weak_source{source});
+	}
+}
+
+void streamfx::obs::filter_input_tracker::disconnect()
+{
+	for (auto& kv : _sources) {
+		// Sources which are already gone took their signal handler with them.
+		if (auto source = kv.second.lock(); source) {
+			signal_handler_t* sh = obs_source_get_signal_handler(source.get());
+			for (const char* name : tracked_signals) {
+				signal_handler_disconnect(sh, name, &handle_change, this);
+			}
+		}
+	}
+	_sources.clear();
+}
+
+void streamfx::obs::filter_input_tracker::handle_change(void* ptr, calldata_t*) noexcept
+{
+	reinterpret_cast<::streamfx::obs::filter_input_tracker*>(ptr)->invalidate();
+}
@@ -0,0 +1,51 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2023 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "common.hpp"
+#include "obs/obs-weak-source.hpp"
+
+#include "warning-disable.hpp"
+#include <atomic>
+#include <utility>
+#include <vector>
+#include "warning-enable.hpp"
+
+namespace streamfx::obs {
+	/** Tells apart an unchanged filter input from a new one, without ever looking at the settings themselves.
+	 *
+	 * Every change to the settings of the parent source or of a filter before this one is counted through their
+	 * "update" and "enable" signals. The owning filter should call invalidate() from its own update(). Signals may
+	 * arrive on any thread, while signature() must only be called from the video thread.
+	 */
+	class filter_input_tracker {
+		obs_source_t*         _filter;
+		std::atomic<uint64_t> _generation;
+
+		// Sources we are connected to, in order from the closest filter to the parent.
+		std::vector<std::pair<obs_source_t*, ::streamfx::obs::weak_source>> _sources;
+		std::vector<obs_source_t*>                                          _chain;
+
+		public:
+		filter_input_tracker(obs_source_t* filter);
+		~filter_input_tracker();
+
+		/** Count a change that the signals do not cover, such as one to the owning filter itself. */
+		void invalidate();
+
+		/** Summarize everything the input depends on.
+		 *
+		 * Covers the input size, changes to the settings, the enabled state and order of the parent source and every
+		 * filter before this one. If paused_media is set, only a paused, stopped or ended media source without filters
+		 * before this one counts as unchanged. Returns false if the input has to be assumed to change every frame.
+		 */
+		bool signature(bool paused_media, uint64_t& signature);
+
+		private:
+		void connect();
+		void disconnect();
+
+		static void handle_change(void* ptr, calldata_t* data) noexcept;
+	};
+} // namespace streamfx::obs
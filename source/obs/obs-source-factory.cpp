@@ -3,3 +3,37 @@
 // AUTOGENERATED COPYRIGHT HEADER END
 
 #include "obs-source-factory.hpp"
+#include "obs/gs/gs-effect.hpp"
+#include "obs/gs/gs-rendertarget.hpp"
+
+streamfx::obs::source_instance::source_instance(obs_data_t* settings, obs_source_t* source) : _self(source, false, false)
+{
+#ifdef ENABLE_PROFILING
+	_profile_tick    = ::streamfx::util::profiler::create();
+	_profile_render  = ::streamfx::util::profiler::create();
+	_profile_passes  = 0;
+	_profile_lookups = 0;
+#endif
+}
+
+streamfx::obs::source_instance::~source_instance()
+{
+#ifdef ENABLE_PROFILING
+	if (auto frames = _profile_render->count(); frames > 0) {
+		DLOG_INFO("<%s> Rendered %" PRIu64 " frames with %.3f ms average, %.3f ms 99th percentile CPU time, %.2f render target passes and %.2f parameter lookups per frame.", _self.name().data(), frames, _profile_render->average_duration() / 1000000.0, static_cast<double_t>(_profile_render->percentile(0.99).count()) / 1000000.0, static_cast<double_t>(_profile_passes) / static_cast<double_t>(frames), static_cast<double_t>(_profile_lookups) / static_cast<double_t>(frames));
+	}
+	if (auto ticks = _profile_tick->count(); ticks > 0) {
+		DLOG_INFO("<%s> Ticked %" PRIu64 " times with %.3f ms average, %.3f ms 99th percentile CPU time.", _self.name().data(), ticks, _profile_tick->average_duration() / 1000000.0, static_cast<double_t>(_profile_tick->percentile(0.99).count()) / 1000000.0);
+	}
+#endif
+}
+
+#ifdef ENABLE_PROFILING
+streamfx::obs::source_instance::render_profile::render_profile(source_instance* parent) : _parent(parent), _timer(parent->_profile_render->track()), _passes(::streamfx::obs::gs::rendertarget::pass_count()), _lookups(::streamfx::obs::gs::effect::lookup_count()) {}
+
+streamfx::obs::source_instance::render_profile::~render_profile()
+{
+	_parent->_profile_passes  += ::streamfx::obs::gs::rendertarget::pass_count() - _passes;
+	_parent->_profile_lookups += ::streamfx::obs::gs::effect::lookup_count() - _lookups;
+}
+#endif
@@ -236,8 +236,12 @@ namespace streamfx::obs {
 		static void _video_tick(void* data, float seconds) noexcept
 		{
 			try {
-				if (data)
+				if (data) {
+#ifdef ENABLE_PROFILING
+					auto profile = reinterpret_cast<_instance*>(data)->_profile_tick->track();
+#endif
 					reinterpret_cast<_instance*>(data)->video_tick(seconds);
+				}
 			} catch (const std::exception& ex) {
 				DLOG_ERROR("Unexpected exception in function '%s': %s.", __FUNCTION_NAME__, ex.what());
 			} catch (...) {
@@ -248,8 +252,12 @@ namespace streamfx::obs {
 		static void _video_render(void* data, gs_effect_t* effect) noexcept
 		{
 			try {
-				if (data)
+				if (data) {
+#ifdef ENABLE_PROFILING
+					typename _instance::render_profile profile{reinterpret_cast<_instance*>(data)};
+#endif
 					reinterpret_cast<_instance*>(data)->video_render(effect);
+				}
 			} catch (const std::exception& ex) {
 				DLOG_ERROR("Unexpected exception in function '%s': %s.", __FUNCTION_NAME__, ex.what());
 			} catch (...) {
@@ -260,8 +268,12 @@ namespace streamfx::obs {
 		static void _video_render_filter(void* data, gs_effect_t* effect) noexcept
 		{
 			try {
-				if (data)
+				if (data) {
+#ifdef ENABLE_PROFILING
+					typename _instance::render_profile profile{reinterpret_cast<_instance*>(data)};
+#endif
 					reinterpret_cast<_instance*>(data)->video_render(effect);
+				}
 			} catch (const std::exception& ex) {
 				DLOG_ERROR("Unexpected exception in function '%s': %s.", __FUNCTION_NAME__, ex.what());
 				obs_source_skip_video_filter(reinterpret_cast<_instance*>(data)->get());
@@ -833,9 +845,31 @@ namespace streamfx::obs {
 		protected:
 		::streamfx::obs::source _self;
 
+#ifdef ENABLE_PROFILING
+		public /* Profiling */:
+		std::shared_ptr<::streamfx::util::profiler> _profile_tick;
+		std::shared_ptr<::streamfx::util::profiler> _profile_render;
+		uint64_t                                    _profile_passes;
+		uint64_t                                    _profile_lookups;
+
+		/** Times one video_render call and counts the render target passes and parameter lookups it (and any nested
+		 * source) caused.
+		 */
+		class render_profile {
+			source_instance*                                      _parent;
+			std::shared_ptr<::streamfx::util::profiler::instance> _timer;
+			uint64_t                                              _passes;
+			uint64_t                                              _lookups;
+
+			public:
+			render_profile(source_instance* parent);
+			~render_profile();
+		};
+#endif
+
 		public:
-		source_instance(obs_data_t* settings, obs_source_t* source) : _self(source, false, false) {}
-		virtual ~source_instance(){};
+		source_instance(obs_data_t* settings, obs_source_t* source);
+		virtual ~source_instance();
 
 		virtual ::streamfx::obs::source get()
 		{
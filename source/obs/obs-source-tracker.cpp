@@ -253,6 +253,7 @@ std::shared_ptr<streamfx::obs::source_tracker> streamfx::obs::source_tracker::in
 static std::shared_ptr<streamfx::obs::source_tracker> loader_instance;
 
 static auto loader = streamfx::loader(
+	"source-tracker",
 	[]() { // Initalizer
 		loader_instance = streamfx::obs::source_tracker::instance();
 	},
@@ -3,7 +3,6 @@
 // AUTOGENERATED COPYRIGHT HEADER END
 
 #include "plugin.hpp"
-#include "gfx/gfx-opengl.hpp"
 #include "obs/gs/gs-helper.hpp"
 #include "obs/gs/gs-vertexbuffer.hpp"
 
@@ -12,16 +11,29 @@
 #include "updater.hpp"
 
 #include "warning-disable.hpp"
+#include <chrono>
+#include <condition_variable>
 #include <fstream>
 #include <list>
 #include <map>
+#include <mutex>
 #include <stdexcept>
 #include "warning-enable.hpp"
 
-static std::shared_ptr<streamfx::gfx::opengl> _streamfx_gfx_opengl;
-
 namespace streamfx {
-	typedef std::list<loader_function_t>               loader_list_t;
+	struct loader_info {
+		std::string              name;
+		loader_function_t        initializer;
+		loader_function_t        finalizer;
+		loader_flags             flags;
+		std::vector<std::string> dependencies;
+
+		// Only valid during obs_module_load.
+		std::size_t             pending;
+		std::list<loader_info*> dependents;
+	};
+
+	typedef std::list<std::shared_ptr<loader_info>>    loader_list_t;
 	typedef std::map<loader_priority_t, loader_list_t> loader_map_t;
 
 	loader_map_t& get_initializers()
@@ -36,53 +48,197 @@ namespace streamfx {
 		return finalizers;
 	}
 
-	loader::loader(loader_function_t initializer, loader_function_t finalizer, loader_priority_t priority)
+	loader::loader(std::string_view name, loader_function_t initializer, loader_function_t finalizer, loader_priority_t priority, loader_flags flags, std::initializer_list<std::string_view> dependencies)
 	{
-		auto init_kv = get_initializers().find(priority);
-		if (init_kv != get_initializers().end()) {
-			init_kv->second.push_back(initializer);
-		} else {
-			get_initializers().emplace(priority, loader_list_t{initializer});
+		auto info         = std::make_shared<loader_info>();
+		info->name        = name;
+		info->initializer = initializer;
+		info->finalizer   = finalizer;
+		info->flags       = flags;
+		for (auto dependency : dependencies) {
+			info->dependencies.emplace_back(dependency);
 		}
 
+		get_initializers()[priority].push_back(info);
+
 		// Invert the order for finalizers.
 		auto ipriority = priority ^ static_cast<loader_priority_t>(0xFFFFFFFFFFFFFFFF);
-		auto fina_kv   = get_finalizers().find(ipriority);
-		if (fina_kv != get_finalizers().end()) {
-			fina_kv->second.push_back(finalizer);
-		} else {
-			get_finalizers().emplace(ipriority, loader_list_t{finalizer});
+		get_finalizers()[ipriority].push_back(info);
+	}
+
+	static double_t run_loader(loader_info* info, bool finalize)
+	{
+		auto start = std::chrono::high_resolution_clock::now();
+		try {
+			auto& function = finalize ? info->finalizer : info->initializer;
+			if (has(info->flags, loader_flags::GRAPHICS)) {
+				streamfx::obs::gs::context gctx{};
+				function();
+			} else {
+				function();
+			}
+		} catch (const std::exception& ex) {
+			DLOG_ERROR("%s '%s' threw exception: %s", finalize ? "Finalizer" : "Initializer", info->name.c_str(), ex.what());
+		} catch (...) {
+			DLOG_ERROR("%s '%s' threw unknown exception.", finalize ? "Finalizer" : "Initializer", info->name.c_str());
 		}
+		return std::chrono::duration<double_t, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
 	}
-} // namespace streamfx
 
-MODULE_EXPORT bool obs_module_load(void)
-{
-	try {
-		DLOG_INFO("Loading Version %s", STREAMFX_VERSION_STRING);
+	static void initialize()
+	{
+		std::vector<loader_info*>          order;
+		std::map<std::string, std::size_t> index;
+		for (auto& kv : get_initializers()) {
+			for (auto& info : kv.second) {
+				info->pending = 0;
+				info->dependents.clear();
+				index.emplace(info->name, order.size());
+				order.push_back(info.get());
+			}
+		}
+
+		// Resolve dependencies. These also order non-ASYNC initializers, as one may depend on an ASYNC initializer which in
+		// turn depends on a non-ASYNC initializer with a lower priority.
+		for (std::size_t idx = 0; idx < order.size(); idx++) {
+			auto info = order[idx];
+			for (auto& name : info->dependencies) {
+				auto kv = index.find(name);
+				if (kv == index.end()) {
+					continue;
+				}
 
-		// Initialize GLAD (OpenGL)
-		{
-			streamfx::obs::gs::context gctx{};
-			if (gs_get_device_type() == GS_DEVICE_OPENGL) {
-				_streamfx_gfx_opengl = streamfx::gfx::opengl::get();
+				auto dependency = order[kv->second];
+				dependency->dependents.push_back(info);
+				info->pending++;
 			}
 		}
 
-		// Run all initializers.
-		for (auto kv : streamfx::get_initializers()) {
-			for (auto init : kv.second) {
-				try {
-					init();
-				} catch (const std::exception& ex) {
-					DLOG_ERROR("Initializer threw exception: %s", ex.what());
-				} catch (...) {
-					DLOG_ERROR("Initializer threw unknown exception.");
+		{ // Break up dependency cycles, as they would never complete.
+			std::map<loader_info*, std::size_t> remaining;
+			std::list<loader_info*>             ready;
+			for (auto info : order) {
+				remaining[info] = info->pending;
+				if (info->pending == 0) {
+					ready.push_back(info);
+				}
+			}
+			for (; !ready.empty(); ready.pop_front()) {
+				for (auto dependent : ready.front()->dependents) {
+					if (--remaining[dependent] == 0) {
+						ready.push_back(dependent);
+					}
+				}
+			}
+			for (auto& kv : remaining) {
+				if (kv.second > 0) {
+					DLOG_ERROR("Initializer '%s' is part of a dependency cycle, ignoring its dependencies.", kv.first->name.c_str());
+					kv.first->pending = 0;
+					for (auto info : order) {
+						info->dependents.remove(kv.first);
+					}
 				}
 			}
 		}
 
-		DLOG_INFO("Loaded Version %s", STREAMFX_VERSION_STRING);
+		std::mutex              lock;
+		std::condition_variable changed;
+		std::size_t             outstanding = 0;
+
+		// Keep the threadpool alive until everything is done, its own initializer may not have run yet.
+		auto pool = streamfx::threadpool();
+
+		std::function<void(loader_info*)> schedule;
+		std::function<void(loader_info*)> complete;
+		schedule = [&lock, &complete, &pool](loader_info* info) {
+			pool->push([info, &lock, &complete](streamfx::util::threadpool::task_data_t) {
+				double_t time = run_loader(info, false);
+				DLOG_INFO("Initialized '%s' in %.3f ms on the threadpool.", info->name.c_str(), time);
+
+				std::lock_guard<std::mutex> lg(lock);
+				complete(info);
+			});
+		};
+		complete = [&](loader_info* info) {
+			// Called with the lock held.
+			for (auto dependent : info->dependents) {
+				if ((--dependent->pending == 0) && has(dependent->flags, loader_flags::ASYNC)) {
+					schedule(dependent);
+				}
+			}
+			if (has(info->flags, loader_flags::ASYNC)) {
+				outstanding--;
+			}
+			changed.notify_all();
+		};
+
+		{ // Start everything which does not have to wait for anything.
+			std::lock_guard<std::mutex> lg(lock);
+			for (auto info : order) {
+				if (has(info->flags, loader_flags::ASYNC)) {
+					outstanding++;
+					if (info->pending == 0) {
+						schedule(info);
+					}
+				}
+			}
+		}
+
+		// Everything else runs here, as OBS expects registrations to happen on this thread. Whichever initializer is ready
+		// and has the highest priority goes next, so nothing waits on an initializer that can only run after it.
+		std::list<loader_info*> main_thread;
+		for (auto info : order) {
+			if (!has(info->flags, loader_flags::ASYNC)) {
+				main_thread.push_back(info);
+			}
+		}
+		while (!main_thread.empty()) {
+			loader_info* info = nullptr;
+			{
+				std::unique_lock<std::mutex> ul(lock);
+				changed.wait(ul, [&main_thread, &info]() {
+					for (auto iter = main_thread.begin(); iter != main_thread.end(); iter++) {
+						if ((*iter)->pending == 0) {
+							info = *iter;
+							main_thread.erase(iter);
+							return true;
+						}
+					}
+					return false;
+				});
+			}
+
+			double_t time = run_loader(info, false);
+			DLOG_INFO("Initialized '%s' in %.3f ms.", info->name.c_str(), time);
+
+			std::lock_guard<std::mutex> lg(lock);
+			complete(info);
+		}
+
+		// Wait for the remaining work on the threadpool, it may still reference things on the stack here.
+		std::unique_lock<std::mutex> ul(lock);
+		changed.wait(ul, [&outstanding]() { return outstanding == 0; });
+	}
+
+	static void finalize()
+	{
+		for (auto& kv : get_finalizers()) {
+			for (auto& info : kv.second) {
+				run_loader(info.get(), true);
+			}
+		}
+	}
+} // namespace streamfx
+
+MODULE_EXPORT bool obs_module_load(void)
+{
+	try {
+		DLOG_INFO("Loading Version %s", STREAMFX_VERSION_STRING);
+
+		auto start = std::chrono::high_resolution_clock::now();
+		streamfx::initialize();
+
+		DLOG_INFO("Loaded Version %s in %.3f ms", STREAMFX_VERSION_STRING, std::chrono::duration<double_t, std::milli>(std::chrono::high_resolution_clock::now() - start).count());
 		return true;
 	} catch (std::exception const& ex) {
 		DLOG_ERROR("Unexpected exception in function '%s': %s", __FUNCTION_NAME__, ex.what());
@@ -100,24 +256,7 @@ MODULE_EXPORT void obs_module_unload(void)
 	try {
 		DLOG_INFO("Unloading Version %s", STREAMFX_VERSION_STRING);
 
-		// Run all finalizers.
-		for (auto kv : streamfx::get_finalizers()) {
-			for (auto init : kv.second) {
-				try {
-					init();
-				} catch (const std::exception& ex) {
-					DLOG_ERROR("Finalizer threw exception: %s", ex.what());
-				} catch (...) {
-					DLOG_ERROR("Finalizer threw unknown exception.");
-				}
-			}
-		}
-
-		// Finalize GLAD (OpenGL)
-		{
-			streamfx::obs::gs::context gctx{};
-			_streamfx_gfx_opengl.reset();
-		}
+		streamfx::finalize();
 
 		DLOG_INFO("Unloaded Version %s", STREAMFX_VERSION_STRING);
 	} catch (std::exception const& ex) {
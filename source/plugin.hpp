@@ -7,6 +7,7 @@
 
 #include "warning-disable.hpp"
 #include <functional>
+#include <initializer_list>
 #include "warning-enable.hpp"
 
 namespace streamfx {
@@ -27,11 +28,35 @@ namespace streamfx {
 		LOWEST  = INT32_MAX,
 	};
 
+	enum class loader_flags : uint32_t {
+		NONE = 0,
+
+		/** Run the initializer on the threadpool, in parallel with everything else.
+		 *
+		 * Only for CPU work such as loading libraries, reading files or building tables. Registering anything with OBS
+		 * or touching the graphics context is not allowed. Priority only orders the finalizer, use dependencies instead.
+		 */
+		ASYNC = 1 << 0,
+
+		/** Run the initializer and finalizer inside the graphics context.
+		 *
+		 * Prefer creating graphics resources on first use instead, this is for things that really can't wait.
+		 */
+		GRAPHICS = 1 << 1,
+	};
+
 	struct loader {
-		loader(loader_function_t initializer, loader_function_t finalizer, loader_priority_t priority);
+		/**
+		 * \param name Unique name, used for dependencies and in the log.
+		 * \param priority Order in which non-ASYNC initializers run unless a dependency says otherwise, finalizers run in the
+		 *                 inverse order.
+		 * \param dependencies Names of loaders whose initializer must have completed before this one runs. Unknown
+		 *                     names are ignored, as the component providing them may not be part of the build.
+		 */
+		loader(std::string_view name, loader_function_t initializer, loader_function_t finalizer, loader_priority_t priority, loader_flags flags = loader_flags::NONE, std::initializer_list<std::string_view> dependencies = {});
 
 		// Usage:
-		// auto loader = streamfx::loader([]() { ... }, []() { ... }, 0);
+		// auto loader = streamfx::loader("name", []() { ... }, []() { ... }, 0);
 	};
 
 	// Threadpool
@@ -42,3 +67,5 @@ namespace streamfx {
 
 	bool open_url(std::string_view url);
 } // namespace streamfx
+
+P_ENABLE_BITMASK_OPERATORS(streamfx::loader_flags)
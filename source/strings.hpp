@@ -46,6 +46,7 @@
 #define S_BLUR_TYPE_BOX_LINEAR "Blur.Type.BoxLinear"
 #define S_BLUR_TYPE_GAUSSIAN "Blur.Type.Gaussian"
 #define S_BLUR_TYPE_GAUSSIAN_LINEAR "Blur.Type.GaussianLinear"
+#define S_BLUR_TYPE_GAUSSIAN_CASCADE "Blur.Type.GaussianCascade"
 #define S_BLUR_TYPE_DUALFILTERING "Blur.Type.DualFiltering"
 
 #define S_BLUR_SUBTYPE_AREA "Blur.Subtype.Area"
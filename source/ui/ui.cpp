@@ -286,10 +286,11 @@ QString streamfx::ui::translator::translate(const char* context, const char* sou
 static std::shared_ptr<streamfx::ui::handler> loader_instance;
 
 static auto loader = streamfx::loader(
+	"ui",
 	[]() { // Initalizer
 		loader_instance = streamfx::ui::handler::instance();
 	},
 	[]() { // Finalizer
 		loader_instance.reset();
 	},
-	streamfx::loader_priority::LOWEST); // Must be loaded after all other functionality.
+	streamfx::loader_priority::LOWEST, streamfx::loader_flags::NONE, {"configuration"}); // Must be loaded after all other functionality.
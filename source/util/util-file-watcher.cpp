@@ -0,0 +1,274 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2023 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#include "util-file-watcher.hpp"
+#include "util-logging.hpp"
+
+#include "warning-disable.hpp"
+#include <cerrno>
+#include <vector>
+#ifdef D_PLATFORM_LINUX
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+#include "warning-enable.hpp"
+
+#ifdef _DEBUG
+#define ST_PREFIX "<%s> "
+#define D_LOG_ERROR(x, ...) P_LOG_ERROR(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_WARNING(x, ...) P_LOG_WARN(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_INFO(x, ...) P_LOG_INFO(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#define D_LOG_DEBUG(x, ...) P_LOG_DEBUG(ST_PREFIX##x, __FUNCTION_SIG__, __VA_ARGS__)
+#else
+#define ST_PREFIX "<util::file_watcher> "
+#define D_LOG_ERROR(...) P_LOG_ERROR(ST_PREFIX __VA_ARGS__)
+#define D_LOG_WARNING(...) P_LOG_WARN(ST_PREFIX __VA_ARGS__)
+#define D_LOG_INFO(...) P_LOG_INFO(ST_PREFIX __VA_ARGS__)
+#define D_LOG_DEBUG(...) P_LOG_DEBUG(ST_PREFIX __VA_ARGS__)
+#endif
+
+// How often files are checked if there is nothing better than polling.
+static constexpr std::chrono::milliseconds poll_interval{333};
+
+#ifdef D_PLATFORM_LINUX
+// Only react once a writer is done, or a finished file was moved in place.
+static constexpr uint32_t inotify_mask = IN_CLOSE_WRITE | IN_MOVED_TO;
+#endif
+
+streamfx::util::file_watcher::state::~state()
+{
+#ifdef D_PLATFORM_LINUX
+	if (inotify >= 0) {
+		close(inotify);
+	}
+	if (inotify_wake >= 0) {
+		close(inotify_wake);
+	}
+#endif
+}
+
+streamfx::util::file_watcher::file_watcher() : _state(std::make_shared<state>()), _worker()
+{
+#ifdef D_PLATFORM_LINUX
+	_state->inotify      = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	_state->inotify_wake = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if ((_state->inotify >= 0) && (_state->inotify_wake >= 0)) {
+		_worker = std::thread(&file_watcher::inotify_loop, _state);
+		return;
+	}
+
+	D_LOG_WARNING("inotify is not available, falling back to polling.", nullptr);
+	if (_state->inotify >= 0) {
+		close(_state->inotify);
+		_state->inotify = -1;
+	}
+	if (_state->inotify_wake >= 0) {
+		close(_state->inotify_wake);
+		_state->inotify_wake = -1;
+	}
+#endif
+
+	_worker = std::thread(&file_watcher::poll_loop, _state);
+}
+
+streamfx::util::file_watcher::~file_watcher()
+{
+	{
+		std::lock_guard<std::mutex> lg(_state->lock);
+		_state->stop = true;
+	}
+	_state->wake.notify_all();
+#ifdef D_PLATFORM_LINUX
+	if (_state->inotify_wake >= 0) {
+		uint64_t value = 1;
+		[[maybe_unused]] auto res = write(_state->inotify_wake, &value, sizeof(value));
+	}
+#endif
+
+	if (_worker.get_id() == std::this_thread::get_id()) {
+		// Released from within a callback, so the thread can't be joined here. It only touches the shared state from
+		// now on, which it keeps alive on its own, and exits as soon as the callback returns.
+		retire(std::move(_worker));
+	} else if (_worker.joinable()) {
+		_worker.join();
+	}
+}
+
+std::shared_ptr<void> streamfx::util::file_watcher::watch(const std::filesystem::path& file, callback_t callback)
+{
+	auto item      = std::make_shared<entry>();
+	item->path     = std::filesystem::absolute(file).lexically_normal();
+	item->callback = std::move(callback);
+
+	std::error_code ec;
+	item->time = std::filesystem::last_write_time(item->path, ec);
+	item->size = std::filesystem::file_size(item->path, ec);
+
+	{
+		std::lock_guard<std::mutex> lg(_state->lock);
+		_state->entries.push_back(item);
+
+#ifdef D_PLATFORM_LINUX
+		if (_state->inotify >= 0) {
+			auto directory = item->path.parent_path();
+			if (_state->directories.find(directory) == _state->directories.end()) {
+				if (int wd = inotify_add_watch(_state->inotify, directory.c_str(), inotify_mask); wd >= 0) {
+					_state->directories.emplace(directory, wd);
+				} else {
+					D_LOG_WARNING("Failed to watch '%s' for changes.", directory.c_str());
+				}
+			}
+		}
+#endif
+	}
+
+	// The handle keeps the watcher alive, so that it only exists while someone is interested.
+	return std::shared_ptr<void>(item.get(), [self = shared_from_this(), item](void*) { self->unwatch(item); });
+}
+
+void streamfx::util::file_watcher::unwatch(const std::shared_ptr<entry>& item)
+{
+	std::lock_guard<std::mutex> lg(_state->lock);
+	_state->entries.remove(item);
+
+#ifdef D_PLATFORM_LINUX
+	if (_state->inotify >= 0) {
+		auto directory = item->path.parent_path();
+		for (auto& other : _state->entries) {
+			if (other->path.parent_path() == directory) {
+				return;
+			}
+		}
+		if (auto kv = _state->directories.find(directory); kv != _state->directories.end()) {
+			inotify_rm_watch(_state->inotify, kv->second);
+			_state->directories.erase(kv);
+		}
+	}
+#endif
+}
+
+void streamfx::util::file_watcher::poll_loop(std::shared_ptr<state> state)
+{
+	std::unique_lock<std::mutex> ul(state->lock);
+	while (!state->wake.wait_for(ul, poll_interval, [&state]() { return state->stop; })) {
+		// Check the files without holding the lock, as that may take a while on network drives.
+		auto entries = state->entries;
+		ul.unlock();
+
+		for (auto& item : entries) {
+			std::error_code ec;
+			auto            time = std::filesystem::last_write_time(item->path, ec);
+			auto            size = std::filesystem::file_size(item->path, ec);
+			if (ec || ((time == item->time) && (size == item->size))) {
+				continue;
+			}
+
+			item->time = time;
+			item->size = size;
+			item->callback(item->path);
+		}
+
+		ul.lock();
+	}
+}
+
+#ifdef D_PLATFORM_LINUX
+void streamfx::util::file_watcher::inotify_loop(std::shared_ptr<state> state)
+{
+	std::vector<char> buffer(64 * 1024);
+
+	while (true) {
+		pollfd fds[2] = {{state->inotify, POLLIN, 0}, {state->inotify_wake, POLLIN, 0}};
+		if ((poll(fds, 2, -1) < 0) && (errno != EINTR)) {
+			D_LOG_ERROR("Waiting for changes failed with error %d.", errno);
+			break;
+		}
+		if (fds[1].revents != 0) {
+			break;
+		}
+
+		// Collect every changed file first, a single save often causes more than one event.
+		std::vector<std::filesystem::path> changed;
+		for (ssize_t length; (length = read(state->inotify, buffer.data(), buffer.size())) > 0;) {
+			for (char* ptr = buffer.data(); ptr < buffer.data() + length;) {
+				auto event = reinterpret_cast<inotify_event*>(ptr);
+				ptr += sizeof(inotify_event) + event->len;
+				if (event->len == 0) {
+					continue;
+				}
+
+				std::lock_guard<std::mutex> lg(state->lock);
+				for (auto& kv : state->directories) {
+					if (kv.second == event->wd) {
+						auto path = kv.first / event->name;
+						if (std::find(changed.begin(), changed.end(), path) == changed.end()) {
+							changed.push_back(std::move(path));
+						}
+						break;
+					}
+				}
+			}
+		}
+
+		std::list<std::shared_ptr<entry>> entries;
+		{
+			std::lock_guard<std::mutex> lg(state->lock);
+			if (state->stop) {
+				break;
+			}
+			for (auto& item : state->entries) {
+				if (std::find(changed.begin(), changed.end(), item->path) != changed.end()) {
+					entries.push_back(item);
+				}
+			}
+		}
+		for (auto& item : entries) {
+			item->callback(item->path);
+		}
+	}
+}
+#endif
+
+void streamfx::util::file_watcher::retire(std::thread worker)
+{
+	// Holds the worker of a watcher which was released on its own thread, until the next one needs the spot or the
+	// plugin is unloaded. Either happens after the worker has left the callback, so joining only waits for it to exit.
+	static struct graveyard {
+		std::mutex  lock;
+		std::thread worker;
+
+		~graveyard()
+		{
+			if (worker.joinable()) {
+				worker.join();
+			}
+		}
+	} graveyard;
+
+	std::thread previous;
+	{
+		std::lock_guard<std::mutex> lg(graveyard.lock);
+		previous         = std::move(graveyard.worker);
+		graveyard.worker = std::move(worker);
+	}
+	if (previous.joinable()) {
+		previous.join();
+	}
+}
+
+std::shared_ptr<streamfx::util::file_watcher> streamfx::util::file_watcher::instance()
+{
+	static std::weak_ptr<streamfx::util::file_watcher> winst;
+	static std::mutex                                  mtx;
+
+	std::unique_lock<decltype(mtx)> lock(mtx);
+	auto                            instance = winst.lock();
+	if (!instance) {
+		instance = std::shared_ptr<streamfx::util::file_watcher>(new streamfx::util::file_watcher());
+		winst    = instance;
+	}
+	return instance;
+}
@@ -0,0 +1,86 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2023 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "common.hpp"
+
+#include "warning-disable.hpp"
+#include <condition_variable>
+#include <filesystem>
+#include <functional>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include "warning-enable.hpp"
+
+namespace streamfx::util {
+	/** Tells interested parties when a file changed, from a single thread shared by everyone.
+	 *
+	 * Uses inotify where available, which watches the directory so that editors replacing the file are noticed as well.
+	 * Everywhere else the files are checked for a new modification time or size a few times per second.
+	 */
+	class file_watcher : public std::enable_shared_from_this<file_watcher> {
+		public:
+		/** Called on the watcher thread, so keep it short and hand off any real work.
+		 *
+		 * May still be called once more while the handle is being released.
+		 */
+		typedef std::function<void(const std::filesystem::path& file)> callback_t;
+
+		private:
+		struct entry {
+			std::filesystem::path           path;
+			callback_t                      callback;
+			std::filesystem::file_time_type time;
+			uintmax_t                       size;
+		};
+
+		/** Everything the worker thread touches, which it keeps alive until it has exited. */
+		struct state {
+			std::mutex                        lock;
+			std::condition_variable           wake;
+			bool                              stop = false;
+			std::list<std::shared_ptr<entry>> entries;
+
+#ifdef D_PLATFORM_LINUX
+			int                                  inotify      = -1;
+			int                                  inotify_wake = -1;
+			std::map<std::filesystem::path, int> directories;
+#endif
+
+			~state();
+		};
+
+		std::shared_ptr<state> _state;
+		std::thread            _worker;
+
+		public:
+		~file_watcher();
+
+		private:
+		file_watcher();
+
+		void unwatch(const std::shared_ptr<entry>& item);
+
+		static void poll_loop(std::shared_ptr<state> state);
+
+#ifdef D_PLATFORM_LINUX
+		static void inotify_loop(std::shared_ptr<state> state);
+#endif
+
+		static void retire(std::thread worker);
+
+		public:
+		/** Watch a file until the returned handle is released.
+		 *
+		 * The file does not have to exist yet.
+		 */
+		std::shared_ptr<void> watch(const std::filesystem::path& file, callback_t callback);
+
+		public:
+		static std::shared_ptr<file_watcher> instance();
+	};
+} // namespace streamfx::util
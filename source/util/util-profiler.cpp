@@ -5,10 +5,27 @@
 #include "util-profiler.hpp"
 
 #include "warning-disable.hpp"
-#include <iterator>
+#include <algorithm>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
 #include "warning-enable.hpp"
 
-streamfx::util::profiler::profiler() {}
+static inline size_t most_significant_bit(uint64_t value)
+{
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanReverse64(&index, value);
+	return static_cast<size_t>(index);
+#else
+	return static_cast<size_t>(63 - __builtin_clzll(value));
+#endif
+}
+
+streamfx::util::profiler::profiler()
+{
+	reset();
+}
 
 streamfx::util::profiler::~profiler() {}
 
@@ -19,117 +36,167 @@ std::shared_ptr<streamfx::util::profiler::instance> streamfx::util::profiler::tr
 
 void streamfx::util::profiler::track(std::chrono::nanoseconds duration)
 {
-	std::unique_lock<std::mutex> ul(_timings_lock);
-	auto                         itr = _timings.find(duration);
-	if (itr == _timings.end()) {
-		_timings.emplace(duration, 1u);
-	} else {
-		itr->second++;
-	}
+	// Spread threads over the shards so they rarely fight over the same cache lines.
+	static std::atomic<size_t> next_shard{0};
+	static thread_local size_t shard_index = next_shard.fetch_add(1, std::memory_order_relaxed) % shard_count;
+
+	auto  value = static_cast<uint64_t>(std::max<int64_t>(duration.count(), 0));
+	auto& shard = _shards[shard_index];
+	shard.buckets[bucket_index(value)].fetch_add(1, std::memory_order_relaxed);
+	shard.count.fetch_add(1, std::memory_order_relaxed);
+	shard.total.fetch_add(value, std::memory_order_relaxed);
 }
 
 uint64_t streamfx::util::profiler::count()
 {
 	uint64_t count = 0;
+	for (auto& shard : _shards) {
+		count += shard.count.load(std::memory_order_relaxed);
+	}
+	return count;
+}
 
-	std::map<std::chrono::nanoseconds, size_t> copy_timings;
-	{
-		std::unique_lock<std::mutex> ul(_timings_lock);
-		copy(_timings.begin(), _timings.end(), std::inserter(copy_timings, copy_timings.end()));
+std::chrono::nanoseconds streamfx::util::profiler::total_duration()
+{
+	uint64_t total = 0;
+	for (auto& shard : _shards) {
+		total += shard.total.load(std::memory_order_relaxed);
 	}
+	return std::chrono::nanoseconds(total);
+}
 
-	for (auto kv : copy_timings) {
-		count += kv.second;
+double_t streamfx::util::profiler::average_duration()
+{
+	uint64_t count = 0;
+	uint64_t total = 0;
+	for (auto& shard : _shards) {
+		count += shard.count.load(std::memory_order_relaxed);
+		total += shard.total.load(std::memory_order_relaxed);
 	}
+	return double_t(total) / double_t(count);
+}
 
-	return count;
+std::chrono::nanoseconds streamfx::util::profiler::percentile(double_t percentile, bool by_time)
+{
+	return snapshot().percentile(percentile, by_time);
 }
 
-std::chrono::nanoseconds streamfx::util::profiler::total_duration()
+streamfx::util::profiler::histogram streamfx::util::profiler::snapshot(bool reset)
 {
-	std::chrono::nanoseconds duration{0};
+	histogram result;
+	uint64_t  total = 0;
 
-	std::map<std::chrono::nanoseconds, size_t> copy_timings;
-	{
-		std::unique_lock<std::mutex> ul(_timings_lock);
-		copy(_timings.begin(), _timings.end(), std::inserter(copy_timings, copy_timings.end()));
+	for (auto& shard : _shards) {
+		if (reset) {
+			for (size_t idx = 0; idx < bucket_count; idx++) {
+				result._buckets[idx] += shard.buckets[idx].exchange(0, std::memory_order_relaxed);
+			}
+			result._count += shard.count.exchange(0, std::memory_order_relaxed);
+			total += shard.total.exchange(0, std::memory_order_relaxed);
+		} else {
+			for (size_t idx = 0; idx < bucket_count; idx++) {
+				result._buckets[idx] += shard.buckets[idx].load(std::memory_order_relaxed);
+			}
+			result._count += shard.count.load(std::memory_order_relaxed);
+			total += shard.total.load(std::memory_order_relaxed);
+		}
 	}
+	result._total = std::chrono::nanoseconds(total);
 
-	for (auto kv : copy_timings) {
-		duration += kv.first * kv.second;
-	}
+	return result;
+}
 
-	return duration;
+void streamfx::util::profiler::reset()
+{
+	for (auto& shard : _shards) {
+		for (auto& bucket : shard.buckets) {
+			bucket.store(0, std::memory_order_relaxed);
+		}
+		shard.count.store(0, std::memory_order_relaxed);
+		shard.total.store(0, std::memory_order_relaxed);
+	}
 }
 
-double_t streamfx::util::profiler::average_duration()
+size_t streamfx::util::profiler::bucket_index(uint64_t value)
 {
-	std::chrono::nanoseconds duration{0};
-	uint64_t                 count = 0;
+	constexpr uint64_t limit = (uint64_t(1) << max_bits) - 1;
 
-	std::map<std::chrono::nanoseconds, size_t> copy_timings;
-	{
-		std::unique_lock<std::mutex> ul(_timings_lock);
-		copy(_timings.begin(), _timings.end(), std::inserter(copy_timings, copy_timings.end()));
+	value = std::min(value, limit);
+	if (value < sub_count) { // The first power of two range is exact.
+		return static_cast<size_t>(value);
 	}
 
-	for (auto kv : copy_timings) {
-		duration += kv.first * kv.second;
-		count += kv.second;
+	// Keep the top sub_bits + 1 bits of the value, and use the position of the top bit as the group.
+	size_t shift = most_significant_bit(value) - sub_bits;
+	return ((shift + 1) * sub_count) + static_cast<size_t>((value >> shift) - sub_count);
+}
+
+uint64_t streamfx::util::profiler::bucket_value(size_t index)
+{
+	size_t group = index / sub_count;
+	size_t sub   = index % sub_count;
+	if (group == 0) {
+		return sub;
 	}
 
-	return double_t(duration.count()) / double_t(count);
+	size_t shift = group - 1;
+	return ((uint64_t(sub_count + sub) << shift) + (uint64_t(1) << shift)) - 1;
 }
 
-template<typename T>
-inline bool is_equal(T a, T b, T c)
+streamfx::util::profiler::histogram::histogram() : _buckets(), _count(0), _total(0) {}
+
+uint64_t streamfx::util::profiler::histogram::count()
 {
-	return (a == b) || ((a >= (b - c)) && (a <= (b + c)));
+	return _count;
 }
 
-std::chrono::nanoseconds streamfx::util::profiler::percentile(double_t percentile, bool by_time)
+std::chrono::nanoseconds streamfx::util::profiler::histogram::total_duration()
 {
-	constexpr double_t edge  = 0.00005;
-	uint64_t           calls = count();
+	return _total;
+}
 
-	std::map<std::chrono::nanoseconds, size_t> copy_timings;
-	{
-		std::unique_lock<std::mutex> ul(_timings_lock);
-		copy(_timings.begin(), _timings.end(), inserter(copy_timings, copy_timings.end()));
+double_t streamfx::util::profiler::histogram::average_duration()
+{
+	return double_t(_total.count()) / double_t(_count);
+}
+
+std::chrono::nanoseconds streamfx::util::profiler::histogram::percentile(double_t percentile, bool by_time)
+{
+	size_t first = bucket_count;
+	size_t last  = 0;
+	for (size_t idx = 0; idx < bucket_count; idx++) {
+		if (_buckets[idx] > 0) {
+			first = std::min(first, idx);
+			last  = idx;
+		}
+	}
+	if (first == bucket_count) { // No samples.
+		return std::chrono::nanoseconds(-1);
 	}
+
 	if (by_time) { // Return by time percentile.
-		// Find largest and smallest time.
-		std::chrono::nanoseconds smallest = copy_timings.begin()->first;
-		std::chrono::nanoseconds largest  = copy_timings.rbegin()->first;
-		std::chrono::nanoseconds variance = largest - smallest;
-
-		for (auto kv : copy_timings) {
-			double_t kv_pct = double_t((kv.first - smallest).count()) / double_t(variance.count());
-			if (is_equal<double_t>(kv_pct, percentile, edge) || (kv_pct > percentile)) {
-				return std::chrono::nanoseconds(kv.first);
+		double_t smallest  = double_t(bucket_value(first));
+		double_t largest   = double_t(bucket_value(last));
+		double_t threshold = smallest + (largest - smallest) * percentile;
+
+		for (size_t idx = first; idx <= last; idx++) {
+			if ((_buckets[idx] > 0) && (double_t(bucket_value(idx)) >= threshold)) {
+				return std::chrono::nanoseconds(bucket_value(idx));
 			}
 		}
 	} else { // Return by call percentile.
-		if (percentile == 0.0) {
-			return copy_timings.begin()->first;
-		}
-
-		uint64_t accu_calls_now = 0;
-		for (auto kv : copy_timings) {
-			uint64_t accu_calls_last = accu_calls_now;
-			accu_calls_now += kv.second;
-
-			double_t percentile_last = double_t(accu_calls_last) / double_t(calls);
-			double_t percentile_now  = double_t(accu_calls_now) / double_t(calls);
+		uint64_t target = static_cast<uint64_t>(std::ceil(percentile * double_t(_count)));
+		uint64_t accu   = 0;
 
-			if (is_equal<double_t>(percentile, percentile_now, edge)
-				|| ((percentile_last < percentile) && (percentile_now > percentile))) {
-				return std::chrono::nanoseconds(kv.first);
+		for (size_t idx = first; idx <= last; idx++) {
+			accu += _buckets[idx];
+			if ((accu > 0) && (accu >= target)) {
+				return std::chrono::nanoseconds(bucket_value(idx));
 			}
 		}
 	}
 
-	return std::chrono::nanoseconds(-1);
+	return std::chrono::nanoseconds(bucket_value(last));
 }
 
 streamfx::util::profiler::instance::instance(std::shared_ptr<streamfx::util::profiler> parent)
@@ -6,17 +6,51 @@
 #include "common.hpp"
 
 #include "warning-disable.hpp"
+#include <array>
+#include <atomic>
 #include <chrono>
-#include <map>
-#include <mutex>
+#include <new>
 #include "warning-enable.hpp"
 
 namespace streamfx::util {
+	/** Fixed-memory timing histogram.
+	 *
+	 * Samples are sorted into log-linear buckets: every power of two is split into 2^sub_bits equally sized buckets, so
+	 * every bucket is at most ~3% wide. Writers only ever do relaxed atomic increments into one of several shards, which
+	 * are merged when reading.
+	 */
 	class profiler : public std::enable_shared_from_this<streamfx::util::profiler> {
-		std::map<std::chrono::nanoseconds, size_t> _timings;
-		std::mutex                                 _timings_lock;
-
 		public:
+		static constexpr size_t sub_bits     = 5;
+		static constexpr size_t sub_count    = size_t(1) << sub_bits;
+		static constexpr size_t max_bits     = 42; // ~73 minutes, anything longer is clamped.
+		static constexpr size_t bucket_count = (max_bits - sub_bits + 1) * sub_count;
+		static constexpr size_t shard_count  = 4;
+
+		/** Merged copy of all shards.
+		 *
+		 * The shards are read one counter at a time while writers keep going, so a sample taken during the copy may be
+		 * counted in count() and total_duration() but not yet in a bucket, or the other way around.
+		 */
+		class histogram {
+			std::array<uint64_t, bucket_count> _buckets;
+			uint64_t                           _count;
+			std::chrono::nanoseconds           _total;
+
+			public:
+			histogram();
+
+			uint64_t count();
+
+			std::chrono::nanoseconds total_duration();
+
+			double_t average_duration();
+
+			std::chrono::nanoseconds percentile(double_t percentile, bool by_time = false);
+
+			friend class profiler;
+		};
+
 		class instance {
 			std::shared_ptr<profiler>                      _parent;
 			std::chrono::high_resolution_clock::time_point _start;
@@ -31,6 +65,17 @@ namespace streamfx::util {
 			void reparent(std::shared_ptr<profiler> parent);
 		};
 
+		private:
+		struct shard {
+#if __cpp_lib_hardware_interference_size >= 201603
+			alignas(std::hardware_destructive_interference_size)
+#endif
+				std::atomic<uint64_t> count;
+			std::atomic<uint64_t>                           total;
+			std::array<std::atomic<uint64_t>, bucket_count> buckets;
+		};
+		std::array<shard, shard_count> _shards;
+
 		private:
 		profiler();
 
@@ -49,6 +94,24 @@ namespace streamfx::util {
 
 		std::chrono::nanoseconds percentile(double_t percentile, bool by_time = false);
 
+		/** Merge all shards into a histogram.
+		 *
+		 * @param reset Also clear the profiler, so that consecutive snapshots cover consecutive windows of time. Every
+		 *              counter is exchanged on its own rather than all at once, so no sample is lost or counted twice, but
+		 *              a sample taken during the snapshot may have its bucket in one snapshot and its count and duration
+		 *              in the next.
+		 */
+		histogram snapshot(bool reset = false);
+
+		void reset();
+
+		public:
+		/** Bucket a duration (in nanoseconds) belongs to. */
+		static size_t bucket_index(uint64_t value);
+
+		/** Highest duration (in nanoseconds) that still belongs to a bucket. */
+		static uint64_t bucket_value(size_t index);
+
 		public:
 		static std::shared_ptr<streamfx::util::profiler> create()
 		{
@@ -0,0 +1,117 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2023 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "warning-disable.hpp"
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <vector>
+#include "warning-enable.hpp"
+
+namespace streamfx::util {
+	/** Fixed-size lock-free ring buffer for exactly one producer and one consumer thread.
+	 *
+	 * Slots are constructed once and then reused in place, so anything they own (like buffers) survives between uses
+	 * and the steady state doesn't allocate. The producer writes into back() and publishes it with push(), the consumer
+	 * reads front() and hands it back with pop().
+	 */
+	template<typename T>
+	class spsc_ringbuffer {
+		std::vector<T> _slots;
+		size_t         _mask;
+
+		// Next slot to read, only written by the consumer.
+#if __cpp_lib_hardware_interference_size >= 201603
+		alignas(std::hardware_destructive_interference_size)
+#endif
+			std::atomic<size_t> _head;
+
+		// Next slot to write, only written by the producer.
+#if __cpp_lib_hardware_interference_size >= 201603
+		alignas(std::hardware_destructive_interference_size)
+#endif
+			std::atomic<size_t> _tail;
+
+		public:
+		spsc_ringbuffer(size_t capacity) : _slots(), _mask(0), _head(0), _tail(0)
+		{
+			// Capacity must be a power of two.
+			size_t size = 2;
+			while (size < capacity) {
+				size <<= 1;
+			}
+
+			_slots.resize(size);
+			_mask = size - 1;
+		}
+
+		/** Direct access to every slot, only safe while neither side is active.
+		 *
+		 * Useful to pre-size whatever the slots own.
+		 */
+		std::vector<T>& slots()
+		{
+			return _slots;
+		}
+
+		public /* Producer */:
+		/** Slot to write the next element into.
+		 *
+		 * @return Pointer to the slot, or nullptr if the ring buffer is full.
+		 */
+		T* back()
+		{
+			size_t tail = _tail.load(std::memory_order_relaxed);
+			if ((tail - _head.load(std::memory_order_acquire)) > _mask) {
+				return nullptr;
+			}
+			return &_slots[tail & _mask];
+		}
+
+		/** Publish the slot returned by back() to the consumer.
+		 */
+		void push()
+		{
+			_tail.store(_tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+		}
+
+		public /* Consumer */:
+		/** Oldest published element.
+		 *
+		 * @return Pointer to the slot, or nullptr if the ring buffer is empty.
+		 */
+		T* front()
+		{
+			size_t head = _head.load(std::memory_order_relaxed);
+			if (head == _tail.load(std::memory_order_acquire)) {
+				return nullptr;
+			}
+			return &_slots[head & _mask];
+		}
+
+		/** Hand the slot returned by front() back to the producer.
+		 */
+		void pop()
+		{
+			_head.store(_head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+		}
+
+		public:
+		bool empty()
+		{
+			return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+		}
+
+		size_t size()
+		{
+			return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire);
+		}
+
+		size_t capacity()
+		{
+			return _mask + 1;
+		}
+	};
+} // namespace streamfx::util
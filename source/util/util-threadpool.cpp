@@ -10,7 +10,9 @@
 #include "util/util-logging.hpp"
 
 #include "warning-disable.hpp"
+#include <algorithm>
 #include <cstddef>
+#include <iterator>
 #include "warning-enable.hpp"
 
 #include "warning-disable.hpp"
@@ -35,19 +37,39 @@
 #define D_LOG_DEBUG(...) P_LOG_DEBUG(ST_PREFIX __VA_ARGS__)
 #endif
 
-streamfx::util::threadpool::task::task(task_callback_t callback, task_data_t data) : _callback(callback), _data(data), _lock(), _status_changed(), _cancelled(false), _completed(false), _failed(false) {}
+// Capacity of each per-worker queue, tasks spill into the next queue (and eventually the overflow list) once full.
+constexpr size_t queue_capacity = 1024;
+
+// Maximum number of idle task memory blocks kept around for reuse.
+constexpr size_t task_memory_capacity = 256;
+
+// Time a worker above the minimum worker count may sit idle before it is allowed to die.
+constexpr std::chrono::seconds idle_delay{1};
+
+// The threadpool, group and queue the current thread is a worker of, if any.
+static thread_local streamfx::util::threadpool::threadpool*   current_pool  = nullptr;
+static thread_local streamfx::util::threadpool::worker_group* current_group = nullptr;
+static thread_local size_t                                    current_queue = 0;
+
+streamfx::util::threadpool::task::task(task_callback_t callback, task_data_t data, time_point_t deadline) : _callback(std::move(callback)), _data(std::move(data)), _lock(), _queued(std::chrono::high_resolution_clock::now()), _deadline(deadline), _status_changed(), _cancelled(false), _completed(false), _failed(false) {}
 
 streamfx::util::threadpool::task::~task() {}
 
 void streamfx::util::threadpool::task::run()
 {
+	// Let go of the work as soon as it is done, as whoever pushed the task may hold on to it for much longer.
+	task_callback_t callback;
+	task_data_t     data;
+
 	std::lock_guard<std::mutex> lg(_lock);
+	callback.swap(_callback);
+	data.swap(_data);
 	if (!_cancelled) {
 		try {
-			_callback(_data);
+			callback(data);
 		} catch (const std::exception& ex) {
 			D_LOG_ERROR("Unhandled exception in Task: %s.", ex.what());
-			_failed = false;
+			_failed = true;
 		} catch (...) {
 			D_LOG_ERROR("Unhandled exception in Task.", nullptr);
 			_failed = true;
@@ -59,7 +81,13 @@ void streamfx::util::threadpool::task::run()
 
 void streamfx::util::threadpool::task::cancel()
 {
+	// The task stays in its queue until a worker skips it, but the work itself is released right away.
+	task_callback_t callback;
+	task_data_t     data;
+
 	std::lock_guard<std::mutex> lg(_lock);
+	callback.swap(_callback);
+	data.swap(_data);
 	_cancelled = true;
 	_completed = true;
 	_status_changed.notify_all();
@@ -93,51 +121,149 @@ void streamfx::util::threadpool::task::await_completion()
 	wait();
 }
 
-streamfx::util::threadpool::threadpool::~threadpool()
+streamfx::util::threadpool::time_point_t streamfx::util::threadpool::task::queued()
 {
-	{ // Terminate all remaining tasks.
-		std::lock_guard<std::mutex> lg(_tasks_lock);
-		for (auto task : _tasks) {
-			task->cancel();
-		}
-		_tasks.clear();
+	return _queued;
+}
+
+streamfx::util::threadpool::time_point_t streamfx::util::threadpool::task::deadline()
+{
+	return _deadline;
+}
+
+streamfx::util::threadpool::task_memory::task_memory(size_t capacity) : _blocks(capacity), _block_type(), _size(0), _alignment(0) {}
+
+streamfx::util::threadpool::task_memory::~task_memory()
+{
+	for (void* ptr = nullptr; _blocks.try_pop(ptr);) {
+		::operator delete(ptr, std::align_val_t(_alignment));
+	}
+}
+
+void* streamfx::util::threadpool::task_memory::allocate(size_t size, size_t alignment)
+{
+	std::call_once(_block_type, [this, size, alignment]() {
+		_size      = size;
+		_alignment = alignment;
+	});
+
+	void* ptr = nullptr;
+	if ((size == _size) && (alignment == _alignment) && _blocks.try_pop(ptr)) {
+		return ptr;
+	}
+	return ::operator new(size, std::align_val_t(alignment));
+}
+
+void streamfx::util::threadpool::task_memory::deallocate(void* ptr, size_t size, size_t alignment)
+{
+	// Blocks are only handed out after the block type is known, so this never races with allocate() setting it.
+	if ((size == _size) && (alignment == _alignment) && _blocks.try_push(std::move(ptr))) {
+		return;
 	}
+	::operator delete(ptr, std::align_val_t(alignment));
+}
 
-	{ // Notify workers to stop working.
+streamfx::util::threadpool::threadpool::~threadpool()
+{
+	for (auto group : {&_realtime, &_general}) { // Notify workers to stop working.
+		std::list<std::shared_ptr<worker_info>> workers;
 		{
-			std::lock_guard<std::mutex> lg(_workers_lock);
-			for (auto worker : _workers) {
+			std::lock_guard<std::mutex> lg(group->workers_lock);
+			for (auto worker : group->workers) {
 				worker->stop = true;
 			}
+			workers = group->workers;
 		}
 		{
-			std::lock_guard<std::mutex> lg(_tasks_lock);
-			_tasks_cv.notify_all();
+			std::lock_guard<std::mutex> lg(group->park_lock);
+			group->park_cv.notify_all();
 		}
-		for (auto worker : _workers) {
+		for (auto worker : workers) {
 			std::lock_guard<std::mutex> lg(worker->lifeline);
 		}
 	}
+
+	for (auto& lane : _lanes) { // Terminate all remaining tasks.
+		std::shared_ptr<streamfx::util::threadpool::task> task;
+		for (auto& queue : lane.queues) {
+			while (queue->try_pop(task)) {
+				task->cancel();
+			}
+		}
+
+		std::lock_guard<std::mutex> lg(lane.overflow_lock);
+		for (auto task : lane.overflow) {
+			task->cancel();
+		}
+		lane.overflow.clear();
+		lane.pending = 0;
+	}
 }
 
-streamfx::util::threadpool::threadpool::threadpool(size_t minimum, size_t maximum) : _limits{minimum, maximum}, _workers_lock(), _worker_count(0), _workers(), _tasks_lock(), _tasks_cv(), _tasks()
+streamfx::util::threadpool::threadpool::threadpool(size_t minimum, size_t maximum) : _lanes(), _realtime(), _general(), _task_memory()
 {
+	// std::thread::hardware_concurrency() is allowed to return 0.
+	maximum = std::max<size_t>(std::max<size_t>(minimum, maximum), 1);
+
+	// Realtime work is short and latency sensitive, so it gets a small group of its own.
+	_realtime.limits   = {1, std::max<size_t>(maximum / 2, 1)};
+	_realtime.realtime = true;
+	_realtime.lanes    = {&_lanes[static_cast<size_t>(priority::REALTIME)]};
+
+	// Everything else shares the remaining workers, with NORMAL work always taken before BACKGROUND work.
+	_general.limits   = {minimum, maximum};
+	_general.realtime = false;
+	_general.lanes    = {&_lanes[static_cast<size_t>(priority::NORMAL)], &_lanes[static_cast<size_t>(priority::BACKGROUND)]};
+
+	for (auto group : {&_realtime, &_general}) {
+		group->worker_count = 0;
+		group->parked       = 0;
+		group->workers_queues.resize(group->limits.second, false);
+
+		// Every potential worker gets its own queue in each lane, which lives as long as the threadpool.
+		for (auto lane : group->lanes) {
+			lane->queues.resize(group->limits.second);
+			for (auto& queue : lane->queues) {
+				queue = std::make_unique<task_queue_t>(queue_capacity);
+			}
+			lane->queues_next     = 0;
+			lane->pending         = 0;
+			lane->pushed          = 0;
+			lane->completed       = 0;
+			lane->stolen          = 0;
+			lane->late            = 0;
+			lane->latency_total   = 0;
+			lane->latency_maximum = 0;
+		}
+	}
+	_task_memory = std::make_shared<task_memory>(task_memory_capacity);
+
 	// Spawn the minimum number of threads.
-	spawn(_limits.first);
+	spawn(_realtime, _realtime.limits.first);
+	spawn(_general, _general.limits.first);
 }
 
-std::shared_ptr<streamfx::util::threadpool::task> streamfx::util::threadpool::threadpool::push(task_callback_t callback, task_data_t data /*= nullptr*/)
+std::shared_ptr<streamfx::util::threadpool::task> streamfx::util::threadpool::threadpool::push(task_callback_t callback, task_data_t data /*= nullptr*/, priority priority /*= priority::NORMAL*/, time_point_t deadline /*= time_point_t::max()*/)
 {
-	std::lock_guard<std::mutex> lg(_tasks_lock);
-	constexpr size_t            threshold = 3;
-
-	// Enqueue the new task.
-	auto task = std::make_shared<streamfx::util::threadpool::task>(callback, data);
-	_tasks.emplace_back(task);
-
-	// Spawn additional workers if the number of queued tasks exceeds a threshold.
-	if (_tasks.size() > (threshold * _worker_count)) {
-		spawn(_tasks.size() / threshold);
+	constexpr size_t threshold = 3;
+
+	auto& lane  = _lanes[static_cast<size_t>(priority)];
+	auto& group = (priority == priority::REALTIME) ? _realtime : _general;
+
+	// Count the task before it is visible in a queue, as a worker may take it right away. Counting it afterwards would
+	// let pending wrap around, which keeps every worker spinning in dequeue() until it is counted.
+	auto   task    = allocate(std::move(callback), std::move(data), deadline);
+	size_t pending = lane.pending.fetch_add(1) + 1;
+	enqueue(lane, task);
+	lane.pushed.fetch_add(1, std::memory_order_relaxed);
+
+	if (group.parked.load() > 0) {
+		// Wake up one of the sleeping workers.
+		std::lock_guard<std::mutex> lg(group.park_lock);
+		group.park_cv.notify_one();
+	} else if (pending > (threshold * group.worker_count)) {
+		// Spawn additional workers if the number of queued tasks exceeds a threshold.
+		spawn(group, pending / threshold);
 	}
 
 	// Return handle to caller.
@@ -146,44 +272,141 @@ std::shared_ptr<streamfx::util::threadpool::task> streamfx::util::threadpool::th
 
 void streamfx::util::threadpool::threadpool::pop(std::shared_ptr<task> task)
 {
+	// Tasks can't be removed from the lock-free queues, so the worker that takes it will skip it instead. Cancelling
+	// releases the callback and data right away, only the empty task is left behind in the queue.
 	if (task) {
 		task->cancel();
 	}
-	std::lock_guard<std::mutex> lg(_tasks_lock);
-	_tasks.remove(task);
 }
 
-void streamfx::util::threadpool::threadpool::spawn(size_t count)
+streamfx::util::threadpool::lane_statistics streamfx::util::threadpool::threadpool::statistics(priority priority)
+{
+	auto&           lane = _lanes[static_cast<size_t>(priority)];
+	lane_statistics stats;
+
+	stats.pending         = lane.pending.load(std::memory_order_relaxed);
+	stats.pushed          = lane.pushed.load(std::memory_order_relaxed);
+	stats.completed       = lane.completed.load(std::memory_order_relaxed);
+	stats.stolen          = lane.stolen.load(std::memory_order_relaxed);
+	stats.late            = lane.late.load(std::memory_order_relaxed);
+	stats.latency_average = std::chrono::nanoseconds(stats.completed > 0 ? (lane.latency_total.load(std::memory_order_relaxed) / stats.completed) : 0);
+	stats.latency_maximum = std::chrono::nanoseconds(lane.latency_maximum.load(std::memory_order_relaxed));
+	return stats;
+}
+
+std::shared_ptr<streamfx::util::threadpool::task> streamfx::util::threadpool::threadpool::allocate(task_callback_t callback, task_data_t data, time_point_t deadline)
+{
+	// The task and its reference count share one block, which goes back to the memory pool once the last reference is
+	// gone. Moving the callback in does not allocate either, as long as it was a std::function to begin with.
+	return std::allocate_shared<streamfx::util::threadpool::task>(task_allocator<streamfx::util::threadpool::task>(_task_memory), std::move(callback), std::move(data), deadline);
+}
+
+void streamfx::util::threadpool::threadpool::enqueue(lane& lane, std::shared_ptr<task> task)
+{
+	// Workers keep their own work local, everyone else distributes work round-robin.
+	size_t count = lane.queues.size();
+	bool   local = (current_pool == this) && (std::find(current_group->lanes.begin(), current_group->lanes.end(), &lane) != current_group->lanes.end());
+	size_t start = local ? current_queue : lane.queues_next.fetch_add(1, std::memory_order_relaxed);
+	for (size_t idx = 0; idx < count; idx++) {
+		if (lane.queues[(start + idx) % count]->try_push(std::move(task))) {
+			return;
+		}
+	}
+
+	std::lock_guard<std::mutex> lg(lane.overflow_lock);
+	lane.overflow.emplace_back(std::move(task));
+}
+
+bool streamfx::util::threadpool::threadpool::dequeue(std::shared_ptr<worker_info> wi, std::shared_ptr<task>& task, lane*& from)
+{
+	// Lanes are ordered by priority, so a lower priority lane is only looked at once all higher ones are empty.
+	for (auto lane : wi->group->lanes) {
+		size_t count = lane->queues.size();
+		while (lane->pending.load() > 0) {
+			bool stolen = false;
+			bool found  = false;
+
+			// Prefer our own queue, then try to steal from the others.
+			for (size_t idx = 0; idx < count; idx++) {
+				if (lane->queues[(wi->queue + idx) % count]->try_pop(task)) {
+					stolen = (idx != 0);
+					found  = true;
+					break;
+				}
+			}
+
+			if (!found) { // Nothing in the queues, so check the overflow list.
+				std::lock_guard<std::mutex> lg(lane->overflow_lock);
+				if (!lane->overflow.empty()) {
+					task = lane->overflow.front();
+					lane->overflow.pop_front();
+					found = true;
+				}
+			}
+
+			if (found) {
+				lane->pending.fetch_sub(1);
+
+				auto now     = std::chrono::high_resolution_clock::now();
+				auto latency = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - task->queued()).count());
+				auto maximum = lane->latency_maximum.load(std::memory_order_relaxed);
+				while ((latency > maximum) && !lane->latency_maximum.compare_exchange_weak(maximum, latency, std::memory_order_relaxed)) {
+				}
+				lane->latency_total.fetch_add(latency, std::memory_order_relaxed);
+				if (now > task->deadline()) {
+					lane->late.fetch_add(1, std::memory_order_relaxed);
+				}
+				if (stolen) {
+					lane->stolen.fetch_add(1, std::memory_order_relaxed);
+				}
+				from = lane;
+				return true;
+			}
+
+			// A task is still being published or was just taken by someone else.
+			std::this_thread::yield();
+		}
+	}
+	return false;
+}
+
+void streamfx::util::threadpool::threadpool::spawn(worker_group& group, size_t count)
 {
-	std::lock_guard<std::mutex> lg(_workers_lock);
-	for (size_t n = 0; (n < count) && (_worker_count < _limits.second); n++) {
+	std::lock_guard<std::mutex> lg(group.workers_lock);
+	for (size_t n = 0; (n < count) && (group.worker_count < group.limits.second); n++) {
+		// Claim the first queue which isn't owned by another worker.
+		size_t queue                = static_cast<size_t>(std::distance(group.workers_queues.begin(), std::find(group.workers_queues.begin(), group.workers_queues.end(), false)));
+		group.workers_queues[queue] = true;
+
 		auto wi            = std::make_shared<worker_info>();
 		wi->stop           = false;
 		wi->last_work_time = std::chrono::high_resolution_clock::now();
+		wi->queue          = queue;
+		wi->group          = &group;
 		wi->thread         = std::thread(std::bind(&streamfx::util::threadpool::threadpool::work, this, wi));
 		wi->thread.detach();
-		_workers.emplace_back(wi);
-		++_worker_count;
-		D_LOG_DEBUG("Spawning new worker thread (%zu < %zu < %zu).", _limits.first, _worker_count.load(), _limits.second);
+		group.workers.emplace_back(wi);
+		++group.worker_count;
+		D_LOG_DEBUG("Spawning new %s worker thread (%zu < %zu < %zu).", group.realtime ? "realtime" : "general", group.limits.first, group.worker_count.load(), group.limits.second);
 	}
 }
 
 bool streamfx::util::threadpool::threadpool::die(std::shared_ptr<worker_info> wi)
 {
-	constexpr std::chrono::seconds delay{1};
-
-	std::lock_guard<std::mutex> lg(_workers_lock);
+	auto&                       group = *wi->group;
+	std::lock_guard<std::mutex> lg(group.workers_lock);
 	bool                        result = false;
 
-	if (_worker_count > _limits.first) {
+	if (group.worker_count > group.limits.first) {
 		auto now = std::chrono::high_resolution_clock::now();
-		result   = ((wi->last_work_time + delay) <= now) && ((_last_worker_death + delay) <= now);
+		result   = ((wi->last_work_time + idle_delay) <= now) && ((group.last_worker_death + idle_delay) <= now);
 
 		if (result) {
-			_last_worker_death = now;
-			--_worker_count;
-			_workers.remove(wi);
-			D_LOG_DEBUG("Terminated idle worker thread (%zu < %zu < %zu).", _limits.first, _worker_count.load(), _limits.second);
+			group.last_worker_death = now;
+			--group.worker_count;
+			group.workers_queues[wi->queue] = false;
+			group.workers.remove(wi);
+			D_LOG_DEBUG("Terminated idle %s worker thread (%zu < %zu < %zu).", group.realtime ? "realtime" : "general", group.limits.first, group.worker_count.load(), group.limits.second);
 		}
 	}
 
@@ -193,48 +416,78 @@ bool streamfx::util::threadpool::threadpool::die(std::shared_ptr<worker_info> wi
 void streamfx::util::threadpool::threadpool::work(std::shared_ptr<worker_info> wi)
 {
 	std::shared_ptr<streamfx::util::threadpool::task> task{};
+	streamfx::util::threadpool::lane*                 lane = nullptr;
 	std::lock_guard<std::mutex>                       lg(wi->lifeline);
+	auto&                                             group = *wi->group;
+
+	current_pool  = this;
+	current_group = &group;
+	current_queue = wi->queue;
 
+	// Realtime workers must not be starved by the rest of the system, everyone else only runs when nothing else does.
 #if defined(D_PLATFORM_WINDOWS)
-	SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN | THREAD_PRIORITY_BELOW_NORMAL);
-	SetThreadDescription(GetCurrentThread(), L"StreamFX Worker Thread");
+	if (group.realtime) {
+		SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_ABOVE_NORMAL);
+		SetThreadDescription(GetCurrentThread(), L"StreamFX Realtime Worker Thread");
+	} else {
+		SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN | THREAD_PRIORITY_BELOW_NORMAL);
+		SetThreadDescription(GetCurrentThread(), L"StreamFX Worker Thread");
+	}
 #elif defined(D_PLATFORM_LINUX)
 	struct sched_param param;
 	param.sched_priority = 0;
-	pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
-	pthread_setname_np(pthread_self(), "StreamFX Worker Thread");
+	if (group.realtime) {
+		pthread_setschedparam(pthread_self(), SCHED_OTHER, &param);
+		pthread_setname_np(pthread_self(), "StreamFX RT Worker");
+	} else {
+		pthread_setschedparam(pthread_self(), SCHED_IDLE, &param);
+		pthread_setname_np(pthread_self(), "StreamFX Worker Thread");
+	}
 #endif
 
 	while (!wi->stop) {
-		{ // Try and acquire new work.
-			std::unique_lock<std::mutex> ul(_tasks_lock);
-
-			// Is there any work available right now?
-			if (_tasks.size() == 0) { // If not:
-				// Block this thread until it is notified of a change.
-				_tasks_cv.wait_until(ul, std::chrono::time_point(std::chrono::high_resolution_clock::now() + std::chrono::milliseconds(250)), [this, wi]() { return wi->stop || _tasks.size() > 0; });
-			}
-
-			// If we were asked to stop, skip everything.
-			if (wi->stop) {
-				continue;
-			}
+		// If there is work to be done, take it.
+		if (dequeue(wi, task, lane)) {
+			wi->last_work_time = std::chrono::high_resolution_clock::now();
+			task->run();
+			task.reset();
+			lane->completed.fetch_add(1, std::memory_order_relaxed);
+			continue;
+		}
 
-			// If there is work to be done, take it.
-			if (_tasks.size() > 0) {
-				wi->last_work_time = std::chrono::high_resolution_clock::now();
-				task               = _tasks.front();
-				_tasks.pop_front();
-			} else if (die(wi)) { // Is the threadpool requesting less threads?
-				break;
+		// Otherwise sleep until push() wakes us up. Workers above the minimum only sleep for a while, so they can die.
+		bool timed_out = false;
+		{
+			auto predicate = [wi, &group]() {
+				if (wi->stop) {
+					return true;
+				}
+				for (auto lane : group.lanes) {
+					if (lane->pending.load() > 0) {
+						return true;
+					}
+				}
+				return false;
+			};
+
+			std::unique_lock<std::mutex> ul(group.park_lock);
+			++group.parked;
+			if (group.worker_count > group.limits.first) {
+				timed_out = !group.park_cv.wait_for(ul, idle_delay, predicate);
+			} else {
+				group.park_cv.wait(ul, predicate);
 			}
+			--group.parked;
 		}
 
-		if (task) {
-			task->run();
-			task.reset();
+		// Is the threadpool requesting less threads?
+		if (timed_out && die(wi)) {
+			break;
 		}
 	}
+
+	current_pool  = nullptr;
+	current_group = nullptr;
 }
 
 std::shared_ptr<streamfx::util::threadpool::threadpool> streamfx::util::threadpool::threadpool::instance()
@@ -254,6 +507,7 @@ std::shared_ptr<streamfx::util::threadpool::threadpool> streamfx::util::threadpo
 static std::shared_ptr<streamfx::util::threadpool::threadpool> loader_instance;
 
 static auto loader = streamfx::loader(
+	"threadpool",
 	[]() { // Initalizer
 		loader_instance = streamfx::util::threadpool::threadpool::instance();
 	},
@@ -4,6 +4,7 @@
 
 #pragma once
 #include "warning-disable.hpp"
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <cinttypes>
@@ -16,12 +17,156 @@
 #include <new>
 #include <stdexcept>
 #include <thread>
+#include <vector>
 #include "warning-enable.hpp"
 
 namespace streamfx::util::threadpool {
 	typedef std::shared_ptr<void>            task_data_t;
 	typedef std::function<void(task_data_t)> task_callback_t;
 
+	/** Bounded lock-free multi-producer multi-consumer queue.
+	 *
+	 * Every cell carries a sequence number which tells producers and consumers whether it is free to write to or
+	 * ready to be read from, so neither side ever has to take a lock. Based on the design by Dmitry Vyukov.
+	 */
+	template<typename T>
+	class mpmc_queue {
+		struct cell {
+			std::atomic<size_t> sequence;
+			T                   data;
+		};
+
+		std::unique_ptr<cell[]> _cells;
+		size_t                  _mask;
+
+#if __cpp_lib_hardware_interference_size >= 201603
+		alignas(std::hardware_destructive_interference_size)
+#endif
+			std::atomic<size_t> _enqueue_pos;
+#if __cpp_lib_hardware_interference_size >= 201603
+		alignas(std::hardware_destructive_interference_size)
+#endif
+			std::atomic<size_t> _dequeue_pos;
+
+		public:
+		mpmc_queue(size_t capacity) : _cells(), _mask(0), _enqueue_pos(0), _dequeue_pos(0)
+		{
+			// Capacity must be a power of two.
+			size_t size = 2;
+			while (size < capacity) {
+				size <<= 1;
+			}
+
+			_cells = std::make_unique<cell[]>(size);
+			_mask  = size - 1;
+			for (size_t idx = 0; idx < size; idx++) {
+				_cells[idx].sequence.store(idx, std::memory_order_relaxed);
+			}
+		}
+
+		/** Try to enqueue a value.
+		 *
+		 * @param value Value to enqueue, only moved from if the call succeeds.
+		 * @return true if the value was enqueued, false if the queue is full.
+		 */
+		bool try_push(T&& value)
+		{
+			cell*  target;
+			size_t pos = _enqueue_pos.load(std::memory_order_relaxed);
+			while (true) {
+				target        = &_cells[pos & _mask];
+				size_t   seq  = target->sequence.load(std::memory_order_acquire);
+				intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+				if (diff == 0) {
+					if (_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+						break;
+					}
+				} else if (diff < 0) {
+					return false;
+				} else {
+					pos = _enqueue_pos.load(std::memory_order_relaxed);
+				}
+			}
+
+			target->data = std::move(value);
+			target->sequence.store(pos + 1, std::memory_order_release);
+			return true;
+		}
+
+		/** Try to dequeue a value.
+		 *
+		 * @param value Receives the dequeued value.
+		 * @return true if a value was dequeued, false if the queue is empty.
+		 */
+		bool try_pop(T& value)
+		{
+			cell*  target;
+			size_t pos = _dequeue_pos.load(std::memory_order_relaxed);
+			while (true) {
+				target        = &_cells[pos & _mask];
+				size_t   seq  = target->sequence.load(std::memory_order_acquire);
+				intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+				if (diff == 0) {
+					if (_dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+						break;
+					}
+				} else if (diff < 0) {
+					return false;
+				} else {
+					pos = _dequeue_pos.load(std::memory_order_relaxed);
+				}
+			}
+
+			value = std::move(target->data);
+			target->sequence.store(pos + _mask + 1, std::memory_order_release);
+			return true;
+		}
+
+		/** Approximate number of queued values, only exact while no other thread touches the queue.
+		 */
+		size_t size()
+		{
+			size_t enq = _enqueue_pos.load(std::memory_order_relaxed);
+			size_t deq = _dequeue_pos.load(std::memory_order_relaxed);
+			return (enq >= deq) ? (enq - deq) : 0;
+		}
+
+		size_t capacity()
+		{
+			return _mask + 1;
+		}
+	};
+
+	enum class priority : uint8_t {
+		/** Time-critical work such as audio and video, served by dedicated workers at normal scheduling priority. */
+		REALTIME,
+		/** Regular work. */
+		NORMAL,
+		/** Slow or non-urgent work such as file and network I/O, only run once there is no NORMAL work left. */
+		BACKGROUND,
+	};
+	constexpr size_t priority_count = 3;
+
+	typedef std::chrono::high_resolution_clock::time_point time_point_t;
+
+	struct lane_statistics {
+		/** Number of tasks waiting for a worker. */
+		size_t pending;
+		/** Total number of tasks pushed. */
+		uint64_t pushed;
+		/** Total number of tasks taken and run (or skipped if cancelled) by workers. */
+		uint64_t completed;
+		/** Total number of tasks a worker took from a queue other than its own. */
+		uint64_t stolen;
+		/** Total number of tasks which were started after their deadline. */
+		uint64_t late;
+		/** Average and maximum time between push() and a worker starting the task. */
+		std::chrono::nanoseconds latency_average;
+		std::chrono::nanoseconds latency_maximum;
+	};
+
+	struct worker_group;
+
 	struct worker_info {
 #if __cpp_lib_hardware_interference_size >= 201603
 		alignas(std::hardware_destructive_interference_size)
@@ -35,6 +180,12 @@ namespace streamfx::util::threadpool {
 
 		std::chrono::high_resolution_clock::time_point last_work_time;
 
+		// Index of the queue this worker prefers to take work from and push work to.
+		size_t queue;
+
+		// Group this worker belongs to.
+		worker_group* group;
+
 		std::thread thread;
 	};
 
@@ -43,6 +194,9 @@ namespace streamfx::util::threadpool {
 		task_data_t     _data;
 		std::mutex      _lock;
 
+		time_point_t _queued;
+		time_point_t _deadline;
+
 #if __cpp_lib_hardware_interference_size >= 201603
 		alignas(std::hardware_destructive_interference_size)
 #endif
@@ -61,7 +215,7 @@ namespace streamfx::util::threadpool {
 			std::atomic<bool> _failed;
 
 		public:
-		task(task_callback_t callback, task_data_t data);
+		task(task_callback_t callback, task_data_t data, time_point_t deadline = time_point_t::max());
 
 		public:
 		~task();
@@ -86,31 +240,150 @@ namespace streamfx::util::threadpool {
 
 		public:
 		void await_completion();
+
+		public:
+		/** Point in time the task was pushed.
+		 */
+		time_point_t queued();
+
+		public:
+		/** Point in time by which the task should have started, or time_point_t::max() if it has none.
+		 */
+		time_point_t deadline();
 	};
 
-	class threadpool {
-		std::pair<size_t, size_t> _limits;
+	typedef mpmc_queue<std::shared_ptr<task>> task_queue_t;
+
+	/** Recycled memory blocks for tasks, so that pushing a task does not allocate once the threadpool has warmed up.
+	 *
+	 * Tasks and their reference count live in a single block, which is always of the same type. The block size is
+	 * taken from the first allocation, anything else is passed through to operator new.
+	 */
+	class task_memory {
+		mpmc_queue<void*> _blocks;
+		std::once_flag    _block_type;
+		size_t            _size;
+		size_t            _alignment;
+
+		public:
+		task_memory(size_t capacity);
+		~task_memory();
+
+		void* allocate(size_t size, size_t alignment);
+		void  deallocate(void* ptr, size_t size, size_t alignment);
+	};
+
+	template<typename T>
+	struct task_allocator {
+		typedef T value_type;
+
+		std::shared_ptr<task_memory> memory;
+
+		task_allocator(std::shared_ptr<task_memory> memory) : memory(std::move(memory)) {}
+
+		template<typename U>
+		task_allocator(const task_allocator<U>& other) : memory(other.memory)
+		{}
+
+		T* allocate(size_t count)
+		{
+			return static_cast<T*>(memory->allocate(sizeof(T) * count, alignof(T)));
+		}
+
+		void deallocate(T* ptr, size_t count)
+		{
+			memory->deallocate(ptr, sizeof(T) * count, alignof(T));
+		}
+
+		template<typename U>
+		bool operator==(const task_allocator<U>& rhs) const
+		{
+			return memory == rhs.memory;
+		}
+
+		template<typename U>
+		bool operator!=(const task_allocator<U>& rhs) const
+		{
+			return memory != rhs.memory;
+		}
+	};
+
+	/** All queued work of a single priority.
+	 */
+	struct lane {
+		// One queue per potential worker, other workers steal from it once their own queue runs dry.
+		std::vector<std::unique_ptr<task_queue_t>> queues;
+#if __cpp_lib_hardware_interference_size >= 201603
+		alignas(std::hardware_destructive_interference_size)
+#endif
+			std::atomic<size_t> queues_next;
+
+		// Fallback for when every queue is full.
+#if __cpp_lib_hardware_interference_size >= 201603
+		alignas(std::hardware_destructive_interference_size)
+#endif
+			std::mutex overflow_lock;
+		std::list<std::shared_ptr<task>> overflow;
+
+		// Number of tasks which have been queued but not yet taken by a worker.
+#if __cpp_lib_hardware_interference_size >= 201603
+		alignas(std::hardware_destructive_interference_size)
+#endif
+			std::atomic<size_t> pending;
+
+		// Statistics
+#if __cpp_lib_hardware_interference_size >= 201603
+		alignas(std::hardware_destructive_interference_size)
+#endif
+			std::atomic<uint64_t> pushed;
+#if __cpp_lib_hardware_interference_size >= 201603
+		alignas(std::hardware_destructive_interference_size)
+#endif
+			std::atomic<uint64_t> completed;
+		std::atomic<uint64_t> stolen;
+		std::atomic<uint64_t> late;
+		std::atomic<uint64_t> latency_total;
+		std::atomic<uint64_t> latency_maximum;
+	};
+
+	/** A set of workers sharing the same scheduling priority, serving one or more lanes in order.
+	 */
+	struct worker_group {
+		std::pair<size_t, size_t> limits;
+		bool                      realtime;
+		std::vector<lane*>        lanes;
 
 #if __cpp_lib_hardware_interference_size >= 201603
 		alignas(std::hardware_destructive_interference_size)
 #endif
-			std::mutex _workers_lock;
-		std::list<std::shared_ptr<worker_info>> _workers;
+			std::mutex workers_lock;
+		std::list<std::shared_ptr<worker_info>> workers;
+		std::vector<bool>                       workers_queues;
 #if __cpp_lib_hardware_interference_size >= 201603
 		alignas(std::hardware_destructive_interference_size)
 #endif
-			std::atomic<size_t> _worker_count;
-		std::chrono::high_resolution_clock::time_point _last_worker_death;
+			std::atomic<size_t> worker_count;
+		std::chrono::high_resolution_clock::time_point last_worker_death;
 
+		// Idle workers sleep here until new work is pushed.
 #if __cpp_lib_hardware_interference_size >= 201603
 		alignas(std::hardware_destructive_interference_size)
 #endif
-			std::mutex _tasks_lock;
+			std::mutex park_lock;
+		std::condition_variable park_cv;
 #if __cpp_lib_hardware_interference_size >= 201603
 		alignas(std::hardware_destructive_interference_size)
 #endif
-			std::condition_variable _tasks_cv;
-		std::list<std::shared_ptr<task>> _tasks;
+			std::atomic<size_t> parked;
+	};
+
+	class threadpool {
+		std::array<lane, priority_count> _lanes;
+		worker_group                     _realtime;
+		worker_group                     _general;
+
+		// Recycled task memory, shared with the tasks themselves as they may outlive the threadpool.
+		std::shared_ptr<task_memory> _task_memory;
 
 		public:
 		~threadpool();
@@ -119,13 +392,32 @@ namespace streamfx::util::threadpool {
 		threadpool(size_t minimum = 2, size_t maximum = std::thread::hardware_concurrency());
 
 		public:
-		std::shared_ptr<task> push(task_callback_t callback, task_data_t data = nullptr);
+		/** Queue a new task.
+		 *
+		 * @param callback Function to call on a worker thread.
+		 * @param data Data to pass to the callback.
+		 * @param priority Lane to queue the task in, REALTIME work never waits behind NORMAL or BACKGROUND work.
+		 * @param deadline Point in time by which the task should have started, tasks starting later are counted as late.
+		 */
+		std::shared_ptr<task> push(task_callback_t callback, task_data_t data = nullptr, priority priority = priority::NORMAL, time_point_t deadline = time_point_t::max());
 
 		public:
 		void pop(std::shared_ptr<task> task);
 
+		public:
+		lane_statistics statistics(priority priority);
+
+		private:
+		std::shared_ptr<task> allocate(task_callback_t callback, task_data_t data, time_point_t deadline);
+
+		private:
+		void enqueue(lane& lane, std::shared_ptr<task> task);
+
+		private:
+		bool dequeue(std::shared_ptr<worker_info> wi, std::shared_ptr<task>& task, lane*& from);
+
 		private:
-		void spawn(size_t count = 1);
+		void spawn(worker_group& group, size_t count = 1);
 
 		private:
 		bool die(std::shared_ptr<worker_info>);
@@ -0,0 +1,646 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2023 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+// Filters and encoders of the StreamFX module in a headless libOBS.
+//
+// Starts libOBS without a user interface, loads the StreamFX module that was built alongside, and runs each filter on a
+// synthetic noise pattern at 720p, and in full mode also at 1080p and 4K. Every filter is rendered into an off-screen
+// target and reports its per-frame CPU time and C++ allocations. If the module was built with ENABLE_PROFILING, its
+// render target passes and parameter lookups per frame are picked up from the log as well.
+//
+// The software encoders then encode the same pattern through a dummy output, and report their frame rate and C++
+// allocations per packet. Allocations are counted across all threads, including those of libOBS. Software encoders
+// never touch the graphics device, so the render thread must not lag behind any more than it does without them. The
+// number of lagged frames and the time the main thread waits for the graphics context are compared against a run
+// without an encoder.
+//
+// libOBS needs a working graphics device. On Linux that is an X11 display with EGL, so run the program through
+// xvfb-run with LIBGL_ALWAYS_SOFTWARE=1 to use Mesa llvmpipe on machines without a GPU. Allocations are counted by
+// replacing the global operator new, which the module only picks up where the executable exports it (Linux and macOS).
+
+#include "tests.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <condition_variable>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <new>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "warning-enable.hpp"
+
+#include "warning-disable.hpp"
+extern "C" {
+#include <obs.h>
+
+#include <obs-encoder.h>
+#include <obs-module.h>
+#include <obs-output.h>
+#include <obs-source.h>
+#ifdef __linux__
+#include <obs-nix-platform.h>
+#endif
+
+#include <graphics/graphics.h>
+#include <util/base.h>
+#include <util/platform.h>
+}
+#ifdef __linux__
+#include <X11/Xlib.h>
+#endif
+#include "warning-enable.hpp"
+
+// Exit code when there is nothing to run on, the usual code for a skipped test.
+constexpr int skipped = 77;
+
+//------------------------------------------------------------------------------
+// Allocations
+//------------------------------------------------------------------------------
+
+static std::atomic<uint64_t> allocations{0};
+
+static void* allocate(std::size_t size, std::size_t alignment)
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	size = std::max<std::size_t>(size, 1);
+	if (alignment <= alignof(std::max_align_t)) {
+		return std::malloc(size);
+	}
+#ifdef _WIN32
+	return _aligned_malloc(size, alignment);
+#else
+	return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+}
+
+static void deallocate(void* ptr, [[maybe_unused]] std::size_t alignment) noexcept
+{
+#ifdef _WIN32
+	if (alignment > alignof(std::max_align_t)) {
+		_aligned_free(ptr);
+		return;
+	}
+#endif
+	std::free(ptr);
+}
+
+void* operator new(std::size_t size)
+{
+	if (void* ptr = allocate(size, 0); ptr) {
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	if (void* ptr = allocate(size, static_cast<std::size_t>(alignment)); ptr) {
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment)
+{
+	return operator new(size, alignment);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+	return allocate(size, 0);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+	return allocate(size, 0);
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+	return allocate(size, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* ptr) noexcept
+{
+	deallocate(ptr, 0);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+	deallocate(ptr, 0);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+	deallocate(ptr, 0);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+	deallocate(ptr, 0);
+}
+
+void operator delete(void* ptr, std::align_val_t alignment) noexcept
+{
+	deallocate(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* ptr, std::align_val_t alignment) noexcept
+{
+	deallocate(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t alignment) noexcept
+{
+	deallocate(ptr, static_cast<std::size_t>(alignment));
+}
+
+void operator delete[](void* ptr, std::size_t, std::align_val_t alignment) noexcept
+{
+	deallocate(ptr, static_cast<std::size_t>(alignment));
+}
+
+//------------------------------------------------------------------------------
+// Log
+//------------------------------------------------------------------------------
+
+struct render_counters {
+	double passes;
+	double lookups;
+};
+
+static std::mutex                             log_lock;
+static std::condition_variable                log_cv;
+static std::map<std::string, render_counters> log_counters;
+static bool                                   log_verbose = false;
+
+static void log_handler(int level, const char* format, va_list args, void*)
+{
+	char message[4096];
+	vsnprintf(message, sizeof(message), format, args);
+
+	// See streamfx::obs::source_instance::~source_instance().
+	if (const char* rendered = strstr(message, "> Rendered "); rendered) {
+		const char*     name = strchr(message, '<');
+		render_counters counters;
+		if (name && (name < rendered) && (sscanf(rendered, "> Rendered %*u frames with %*f ms average, %*f ms 99th percentile CPU time, %lf render target passes and %lf parameter lookups per frame.", &counters.passes, &counters.lookups) == 2)) {
+			std::unique_lock<std::mutex> lg(log_lock);
+			log_counters.emplace(std::string(name + 1, rendered), counters);
+			log_cv.notify_all();
+		}
+	}
+
+	if (log_verbose || (level <= LOG_WARNING)) {
+		std::unique_lock<std::mutex> lg(log_lock);
+		fprintf(stderr, "%s\n", message);
+	}
+}
+
+/** Wait for the counters the module logs when the named filter is destroyed.
+ */
+static bool wait_for_counters(const std::string& name, render_counters& counters, std::chrono::milliseconds timeout)
+{
+	std::unique_lock<std::mutex> ul(log_lock);
+	if (!log_cv.wait_for(ul, timeout, [&name]() { return log_counters.count(name) > 0; })) {
+		return false;
+	}
+	counters = log_counters[name];
+	return true;
+}
+
+//------------------------------------------------------------------------------
+// Pattern Source
+//------------------------------------------------------------------------------
+
+/** Noise inside a centered ellipse and transparency outside of it, so that alpha based filters have an edge to work on.
+ */
+struct pattern {
+	uint32_t      width;
+	uint32_t      height;
+	gs_texture_t* texture;
+
+	pattern(obs_data_t* settings) : width(uint32_t(obs_data_get_int(settings, "width"))), height(uint32_t(obs_data_get_int(settings, "height"))), texture(nullptr)
+	{
+		std::mt19937          rng(width * height);
+		std::vector<uint32_t> pixels(std::size_t(width) * height);
+		for (uint32_t y = 0; y < height; y++) {
+			for (uint32_t x = 0; x < width; x++) {
+				double dx = (double(x) / double(width)) * 2. - 1.;
+				double dy = (double(y) / double(height)) * 2. - 1.;
+				pixels[std::size_t(y) * width + x] = ((dx * dx + dy * dy) <= 0.64) ? (rng() | 0xFF000000) : 0;
+			}
+		}
+
+		const uint8_t* data = reinterpret_cast<const uint8_t*>(pixels.data());
+		obs_enter_graphics();
+		texture = gs_texture_create(width, height, GS_RGBA, 1, &data, 0);
+		obs_leave_graphics();
+	}
+
+	~pattern()
+	{
+		obs_enter_graphics();
+		gs_texture_destroy(texture);
+		obs_leave_graphics();
+	}
+
+	void render()
+	{
+		gs_effect_t* effect = obs_get_base_effect(OBS_EFFECT_DEFAULT);
+		gs_effect_set_texture(gs_effect_get_param_by_name(effect, "image"), texture);
+		while (gs_effect_loop(effect, "Draw")) {
+			gs_draw_sprite(texture, 0, width, height);
+		}
+	}
+};
+
+static void register_pattern()
+{
+	obs_source_info info = {};
+	info.id              = "streamfx-bench-pattern";
+	info.type            = OBS_SOURCE_TYPE_INPUT;
+	info.output_flags    = OBS_SOURCE_VIDEO | OBS_SOURCE_CUSTOM_DRAW;
+	info.get_name        = [](void*) { return "Pattern"; };
+	info.create          = [](obs_data_t* settings, obs_source_t*) -> void* { return new pattern(settings); };
+	info.destroy         = [](void* data) { delete static_cast<pattern*>(data); };
+	info.get_width       = [](void* data) { return static_cast<pattern*>(data)->width; };
+	info.get_height      = [](void* data) { return static_cast<pattern*>(data)->height; };
+	info.video_render    = [](void* data, gs_effect_t*) { static_cast<pattern*>(data)->render(); };
+	obs_register_source(&info);
+}
+
+static obs_source_t* create_pattern(uint32_t width, uint32_t height)
+{
+	obs_data_t* settings = obs_data_create();
+	obs_data_set_int(settings, "width", width);
+	obs_data_set_int(settings, "height", height);
+	obs_source_t* source = obs_source_create_private("streamfx-bench-pattern", "Pattern", settings);
+	obs_data_release(settings);
+	return source;
+}
+
+//------------------------------------------------------------------------------
+// Dummy Output
+//------------------------------------------------------------------------------
+
+/** Counts the packets of its video encoder and throws them away.
+ */
+struct dummy_output {
+	obs_output_t*         self;
+	std::atomic<uint64_t> packets;
+	std::atomic<uint64_t> bytes;
+
+	dummy_output(obs_output_t* output) : self(output), packets(0), bytes(0) {}
+};
+
+static void register_output()
+{
+	obs_output_info info = {};
+	info.id              = "streamfx-bench-output";
+	info.flags           = OBS_OUTPUT_VIDEO | OBS_OUTPUT_ENCODED;
+	info.get_name        = [](void*) { return "Dummy"; };
+	info.create          = [](obs_data_t*, obs_output_t* output) -> void* { return new dummy_output(output); };
+	info.destroy         = [](void* data) { delete static_cast<dummy_output*>(data); };
+	info.start           = [](void* data) {
+		auto self = static_cast<dummy_output*>(data)->self;
+		return obs_output_can_begin_data_capture(self, 0) && obs_output_initialize_encoders(self, 0) && obs_output_begin_data_capture(self, 0);
+	};
+	info.stop = [](void* data, uint64_t) { obs_output_end_data_capture(static_cast<dummy_output*>(data)->self); };
+	info.encoded_packet = [](void* data, encoder_packet* packet) {
+		if (packet) {
+			static_cast<dummy_output*>(data)->packets++;
+			static_cast<dummy_output*>(data)->bytes += packet->size;
+		}
+	};
+	obs_register_output(&info);
+}
+
+//------------------------------------------------------------------------------
+// Filters
+//------------------------------------------------------------------------------
+
+struct filter_case {
+	const char*                      name;
+	const char*                      id;
+	std::function<void(obs_data_t*)> settings;
+};
+
+static std::vector<filter_case> filter_cases()
+{
+	std::vector<filter_case> cases;
+	for (auto type : {"box", "box_linear", "gaussian", "gaussian_linear", "gaussian_cascade", "dual_filtering"}) {
+		cases.push_back({type, "streamfx-filter-blur", [type](obs_data_t* settings) {
+							 obs_data_set_string(settings, "Filter.Blur.Type", type);
+							 obs_data_set_string(settings, "Filter.Blur.SubType", "area");
+							 obs_data_set_double(settings, "Filter.Blur.Size", (strcmp(type, "gaussian_cascade") == 0) ? 64. : 16.);
+						 }});
+	}
+	cases.push_back({"color-grade", "streamfx-filter-color-grade", [](obs_data_t* settings) {
+						 obs_data_set_double(settings, "Filter.ColorGrade.Lift.Red", 10.);
+						 obs_data_set_double(settings, "Filter.ColorGrade.Gain.Blue", 110.);
+					 }});
+	cases.push_back({"sdf-effects", "streamfx-filter-sdf-effects", [](obs_data_t* settings) {
+						 obs_data_set_bool(settings, "Filter.SDFEffects.Shadow.Outer", true);
+						 obs_data_set_bool(settings, "Filter.SDFEffects.Glow.Outer", true);
+						 obs_data_set_bool(settings, "Filter.SDFEffects.Outline", true);
+					 }});
+	cases.push_back({"transform", "streamfx-filter-transform", [](obs_data_t* settings) {
+						 obs_data_set_double(settings, "Rotation.X", 15.);
+						 obs_data_set_double(settings, "Rotation.Z", 30.);
+					 }});
+	// Without a mask source and shader file, these measure the cost of passing the input through.
+	cases.push_back({"dynamic-mask", "streamfx-filter-dynamic-mask", [](obs_data_t*) {}});
+	cases.push_back({"shader", "streamfx-filter-shader", [](obs_data_t*) {}});
+	return cases;
+}
+
+static void bench_filter(const filter_case& test, uint32_t width, uint32_t height, std::size_t frames, bool& profiling)
+{
+	std::string name = std::string(test.name) + "@" + std::to_string(width) + "x" + std::to_string(height);
+
+	obs_data_t* settings = obs_data_create();
+	test.settings(settings);
+	obs_source_t* filter = obs_source_create_private(test.id, name.c_str(), settings);
+	obs_data_release(settings);
+	if (!filter) {
+		printf("%-32s not available\n", name.c_str());
+		return;
+	}
+
+	obs_source_t* source = create_pattern(width, height);
+	obs_source_filter_add(source, filter);
+
+	obs_enter_graphics();
+	gs_texrender_t* target = gs_texrender_create(GS_RGBA, GS_ZS_NONE);
+	obs_leave_graphics();
+
+	std::vector<double> times;
+	uint64_t            allocated = 0;
+	times.reserve(frames);
+	for (std::size_t frame = 0; frame < frames + 10; frame++) {
+		obs_enter_graphics();
+		uint64_t               before = allocations.load();
+		streamfx::tests::timer tm;
+		gs_texrender_reset(target);
+		if (gs_texrender_begin(target, width, height)) {
+			vec4 black = {};
+			gs_clear(GS_CLEAR_COLOR, &black, 0, 0);
+			gs_ortho(0, float(width), 0, float(height), -1, 1);
+			obs_source_video_render(source);
+			gs_texrender_end(target);
+		}
+		double   time  = tm.seconds();
+		uint64_t after = allocations.load();
+		gs_flush();
+		obs_leave_graphics();
+
+		// The first frames create the resources.
+		if (frame >= 10) {
+			times.push_back(time);
+			allocated += after - before;
+		}
+	}
+
+	obs_enter_graphics();
+	gs_texrender_destroy(target);
+	obs_leave_graphics();
+	obs_source_filter_remove(source, filter);
+	obs_source_release(filter);
+	obs_source_release(source);
+
+	std::sort(times.begin(), times.end());
+	double average = 0.;
+	for (auto time : times) {
+		average += time;
+	}
+	average /= double(times.size());
+
+	render_counters counters;
+	if (profiling && wait_for_counters(name, counters, std::chrono::seconds(2))) {
+		printf("%-32s %8.3f ms average, %8.3f ms 99th percentile, %8.2f allocations, %6.2f passes, %6.2f lookups per frame\n", name.c_str(), average * 1000., times[times.size() * 99 / 100] * 1000., double(allocated) / double(frames), counters.passes, counters.lookups);
+	} else {
+		// Without ENABLE_PROFILING the module never logs them, so stop waiting.
+		profiling = false;
+		printf("%-32s %8.3f ms average, %8.3f ms 99th percentile, %8.2f allocations per frame\n", name.c_str(), average * 1000., times[times.size() * 99 / 100] * 1000., double(allocated) / double(frames));
+	}
+}
+
+//------------------------------------------------------------------------------
+// Encoders
+//------------------------------------------------------------------------------
+
+struct render_thread {
+	uint64_t frames;
+	uint64_t lagged;
+	double   average;
+	double   wait;
+};
+
+/** Watch the render thread for a while, by how many frames it skips and how long it takes to get the graphics context.
+ */
+static render_thread watch_render_thread(double seconds)
+{
+	uint32_t            total  = obs_get_total_frames();
+	uint32_t            lagged = obs_get_lagged_frames();
+	std::vector<double> waits;
+	waits.reserve(std::size_t(seconds * 1000.));
+
+	streamfx::tests::timer tm;
+	while (tm.seconds() < seconds) {
+		streamfx::tests::timer wait;
+		obs_enter_graphics();
+		waits.push_back(wait.seconds());
+		obs_leave_graphics();
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	std::sort(waits.begin(), waits.end());
+
+	return {obs_get_total_frames() - total, obs_get_lagged_frames() - lagged, double(obs_get_average_frame_time_ns()) / 1000000., waits[waits.size() * 99 / 100] * 1000.};
+}
+
+static void bench_encoder(const char* id, uint32_t width, uint32_t height, double seconds, const render_thread& baseline)
+{
+	std::string    name    = std::string(id) + "@" + std::to_string(width) + "x" + std::to_string(height);
+	obs_encoder_t* encoder = obs_video_encoder_create(id, name.c_str(), nullptr, nullptr);
+	obs_output_t*  output  = obs_output_create("streamfx-bench-output", name.c_str(), nullptr, nullptr);
+	obs_encoder_set_video(encoder, obs_get_video());
+	obs_output_set_video_encoder(output, encoder);
+	if (!obs_output_start(output)) {
+		printf("%-32s failed to start\n", name.c_str());
+		obs_output_release(output);
+		obs_encoder_release(encoder);
+		return;
+	}
+
+	auto     context = static_cast<dummy_output*>(obs_obj_get_data(output));
+	uint64_t packets = context->packets;
+	uint64_t bytes   = context->bytes;
+	uint64_t before  = allocations.load();
+	auto     watched = watch_render_thread(seconds);
+	uint64_t after   = allocations.load();
+	packets          = context->packets - packets;
+	bytes            = context->bytes - bytes;
+
+	obs_output_stop(output);
+	for (streamfx::tests::timer tm; obs_output_active(output) && (tm.seconds() < 10.);) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(10));
+	}
+	obs_output_release(output);
+	obs_encoder_release(encoder);
+
+	printf("%-32s %7.2f fps, %8.2f Mbit/s, %8.2f allocations per packet, %4" PRIu64 " of %4" PRIu64 " frames lagged, %6.3f ms frame time, %6.3f ms 99th percentile graphics wait\n", name.c_str(), double(packets) / seconds, double(bytes) * 8. / seconds / 1000000., double(after - before) / double(std::max<uint64_t>(packets, 1)), watched.lagged, watched.frames, watched.average, watched.wait);
+	ST_CHECK(packets > 0, "%s produced no packets.", name.c_str());
+
+	// Hardware encoders share the graphics device with libOBS and have to take the graphics context.
+	if ((obs_get_encoder_caps(id) & OBS_ENCODER_CAP_PASS_TEXTURE) == 0) {
+		ST_CHECK(watched.lagged <= baseline.lagged + std::max<uint64_t>(watched.frames / 50, 1), "%s lagged %" PRIu64 " frames, %" PRIu64 " without an encoder.", name.c_str(), watched.lagged, baseline.lagged);
+	}
+}
+
+//------------------------------------------------------------------------------
+// Main
+//------------------------------------------------------------------------------
+
+static bool reset_video(uint32_t width, uint32_t height)
+{
+	obs_video_info ovi = {};
+#ifdef _WIN32
+	ovi.graphics_module = "libobs-d3d11";
+#else
+	ovi.graphics_module = "libobs-opengl";
+#endif
+	ovi.fps_num        = 60;
+	ovi.fps_den        = 1;
+	ovi.base_width     = width;
+	ovi.base_height    = height;
+	ovi.output_width   = width;
+	ovi.output_height  = height;
+	ovi.output_format  = VIDEO_FORMAT_NV12;
+	ovi.adapter        = 0;
+	ovi.gpu_conversion = true;
+	ovi.colorspace     = VIDEO_CS_709;
+	ovi.range          = VIDEO_RANGE_PARTIAL;
+	ovi.scale_type     = OBS_SCALE_BICUBIC;
+	return obs_reset_video(&ovi) == OBS_VIDEO_SUCCESS;
+}
+
+static bool has_argument(int argc, const char* argv[], const char* name)
+{
+	for (int idx = 1; idx < argc; idx++) {
+		if (strcmp(argv[idx], name) == 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+int main(int argc, const char* argv[])
+{
+	bool full     = streamfx::tests::full(argc, argv);
+	bool filters  = !has_argument(argc, argv, "--encoders");
+	bool encoders = !has_argument(argc, argv, "--filters");
+	log_verbose   = has_argument(argc, argv, "--verbose");
+	base_set_log_handler(&log_handler, nullptr);
+
+#ifdef __linux__
+	Display* display = XOpenDisplay(nullptr);
+	if (!display) {
+		fprintf(stderr, "No X11 display, run this through xvfb-run.\n");
+		return skipped;
+	}
+	obs_set_nix_platform(OBS_NIX_PLATFORM_X11_EGL);
+	obs_set_nix_platform_display(display);
+#endif
+
+	auto config = std::filesystem::temp_directory_path() / "streamfx-bench";
+	if (!obs_startup("en-US", config.u8string().c_str(), nullptr)) {
+		fprintf(stderr, "Failed to start libOBS.\n");
+		return skipped;
+	}
+
+	std::vector<std::pair<uint32_t, uint32_t>> sizes = {{1280, 720}};
+	if (full) {
+		sizes = {{1280, 720}, {1920, 1080}, {3840, 2160}};
+	}
+
+	obs_audio_info oai = {};
+	oai.samples_per_sec = 48000;
+	oai.speakers        = SPEAKERS_STEREO;
+	if (!reset_video(sizes.front().first, sizes.front().second) || !obs_reset_audio(&oai)) {
+		fprintf(stderr, "Failed to initialize graphics, is there a working OpenGL or Direct3D 11 driver?\n");
+		obs_shutdown();
+		return skipped;
+	}
+
+	register_pattern();
+	register_output();
+
+	obs_module_t* module = nullptr;
+	if ((obs_open_module(&module, STREAMFX_BENCH_MODULE, STREAMFX_BENCH_DATA) != MODULE_SUCCESS) || !obs_init_module(module)) {
+		ST_CHECK(false, "Failed to load '%s'.", STREAMFX_BENCH_MODULE);
+		obs_shutdown();
+		return streamfx::tests::failures();
+	}
+	obs_post_load_modules();
+
+	bool profiling = true;
+	for (auto size : sizes) {
+		if (!reset_video(size.first, size.second)) {
+			ST_CHECK(false, "Failed to switch to %ux%u.", size.first, size.second);
+			continue;
+		}
+
+		if (filters) {
+			for (auto& test : filter_cases()) {
+				bench_filter(test, size.first, size.second, full ? 600 : 60, profiling);
+			}
+		}
+
+		if (encoders) {
+			obs_source_t* source = create_pattern(size.first, size.second);
+			obs_set_output_source(0, source);
+
+			double seconds  = full ? 20. : 3.;
+			auto   baseline = watch_render_thread(seconds);
+			printf("%-32s %4" PRIu64 " of %4" PRIu64 " frames lagged, %6.3f ms frame time, %6.3f ms 99th percentile graphics wait\n", "no encoder", baseline.lagged, baseline.frames, baseline.average, baseline.wait);
+
+			const char* id = nullptr;
+			for (std::size_t idx = 0; obs_enum_encoder_types(idx, &id); idx++) {
+				if ((strncmp(id, "streamfx-", 9) != 0) || (obs_get_encoder_type(id) != OBS_ENCODER_VIDEO) || (obs_get_encoder_caps(id) & OBS_ENCODER_CAP_DEPRECATED)) {
+					continue;
+				}
+				bench_encoder(id, size.first, size.second, seconds, baseline);
+			}
+
+			obs_set_output_source(0, nullptr);
+			obs_source_release(source);
+		}
+	}
+
+	obs_shutdown();
+#ifdef __linux__
+	XCloseDisplay(display);
+#endif
+	return streamfx::tests::failures();
+}
@@ -0,0 +1,217 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2023 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+// Fuzzing and throughput of ffmpeg::bitstream.
+//
+// The scanner is compared against a byte-wise reference on random buffers which are mostly made of 0x00 and 0x01, and
+// the OBU splitter is fed both valid and corrupted streams. The instruction set is picked at compile time, so build
+// with different TARGET_* options to test the scalar, SSE2, AVX2 or NEON path.
+
+#include "tests.hpp"
+#include "ffmpeg/bitstream.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+#include "warning-enable.hpp"
+
+using namespace streamfx::ffmpeg;
+
+static const uint8_t* reference_find_start_code(const uint8_t* ptr, const uint8_t* end)
+{
+	for (; (end - ptr) >= 3; ptr++) {
+		if ((ptr[0] == 0x00) && (ptr[1] == 0x00) && (ptr[2] == 0x01)) {
+			return ptr;
+		}
+	}
+	return end;
+}
+
+static std::vector<bitstream::unit> reference_split_annexb(uint8_t* data, std::size_t size)
+{
+	std::vector<bitstream::unit> units;
+	uint8_t*                     end = data + size;
+	for (auto ptr = const_cast<uint8_t*>(reference_find_start_code(data, end)); ptr < end;) {
+		auto next = const_cast<uint8_t*>(reference_find_start_code(ptr + 3, end));
+		auto last = next;
+		while ((last > (ptr + 3)) && (last[-1] == 0x00)) {
+			last--;
+		}
+		if (last > (ptr + 3)) {
+			units.push_back({((ptr > data) && (ptr[-1] == 0x00)) ? ptr - 1 : ptr, ptr + 3, static_cast<std::size_t>(last - ptr - 3)});
+		}
+		ptr = next;
+	}
+	return units;
+}
+
+/** Buffer with nothing after its last byte, so that sanitizers catch reads past the end. */
+static std::unique_ptr<uint8_t[]> random_buffer(std::mt19937& rng, std::size_t size)
+{
+	auto buffer = std::make_unique<uint8_t[]>(size);
+	for (std::size_t idx = 0; idx < size; idx++) {
+		uint32_t value = rng() % 16;
+		buffer[idx]    = (value < 8) ? 0x00 : ((value < 12) ? 0x01 : static_cast<uint8_t>(rng()));
+	}
+	return buffer;
+}
+
+static void fuzz_annexb(std::mt19937& rng, std::size_t size)
+{
+	auto     buffer = random_buffer(rng, size);
+	uint8_t* data   = buffer.get();
+	uint8_t* end    = data + size;
+
+	for (std::size_t offset = 0; offset <= size; offset++) {
+		const uint8_t* found    = bitstream::find_start_code(data + offset, end);
+		const uint8_t* expected = reference_find_start_code(data + offset, end);
+		if (found != expected) {
+			ST_CHECK(found == expected, "Start code search from %zu of %zu found %td instead of %td.", offset, size, found - data, expected - data);
+			return;
+		}
+	}
+
+	std::vector<bitstream::unit> units;
+	bitstream::split_annexb(data, size, units);
+	auto expected = reference_split_annexb(data, size);
+	ST_CHECK(units.size() == expected.size(), "Found %zu instead of %zu NAL units in %zu bytes.", units.size(), expected.size(), size);
+	for (std::size_t idx = 0; (idx < units.size()) && (idx < expected.size()); idx++) {
+		auto& unit = units[idx];
+		ST_CHECK((unit.prefix == expected[idx].prefix) && (unit.data == expected[idx].data) && (unit.size == expected[idx].size), "NAL unit %zu differs: %td+%zu instead of %td+%zu.", idx, unit.data - data, unit.size, expected[idx].data - data, expected[idx].size);
+		ST_CHECK((unit.begin() >= data) && (unit.end() <= end) && ((idx == 0) || (unit.begin() >= units[idx - 1].end())), "NAL unit %zu is out of bounds or overlaps.", idx);
+	}
+}
+
+static void write_leb128(std::vector<uint8_t>& buffer, uint64_t value)
+{
+	do {
+		uint8_t byte = value & 0x7F;
+		value >>= 7;
+		buffer.push_back(byte | ((value != 0) ? 0x80 : 0x00));
+	} while (value != 0);
+}
+
+static void fuzz_obu(std::mt19937& rng)
+{
+	// Build a valid stream, optionally ending in a unit without a size field.
+	std::vector<uint8_t>     stream;
+	std::vector<std::size_t> offsets;
+	std::size_t              count = rng() % 8;
+	for (std::size_t idx = 0; idx < count; idx++) {
+		bool    last      = (idx + 1 == count);
+		bool    has_size  = !last || ((rng() % 2) == 0);
+		bool    extension = (rng() % 2) == 0;
+		uint8_t header    = static_cast<uint8_t>(((rng() % 16) << 3) | (extension ? 0x04 : 0x00) | (has_size ? 0x02 : 0x00));
+
+		offsets.push_back(stream.size());
+		stream.push_back(header);
+		if (extension) {
+			stream.push_back(static_cast<uint8_t>(rng()));
+		}
+		std::size_t payload = rng() % 300;
+		if (has_size) {
+			write_leb128(stream, payload);
+		}
+		for (std::size_t byte = 0; byte < payload; byte++) {
+			stream.push_back(static_cast<uint8_t>(rng()));
+		}
+	}
+
+	std::vector<bitstream::unit> units;
+	{
+		auto buffer = std::make_unique<uint8_t[]>(stream.size());
+		std::copy(stream.begin(), stream.end(), buffer.get());
+		bool valid = bitstream::split_obu(buffer.get(), stream.size(), units);
+		ST_CHECK(valid && (units.size() == offsets.size()), "Valid stream of %zu OBUs was split into %zu.", offsets.size(), units.size());
+		for (std::size_t idx = 0; valid && (idx < units.size()) && (idx < offsets.size()); idx++) {
+			std::size_t size = ((idx + 1 < offsets.size()) ? offsets[idx + 1] : stream.size()) - offsets[idx];
+			ST_CHECK((units[idx].data == buffer.get() + offsets[idx]) && (units[idx].size == size), "OBU %zu is %td+%zu instead of %zu+%zu.", idx, units[idx].data - buffer.get(), units[idx].size, offsets[idx], size);
+		}
+	}
+
+	// Corrupt or cut it, which must never lead to units outside of the buffer.
+	if (!stream.empty()) {
+		stream[rng() % stream.size()] ^= static_cast<uint8_t>(1 << (rng() % 8));
+		stream.resize(rng() % (stream.size() + 1));
+	}
+	auto     buffer = std::make_unique<uint8_t[]>(stream.size());
+	uint8_t* end    = buffer.get() + stream.size();
+	std::copy(stream.begin(), stream.end(), buffer.get());
+	bool valid = bitstream::split_obu(buffer.get(), stream.size(), units);
+
+	uint8_t* ptr = buffer.get();
+	for (auto& unit : units) {
+		ST_CHECK((unit.data == ptr) && (unit.size > 0) && (unit.end() <= end), "OBU at %td+%zu is out of bounds or not contiguous.", unit.data - buffer.get(), unit.size);
+		ptr = unit.end();
+	}
+	ST_CHECK(!valid || (ptr == end), "Stream was accepted, but only %td of %zu bytes were split.", ptr - buffer.get(), stream.size());
+}
+
+/** NAL units of random content, with emulation prevention applied like an encoder would. */
+static std::vector<uint8_t> synthetic_stream(std::mt19937& rng, std::size_t size)
+{
+	std::vector<uint8_t> stream;
+	stream.reserve(size + 16);
+	while (stream.size() < size) {
+		stream.insert(stream.end(), {0x00, 0x00, 0x00, 0x01});
+		std::size_t length = 1024 + (rng() % 65536);
+		std::size_t zeroes = 0;
+		for (std::size_t idx = 0; idx < length; idx++) {
+			// Real slice data is far from uniform, zero runs are common.
+			uint8_t byte = ((rng() % 4) == 0) ? 0x00 : static_cast<uint8_t>(rng());
+			if ((zeroes >= 2) && (byte <= 0x03)) {
+				stream.push_back(0x03);
+				zeroes = 0;
+			}
+			stream.push_back(byte);
+			zeroes = (byte == 0x00) ? (zeroes + 1) : 0;
+		}
+		stream.push_back(0x80); // rbsp_stop_one_bit
+	}
+	return stream;
+}
+
+static void benchmark(std::mt19937& rng, std::size_t size, std::size_t iterations)
+{
+	auto                         stream = synthetic_stream(rng, size);
+	std::vector<bitstream::unit> units;
+	std::size_t                  found = 0;
+
+	streamfx::tests::timer tm;
+	for (std::size_t idx = 0; idx < iterations; idx++) {
+		bitstream::split_annexb(stream.data(), stream.size(), units);
+		found += units.size();
+	}
+	double time = tm.seconds();
+
+	tm                   = {};
+	std::size_t expected = 0;
+	for (std::size_t idx = 0; idx < iterations; idx++) {
+		expected += reference_split_annexb(stream.data(), stream.size()).size();
+	}
+	double reference = tm.seconds();
+
+	double bytes = double(stream.size()) * double(iterations);
+	printf("split_annexb: %.2f GB/s, byte-wise reference: %.2f GB/s\n", bytes / time / 1e9, bytes / reference / 1e9);
+	ST_CHECK(found == expected, "Found %zu instead of %zu NAL units.", found, expected);
+}
+
+int main(int argc, const char* argv[])
+{
+	bool         full = streamfx::tests::full(argc, argv);
+	std::mt19937 rng(0);
+
+	std::size_t buffers = full ? 200000 : 10000;
+	for (std::size_t idx = 0; (idx < buffers) && (streamfx::tests::failures() == 0); idx++) {
+		fuzz_annexb(rng, rng() % ((idx % 16 == 0) ? 4096 : 128));
+		fuzz_obu(rng);
+	}
+
+	benchmark(rng, full ? (64 << 20) : (4 << 20), full ? 20 : 2);
+
+	return streamfx::tests::failures();
+}
@@ -0,0 +1,157 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2023 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+// Quality of the Gaussian Cascade blur compared to a full size Gaussian.
+//
+// Every pass of the cascade is separable, so a 1D model of the same passes has the same impulse response as the 2D
+// blur along each axis. The model follows gaussian-cascade.effect: 2x2 box downsampling, the blur kernel computed in
+// the shader at the smallest level, and bilinear upsampling. The cascade is not shift invariant, so the impulse is
+// placed at every position relative to the smallest level. The standard deviation, offset and L1 difference from the
+// reference are averaged over those positions, and the worst position is checked against a looser limit.
+
+#include "tests.hpp"
+#include "gfx/blur/gfx-blur-gaussian-cascade.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+#include "warning-enable.hpp"
+
+using streamfx::gfx::blur::gaussian_cascade;
+
+// See gaussian-cascade.effect.
+constexpr std::size_t max_samples = 36;
+
+typedef std::vector<double> signal_t;
+
+static signal_t downsample(const signal_t& input)
+{
+	signal_t output(input.size() / 2);
+	for (std::size_t idx = 0; idx < output.size(); idx++) {
+		output[idx] = (input[idx * 2] + input[idx * 2 + 1]) / 2.;
+	}
+	return output;
+}
+
+static signal_t upsample(const signal_t& input, std::size_t size)
+{
+	// Every output texel center lands a quarter texel away from the closest input texel center.
+	signal_t output(size);
+	for (std::size_t idx = 0; idx < size; idx++) {
+		std::size_t center = std::min(idx / 2, input.size() - 1);
+		std::size_t other  = (idx % 2) ? std::min(center + 1, input.size() - 1) : ((center > 0) ? (center - 1) : 0);
+		output[idx]        = input[center] * 0.75 + input[other] * 0.25;
+	}
+	return output;
+}
+
+static signal_t blur(const signal_t& input, double sigma)
+{
+	double      exponent = -0.5 / (sigma * sigma);
+	std::size_t samples  = static_cast<std::size_t>(std::ceil(sigma * 4.));
+
+	signal_t output(input.size());
+	for (std::size_t idx = 0; idx < input.size(); idx++) {
+		double weights = 1.;
+		double value   = input[idx];
+		for (std::size_t step = 1; (step <= samples) && (step < max_samples); step++) {
+			double kernel = std::exp(double(step * step) * exponent);
+			weights += kernel * 2.;
+			value += input[std::min(idx + step, input.size() - 1)] * kernel;
+			value += input[(idx >= step) ? (idx - step) : 0] * kernel;
+		}
+		output[idx] = value / weights;
+	}
+	return output;
+}
+
+static signal_t cascade(const signal_t& input, std::size_t levels, double sigma)
+{
+	std::vector<signal_t> chain = {input};
+	for (std::size_t n = 1; n <= levels; n++) {
+		chain.push_back(downsample(chain.back()));
+	}
+	chain.back() = blur(chain.back(), sigma);
+	for (std::size_t n = levels; n > 0; n--) {
+		chain[n - 1] = upsample(chain[n], chain[n - 1].size());
+	}
+	return chain[0];
+}
+
+struct result {
+	double sigma;
+	double l1;
+	double l1_position;
+	double offset;
+};
+
+static void test(double size, result& worst)
+{
+	auto [levels, sigma] = gaussian_cascade::plan(size, 3840, 2160);
+
+	// Keep the impulse response far away from the edges, on a grid that halves cleanly.
+	std::size_t phases = std::size_t(1) << levels;
+	std::size_t length = ((static_cast<std::size_t>(size * 16.) / phases) + 2) * phases;
+	std::size_t center = (length / 2) & ~(phases - 1);
+
+	double variance    = 0.;
+	double offset      = 0.;
+	double l1          = 0.;
+	double l1_position = 0.;
+	for (std::size_t phase = 0; phase < phases; phase++) {
+		double   position = double(center + phase);
+		signal_t impulse(length, 0.);
+		impulse[center + phase] = 1.;
+		signal_t response       = cascade(impulse, levels, sigma);
+
+		double mean = 0.;
+		for (std::size_t idx = 0; idx < length; idx++) {
+			mean += response[idx] * double(idx);
+		}
+		double var       = 0.;
+		double reference = 0.;
+		for (std::size_t idx = 0; idx < length; idx++) {
+			var += response[idx] * (double(idx) - mean) * (double(idx) - mean);
+			reference += std::exp(-0.5 * (double(idx) - position) * (double(idx) - position) / (size * size));
+		}
+		double diff = 0.;
+		for (std::size_t idx = 0; idx < length; idx++) {
+			diff += std::abs(response[idx] - std::exp(-0.5 * (double(idx) - position) * (double(idx) - position) / (size * size)) / reference);
+		}
+
+		variance += var;
+		offset += mean - position;
+		l1 += diff;
+		l1_position = std::max(l1_position, diff);
+	}
+	variance /= double(phases);
+	offset /= double(phases);
+	l1 /= double(phases);
+
+	double error = std::sqrt(variance) / size - 1.;
+	ST_CHECK(std::abs(error) <= 0.01, "Size %.1f (%zu levels, sigma %.2f) has a standard deviation of %.2f.", size, levels, sigma, std::sqrt(variance));
+	ST_CHECK(l1 <= 0.06, "Size %.1f (%zu levels, sigma %.2f) differs by %.4f from the reference.", size, levels, sigma, l1);
+	ST_CHECK(l1_position <= 0.1, "Size %.1f (%zu levels, sigma %.2f) differs by %.4f from the reference at the worst position.", size, levels, sigma, l1_position);
+	ST_CHECK(std::abs(offset) <= 0.001, "Size %.1f (%zu levels, sigma %.2f) is off by %.4f texels on average.", size, levels, sigma, offset);
+
+	worst.sigma       = std::max(worst.sigma, std::abs(error));
+	worst.l1          = std::max(worst.l1, l1);
+	worst.l1_position = std::max(worst.l1_position, l1_position);
+	worst.offset      = std::max(worst.offset, std::abs(offset));
+}
+
+int main(int argc, const char* argv[])
+{
+	double step  = streamfx::tests::full(argc, argv) ? 0.25 : 8.;
+	result worst = {};
+
+	for (double size = 12.; size <= 400.; size += step) {
+		test(size, worst);
+	}
+	printf("Sizes 12 to 400: standard deviation within %.2f%%, L1 difference at most %.4f (%.4f at the worst position), offset at most %.4f texels\n", worst.sigma * 100., worst.l1, worst.l1_position, worst.offset);
+
+	return streamfx::tests::failures();
+}
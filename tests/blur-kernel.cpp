@@ -0,0 +1,112 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2023 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+// Compile time Gaussian kernels against the runtime generation they replaced.
+//
+// The reference functions below are the kernel generation of the Gaussian and Gaussian Linear blurs from before the
+// tables, using std::exp() and the linear width search. Every table row has to match them, and fractional sizes have
+// to blend the two closest rows.
+
+#include "tests.hpp"
+#include "gfx/blur/gfx-blur-gaussian-linear.hpp"
+#include "gfx/blur/gfx-blur-gaussian.hpp"
+#include "util/utility.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include "warning-enable.hpp"
+
+using namespace streamfx::gfx::blur;
+
+typedef std::array<float, 128> kernel_t;
+
+static kernel_t reference_gaussian(std::size_t size)
+{
+	std::array<double, 128> weights{};
+	kernel_t                kernel{};
+
+	double total = 0.;
+	for (std::size_t idx = 0; (idx < size * 2) && (idx < kernel.size()); idx++) {
+		weights[idx] = streamfx::util::math::gaussian<double>(static_cast<double>(idx), static_cast<double>(size));
+		total += weights[idx] * (idx > 0 ? 2 : 1);
+	}
+	for (std::size_t idx = 0; (idx < size * 2) && (idx < kernel.size()); idx++) {
+		kernel[idx] = static_cast<float>(weights[idx] / total);
+	}
+	return kernel;
+}
+
+static kernel_t reference_gaussian_linear(std::size_t size)
+{
+	constexpr double density   = 1. / 500.;
+	constexpr double threshold = 1. / (128 * 5);
+
+	std::array<double, 128> weights{};
+	kernel_t                kernel{};
+
+	double width = 1.;
+	for (double h = density; h < 128 * 2; h += density) {
+		if (streamfx::util::math::gaussian<double>(double(size + 1), h) > threshold) {
+			width = h;
+			break;
+		}
+	}
+
+	double total = 0.;
+	for (std::size_t idx = 0; idx <= size; idx++) {
+		weights[idx] = streamfx::util::math::gaussian<double>(double(idx), width);
+		total += weights[idx] * (idx > 0 ? 2 : 1);
+	}
+	for (std::size_t idx = 0; idx <= size; idx++) {
+		kernel[idx] = float(weights[idx] / total);
+	}
+	return kernel;
+}
+
+template<typename Data>
+static double test(const char* name, kernel_t (*reference)(std::size_t), std::size_t sizes)
+{
+	typename Data::kernel_buffer_t buffer;
+	typename Data::kernel_buffer_t lower;
+	double                         worst = 0.;
+
+	for (std::size_t size = 1; size <= sizes; size++) {
+		buffer.fill(-1.f);
+		auto     kernel   = Data::get_kernel(double(size), buffer);
+		kernel_t expected = reference(size);
+
+		ST_CHECK(kernel.size() == expected.size(), "%s kernel %zu has %zu instead of %zu entries.", name, size, kernel.size(), expected.size());
+		ST_CHECK(kernel.data() != buffer.data(), "%s kernel %zu was blended instead of taken from the table.", name, size);
+		for (std::size_t idx = 0; idx < expected.size(); idx++) {
+			double error = std::abs(double(kernel[idx]) - double(expected[idx]));
+			worst        = std::max(worst, error);
+			ST_CHECK(error <= 3e-8, "%s kernel %zu differs by %g at %zu.", name, size, error, idx);
+		}
+
+		// Half way to the next size is the average of both.
+		if (size < sizes) {
+			std::copy(kernel.data(), kernel.data() + kernel.size(), lower.begin());
+			auto upper   = Data::get_kernel(double(size + 1), buffer);
+			auto blended = Data::get_kernel(double(size) + .5, buffer);
+			for (std::size_t idx = 0; idx < blended.size(); idx++) {
+				float average = lower[idx] + (upper[idx] - lower[idx]) * .5f;
+				ST_CHECK(blended[idx] == average, "%s kernel %.1f is %g instead of %g at %zu.", name, double(size) + .5, double(blended[idx]), double(average), idx);
+			}
+		}
+	}
+
+	printf("%s: %zu kernels within %g of the runtime generation\n", name, sizes, worst);
+	return worst;
+}
+
+int main(int, const char*[])
+{
+	test<gaussian_data>("Gaussian", &reference_gaussian, 64);
+	test<gaussian_linear_data>("Gaussian Linear", &reference_gaussian_linear, 127);
+
+	return streamfx::tests::failures();
+}
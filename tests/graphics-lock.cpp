@@ -0,0 +1,118 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2023 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+// Graphics context use of the FFmpeg encoders.
+//
+// Encoders wrap every call into the codec with ffmpeg::hwapi::graphics_lock. Software encoders have no hardware
+// instance and must never enter the graphics context, or a slow frame stalls the OBS render thread. A stand-in context
+// counts how often it is entered from many threads at once, and a second one throws like obs::gs::context does when
+// there is no graphics subsystem at all.
+
+#include "tests.hpp"
+#include "ffmpeg/hwapi/base.hpp"
+
+#include "warning-disable.hpp"
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "warning-enable.hpp"
+
+using namespace streamfx::ffmpeg::hwapi;
+
+static std::atomic<size_t> entered{0};
+static std::atomic<size_t> left{0};
+
+struct counting_context {
+	counting_context()
+	{
+		entered++;
+	}
+
+	~counting_context()
+	{
+		left++;
+	}
+};
+
+struct missing_context {
+	missing_context()
+	{
+		throw std::runtime_error("Failed to enter graphics context.");
+	}
+};
+
+class fake_instance : public instance {
+	public:
+	AVBufferRef* create_device_context() override
+	{
+		return nullptr;
+	}
+
+	std::shared_ptr<AVFrame> allocate_frame(AVBufferRef*) override
+	{
+		return nullptr;
+	}
+
+	void copy_from_obs(AVBufferRef*, uint32_t, uint64_t, uint64_t*, std::shared_ptr<AVFrame>) override {}
+
+	std::shared_ptr<AVFrame> avframe_from_obs(AVBufferRef*, uint32_t, uint64_t, uint64_t*) override
+	{
+		return nullptr;
+	}
+};
+
+int main(int argc, const char* argv[])
+{
+	bool   full    = streamfx::tests::full(argc, argv);
+	size_t threads = 8;
+	size_t calls   = full ? 1000000 : 10000;
+
+	{ // Software encoders, sending and receiving from several threads.
+		std::shared_ptr<instance> hwinst;
+		std::vector<std::thread>  workers;
+		for (size_t idx = 0; idx < threads; idx++) {
+			workers.emplace_back([&hwinst, calls]() {
+				for (size_t call = 0; call < calls; call++) {
+					graphics_lock<counting_context> gctx(hwinst);
+				}
+			});
+		}
+		for (auto& worker : workers) {
+			worker.join();
+		}
+		ST_CHECK(entered == 0, "Entered the graphics context %zu times without a hardware instance.", entered.load());
+	}
+
+	{ // Software encoders keep working without any graphics subsystem.
+		std::shared_ptr<instance> hwinst;
+		try {
+			graphics_lock<missing_context> gctx(hwinst);
+		} catch (const std::exception& ex) {
+			ST_CHECK(false, "Tried to enter the graphics context without a hardware instance: %s", ex.what());
+		}
+	}
+
+	{ // Hardware encoders hold the context for exactly the duration of the call.
+		std::shared_ptr<instance> hwinst = std::make_shared<fake_instance>();
+		for (size_t call = 0; call < calls; call++) {
+			graphics_lock<counting_context> gctx(hwinst);
+			ST_CHECK((entered == call + 1) && (left == call), "Context entered %zu and left %zu times during call %zu.", entered.load(), left.load(), call);
+		}
+		ST_CHECK((entered == calls) && (left == calls), "Context entered %zu and left %zu times after %zu calls.", entered.load(), left.load(), calls);
+	}
+
+	{ // Hardware encoders report a missing graphics context.
+		std::shared_ptr<instance> hwinst = std::make_shared<fake_instance>();
+		bool                      thrown = false;
+		try {
+			graphics_lock<missing_context> gctx(hwinst);
+		} catch (const std::runtime_error&) {
+			thrown = true;
+		}
+		ST_CHECK(thrown, "Hardware instance %p did not report the missing graphics context.", static_cast<void*>(hwinst.get()));
+	}
+
+	return streamfx::tests::failures();
+}
@@ -0,0 +1,161 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2023 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+// Cost and accuracy of util::profiler.
+//
+// Four threads track log-uniformly distributed durations from 1us to 100ms. The counters must match the tracked
+// samples exactly, and every percentile must land in the bucket of the exact percentile. Snapshots with reset must
+// not lose or repeat samples while the threads keep going.
+
+#include "tests.hpp"
+#include "util/util-profiler.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+#include "warning-enable.hpp"
+
+using streamfx::util::profiler;
+
+constexpr size_t thread_count = 4;
+
+static std::vector<std::vector<uint64_t>> generate(size_t samples)
+{
+	std::vector<std::vector<uint64_t>> values(thread_count);
+	for (size_t idx = 0; idx < thread_count; idx++) {
+		std::mt19937_64                        rng(idx);
+		std::uniform_real_distribution<double> dist(std::log(1000.), std::log(100000000.));
+		values[idx].resize(samples);
+		for (auto& value : values[idx]) {
+			value = static_cast<uint64_t>(std::exp(dist(rng)));
+		}
+	}
+	return values;
+}
+
+static void test_buckets()
+{
+	std::mt19937_64 rng(0);
+	for (size_t idx = 0; idx < 1000000; idx++) {
+		uint64_t value  = (idx < 65536) ? idx : (rng() >> (rng() % 64)) % (uint64_t(1) << profiler::max_bits);
+		size_t   bucket = profiler::bucket_index(value);
+		uint64_t upper  = profiler::bucket_value(bucket);
+		uint64_t lower  = (bucket > 0) ? (profiler::bucket_value(bucket - 1) + 1) : 0;
+
+		ST_CHECK((bucket < profiler::bucket_count) && (lower <= value) && (value <= upper), "%" PRIu64 " landed in bucket %zu (%" PRIu64 " to %" PRIu64 ").", value, bucket, lower, upper);
+		ST_CHECK((upper - lower) <= (upper / profiler::sub_count), "Bucket %zu (%" PRIu64 " to %" PRIu64 ") is too wide.", bucket, lower, upper);
+		if (streamfx::tests::failures() > 0) {
+			return;
+		}
+	}
+}
+
+static void test_track(std::vector<std::vector<uint64_t>>& values)
+{
+	auto prof = profiler::create();
+
+	streamfx::tests::timer   tm;
+	std::vector<std::thread> threads;
+	for (auto& list : values) {
+		threads.emplace_back([&prof, &list]() {
+			for (auto value : list) {
+				prof->track(std::chrono::nanoseconds(value));
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	double time = tm.seconds();
+
+	std::vector<uint64_t> merged;
+	uint64_t              total = 0;
+	for (auto& list : values) {
+		merged.insert(merged.end(), list.begin(), list.end());
+	}
+	for (auto value : merged) {
+		total += value;
+	}
+	std::sort(merged.begin(), merged.end());
+
+	printf("track(): %.1fns per sample with %zu threads\n", time * 1e9 * thread_count / double(merged.size()), thread_count);
+	ST_CHECK(prof->count() == merged.size(), "Counted %" PRIu64 " of %zu samples.", prof->count(), merged.size());
+	ST_CHECK(uint64_t(prof->total_duration().count()) == total, "Total is %" PRId64 " instead of %" PRIu64 ".", int64_t(prof->total_duration().count()), total);
+
+	for (double pct : {0.5, 0.9, 0.99, 0.999}) {
+		uint64_t exact = merged[static_cast<size_t>(std::ceil(pct * double(merged.size()))) - 1];
+		uint64_t value = uint64_t(prof->percentile(pct).count());
+		ST_CHECK(value == profiler::bucket_value(profiler::bucket_index(exact)), "%.1fth percentile is %" PRIu64 " instead of about %" PRIu64 ".", pct * 100., value, exact);
+	}
+
+	size_t queries = 1000;
+	tm             = {};
+	for (size_t idx = 0; idx < queries; idx++) {
+		prof->percentile(0.99);
+	}
+	printf("percentile(): %.1fus per query\n", tm.seconds() * 1e6 / double(queries));
+}
+
+static void test_snapshot(std::vector<std::vector<uint64_t>>& values)
+{
+	auto              prof      = profiler::create();
+	std::atomic<bool> running   = true;
+	uint64_t          count     = 0;
+	uint64_t          total     = 0;
+	size_t            snapshots = 0;
+
+	std::vector<std::thread> threads;
+	for (auto& list : values) {
+		threads.emplace_back([&prof, &list]() {
+			for (auto value : list) {
+				prof->track(std::chrono::nanoseconds(value));
+			}
+		});
+	}
+	std::thread reader([&]() {
+		while (running) {
+			auto snapshot = prof->snapshot(true);
+			count += snapshot.count();
+			total += uint64_t(snapshot.total_duration().count());
+			snapshots++;
+		}
+	});
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	running = false;
+	reader.join();
+
+	auto snapshot = prof->snapshot(true);
+	count += snapshot.count();
+	total += uint64_t(snapshot.total_duration().count());
+
+	uint64_t exact_count = 0;
+	uint64_t exact_total = 0;
+	for (auto& list : values) {
+		exact_count += list.size();
+		for (auto value : list) {
+			exact_total += value;
+		}
+	}
+	ST_CHECK(count == exact_count, "%zu snapshots counted %" PRIu64 " of %" PRIu64 " samples.", snapshots, count, exact_count);
+	ST_CHECK(total == exact_total, "%zu snapshots added up to %" PRIu64 " instead of %" PRIu64 ".", snapshots, total, exact_total);
+}
+
+int main(int argc, const char* argv[])
+{
+	auto values = generate(streamfx::tests::full(argc, argv) ? 2000000 : 100000);
+
+	test_buckets();
+	test_track(values);
+	test_snapshot(values);
+
+	return streamfx::tests::failures();
+}
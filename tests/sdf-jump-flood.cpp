@@ -0,0 +1,139 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2023 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+// Jump flooding against a brute force distance field.
+//
+// gfx::sdf::jump_flood() runs the same Seed, Flood and Resolve steps and pass schedule as sdf-jfa.effect. Random shapes
+// made of discs, boxes and noise are compared against the exact distance to the nearest texel of the other kind. A
+// single texel has to be found exactly from everywhere. Anything else may have the usual jump flooding misses, where
+// a texel ends up with a neighbour's nearest texel instead of its own, but never a distance shorter than the exact one.
+// Around 0.06% of the texels are missed, by up to 40% of the exact distance.
+
+#include "tests.hpp"
+#include "gfx/gfx-sdf-jump-flood.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+#include "warning-enable.hpp"
+
+using namespace streamfx::gfx::sdf;
+
+constexpr float max_distance = 65504.f;
+
+static std::vector<uint8_t> single_texel(std::mt19937& rng, uint32_t width, uint32_t height)
+{
+	std::vector<uint8_t> alpha(std::size_t(width) * height, 0);
+	alpha[rng() % alpha.size()] = 255;
+	return alpha;
+}
+
+static std::vector<uint8_t> random_shape(std::mt19937& rng, uint32_t width, uint32_t height)
+{
+	std::vector<uint8_t> alpha(std::size_t(width) * height, 0);
+	std::size_t          shapes = rng() % 6;
+	for (std::size_t idx = 0; idx < shapes; idx++) {
+		int32_t cx = int32_t(rng() % width);
+		int32_t cy = int32_t(rng() % height);
+		int32_t rx = 1 + int32_t(rng() % (width / 3 + 1));
+		int32_t ry = 1 + int32_t(rng() % (height / 3 + 1));
+		bool    box = (rng() % 2) == 0;
+		for (int32_t y = 0; y < int32_t(height); y++) {
+			for (int32_t x = 0; x < int32_t(width); x++) {
+				float dx = float(x - cx) / float(rx);
+				float dy = float(y - cy) / float(ry);
+				if (box ? ((std::abs(dx) <= 1.f) && (std::abs(dy) <= 1.f)) : ((dx * dx + dy * dy) <= 1.f)) {
+					alpha[std::size_t(y) * width + x] = 255;
+				}
+			}
+		}
+	}
+
+	// Scattered single texels are the hardest case for jump flooding.
+	std::size_t noise = (rng() % 4 == 0) ? (rng() % 16) : 0;
+	for (std::size_t idx = 0; idx < noise; idx++) {
+		alpha[rng() % alpha.size()] ^= 255;
+	}
+	return alpha;
+}
+
+static void test(const std::vector<uint8_t>& alpha, uint32_t width, uint32_t height, bool exact, std::size_t& misses, std::size_t& texels, double& worst)
+{
+	auto field = jump_flood(alpha.data(), width, height, width, 127);
+
+	uint32_t passes = jump_flood_passes(width, height);
+	ST_CHECK((field.passes == passes) && ((passes == 0) || (((uint64_t(1) << passes) >= std::max(width, height)) && ((uint64_t(1) << (passes - 1)) < std::max(width, height)))), "%ux%u took %u passes.", width, height, field.passes);
+	for (uint32_t pass = 0; pass < passes; pass++) {
+		uint32_t step = jump_flood_step(width, height, pass);
+		ST_CHECK(step == (uint32_t(1) << (passes - pass - 1)), "Pass %u of %ux%u has a step of %u.", pass, width, height, step);
+	}
+
+	// Every texel against every texel of the other kind.
+	std::vector<std::pair<int32_t, int32_t>> points[2];
+	for (uint32_t y = 0; y < height; y++) {
+		for (uint32_t x = 0; x < width; x++) {
+			points[(alpha[std::size_t(y) * width + x] > 127) ? 0 : 1].emplace_back(int32_t(x), int32_t(y));
+		}
+	}
+
+	for (uint32_t y = 0; y < height; y++) {
+		for (uint32_t x = 0; x < width; x++) {
+			std::size_t idx       = std::size_t(y) * width + x;
+			bool        is_inside = alpha[idx] > 127;
+			float       expected  = max_distance;
+			for (auto& point : points[is_inside ? 1 : 0]) {
+				float dx = float(point.first - int32_t(x));
+				float dy = float(point.second - int32_t(y));
+				expected = std::min(expected, std::sqrt(dx * dx + dy * dy));
+			}
+
+			float found = is_inside ? field.inside[idx] : field.outside[idx];
+			float other = is_inside ? field.outside[idx] : field.inside[idx];
+			float error = found - expected;
+			ST_CHECK(other == 0.f, "Texel %u,%u of %ux%u is %g away from its own kind.", x, y, width, height, double(other));
+			ST_CHECK(error >= -1e-4f, "Texel %u,%u of %ux%u is %g, closer than the exact %g.", x, y, width, height, double(found), double(expected));
+			ST_CHECK(!exact || (error <= 1e-4f), "Texel %u,%u of %ux%u is %g instead of %g.", x, y, width, height, double(found), double(expected));
+			if (error > 1e-4f) {
+				misses++;
+				worst = std::max(worst, double(error / expected));
+			}
+			texels++;
+		}
+	}
+}
+
+int main(int argc, const char* argv[])
+{
+	bool         full = streamfx::tests::full(argc, argv);
+	std::mt19937 rng(0);
+
+	std::size_t misses = 0;
+	std::size_t texels = 0;
+	double      worst  = 0.;
+	for (std::size_t idx = 0; idx < (full ? 1000 : 100); idx++) {
+		uint32_t width  = 1 + rng() % 257;
+		uint32_t height = 1 + rng() % 130;
+		test(single_texel(rng, width, height), width, height, true, misses, texels, worst);
+	}
+	test(std::vector<uint8_t>(257 * 130, 0), 257, 130, true, misses, texels, worst);
+	test(std::vector<uint8_t>(257 * 130, 255), 257, 130, true, misses, texels, worst);
+	printf("Single texels: %zu of %zu texels missed\n", misses, texels);
+
+	misses = 0;
+	texels = 0;
+	worst  = 0.;
+	for (std::size_t idx = 0; idx < (full ? 2000 : 20); idx++) {
+		uint32_t width  = 1 + rng() % 257;
+		uint32_t height = 1 + rng() % 130;
+		test(random_shape(rng, width, height), width, height, false, misses, texels, worst);
+	}
+	printf("Random shapes: %zu of %zu texels missed, by at most %.1f%%\n", misses, texels, worst * 100.);
+	ST_CHECK(misses * 200 < texels, "%zu of %zu texels missed.", misses, texels);
+	ST_CHECK(worst <= 0.5, "Missed by up to %.1f%%.", worst * 100.);
+
+	return streamfx::tests::failures();
+}
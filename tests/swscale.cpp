@@ -0,0 +1,133 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2023 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+// Sliced against single context conversion in ffmpeg::swscale.
+//
+// Converts random frames from the formats OBS hands to encoders with every quality setting, once with a single
+// context and once split into row bands on the threadpool. The output has to be identical byte for byte, and the
+// average time of both is printed.
+
+#include "tests.hpp"
+#include "ffmpeg/swscale.hpp"
+
+#include "warning-disable.hpp"
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+#include "warning-enable.hpp"
+
+extern "C" {
+#include "warning-disable.hpp"
+#include <libavutil/imgutils.h>
+#include <libavutil/mem.h>
+#include <libavutil/pixdesc.h>
+#include "warning-enable.hpp"
+}
+
+using namespace streamfx::ffmpeg;
+
+struct image {
+	uint8_t* data[4]   = {};
+	int      stride[4] = {};
+	int      size      = 0;
+
+	image(AVPixelFormat format, int width, int height)
+	{
+		size = av_image_alloc(data, stride, width, height, format, 64);
+	}
+
+	~image()
+	{
+		av_freep(&data[0]);
+	}
+};
+
+static double convert(swscale& scaler, image& source, image& target, int height, size_t iterations)
+{
+	streamfx::tests::timer tm;
+	for (size_t idx = 0; idx < iterations; idx++) {
+		int rows = scaler.convert(source.data, source.stride, 0, height, target.data, target.stride);
+		ST_CHECK(rows == height, "Converted %d of %d rows.", rows, height);
+	}
+	return tm.seconds() / double(iterations);
+}
+
+static bool equal(AVPixelFormat format, int width, int height, image& a, image& b)
+{
+	const AVPixFmtDescriptor* desc = av_pix_fmt_desc_get(format);
+	for (int plane = 0; plane < av_pix_fmt_count_planes(format); plane++) {
+		int bytes = av_image_get_linesize(format, width, plane);
+		int rows  = ((plane == 1) || (plane == 2)) ? AV_CEIL_RSHIFT(height, desc->log2_chroma_h) : height;
+		for (int row = 0; row < rows; row++) {
+			if (memcmp(a.data[plane] + ptrdiff_t(row) * a.stride[plane], b.data[plane] + ptrdiff_t(row) * b.stride[plane], size_t(bytes)) != 0) {
+				fprintf(stderr, "Plane %d differs in row %d.\n", plane, row);
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+static void test(AVPixelFormat source_format, AVPixelFormat target_format, int width, int height, size_t iterations)
+{
+	image source(source_format, width, height);
+	image single(target_format, width, height);
+	image sliced(target_format, width, height);
+	if ((source.size < 0) || (single.size < 0) || (sliced.size < 0)) {
+		ST_CHECK(false, "Failed to allocate %dx%d images.", width, height);
+		return;
+	}
+
+	// Noise is the worst case for both filtering and dithering.
+	std::mt19937 rng(static_cast<uint32_t>(width * height));
+	for (int idx = 0; idx < source.size; idx++) {
+		source.data[0][idx] = static_cast<uint8_t>(rng());
+	}
+
+	for (auto quality : {swscale_quality::FAST, swscale_quality::BALANCED, swscale_quality::QUALITY}) {
+		swscale scalers[2];
+		for (size_t idx = 0; idx < 2; idx++) {
+			scalers[idx].set_source_size(uint32_t(width), uint32_t(height));
+			scalers[idx].set_source_format(source_format);
+			scalers[idx].set_source_color(false, AVCOL_SPC_BT709);
+			scalers[idx].set_target_size(uint32_t(width), uint32_t(height));
+			scalers[idx].set_target_format(target_format);
+			scalers[idx].set_target_color(false, AVCOL_SPC_BT709);
+		}
+		if (!scalers[0].initialize(swscale::get_flags(quality), 1) || !scalers[1].initialize(swscale::get_flags(quality), 4)) {
+			ST_CHECK(false, "Failed to initialize the conversion from '%s' to '%s'.", av_get_pix_fmt_name(source_format), av_get_pix_fmt_name(target_format));
+			return;
+		}
+
+		double time_single = convert(scalers[0], source, single, height, iterations);
+		double time_sliced = convert(scalers[1], source, sliced, height, iterations);
+		printf("%-12s -> %-12s %4dx%-4d quality %d: %7.3fms single, %7.3fms in %zu slices\n", av_get_pix_fmt_name(source_format), av_get_pix_fmt_name(target_format), width, height, static_cast<int>(quality), time_single * 1000., time_sliced * 1000., scalers[1].get_slice_count());
+
+		ST_CHECK(scalers[1].get_slice_count() == 4, "Expected 4 slices, got %zu.", scalers[1].get_slice_count());
+		ST_CHECK(equal(target_format, width, height, single, sliced), "Sliced conversion from '%s' to '%s' differs.", av_get_pix_fmt_name(source_format), av_get_pix_fmt_name(target_format));
+	}
+}
+
+int main(int argc, const char* argv[])
+{
+	bool   full       = streamfx::tests::full(argc, argv);
+	size_t iterations = full ? 50 : 2;
+
+	// 1080 rows do not split into bands that are a multiple of the dither pattern by chance, unlike 720.
+	std::vector<std::pair<int, int>> sizes = {{1280, 720}, {1920, 1080}};
+	if (full) {
+		sizes = {{1280, 720}, {1920, 1080}, {3840, 2160}};
+	}
+
+	for (auto size : sizes) {
+		test(AV_PIX_FMT_NV12, AV_PIX_FMT_YUV420P, size.first, size.second, iterations);
+		test(AV_PIX_FMT_YUV420P, AV_PIX_FMT_NV12, size.first, size.second, iterations);
+		test(AV_PIX_FMT_YUV444P, AV_PIX_FMT_GBRP, size.first, size.second, iterations);
+		test(AV_PIX_FMT_P010LE, AV_PIX_FMT_YUV420P10LE, size.first, size.second, iterations);
+		test(AV_PIX_FMT_P010LE, AV_PIX_FMT_NV12, size.first, size.second, iterations);
+	}
+
+	return streamfx::tests::failures();
+}
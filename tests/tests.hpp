@@ -0,0 +1,53 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2023 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+#pragma once
+#include "warning-disable.hpp"
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include "warning-enable.hpp"
+
+namespace streamfx::tests {
+	/** Number of failed checks so far, which main() returns as its exit code.
+	 */
+	inline int& failures()
+	{
+		static int value = 0;
+		return value;
+	}
+
+	/** Whether to run the full measurement instead of the short check CTest runs.
+	 */
+	inline bool full(int argc, const char* argv[])
+	{
+		for (int idx = 1; idx < argc; idx++) {
+			if (strcmp(argv[idx], "--full") == 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	/** Measures the time since construction.
+	 */
+	class timer {
+		std::chrono::high_resolution_clock::time_point _start;
+
+		public:
+		timer() : _start(std::chrono::high_resolution_clock::now()) {}
+
+		double seconds()
+		{
+			return std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - _start).count();
+		}
+	};
+} // namespace streamfx::tests
+
+#define ST_CHECK(x, f, ...)                                                                        \
+	if (!(x)) {                                                                                    \
+		fprintf(stderr, "%s:%d: Check '%s' failed: " f "\n", __FILE__, __LINE__, #x, __VA_ARGS__); \
+		streamfx::tests::failures()++;                                                             \
+	}
@@ -0,0 +1,218 @@
+// AUTOGENERATED COPYRIGHT HEADER START
+// Copyright (C) 2023 Michael Fabian 'Xaymar' Dirks <info@xaymar.com>
+// AUTOGENERATED COPYRIGHT HEADER END
+
+// Throughput, latency and allocations of util::threadpool.
+//
+// Throughput is measured with 1 to 64 producers pushing empty tasks. Latency is the time between push() and a worker
+// starting the task, with the pool idle between pushes so that every task has to wake up a worker. Allocations are
+// counted across all threads by replacing the global operator new, and must not happen at all once the threadpool has
+// warmed up.
+
+#include "tests.hpp"
+#include "util/util-threadpool.hpp"
+
+#include "warning-disable.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <thread>
+#include <vector>
+#include "warning-enable.hpp"
+
+using namespace streamfx::util::threadpool;
+
+static std::atomic<uint64_t> allocations{0};
+
+static void* allocate(std::size_t size, std::size_t alignment)
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	size = std::max<std::size_t>(size, 1);
+	if (alignment <= alignof(std::max_align_t)) {
+		return std::malloc(size);
+	}
+#ifdef _WIN32
+	return _aligned_malloc(size, alignment);
+#else
+	return std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+#endif
+}
+
+void* operator new(std::size_t size)
+{
+	if (void* ptr = allocate(size, 0); ptr) {
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+	if (void* ptr = allocate(size, static_cast<std::size_t>(alignment)); ptr) {
+		return ptr;
+	}
+	throw std::bad_alloc();
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::align_val_t) noexcept
+{
+#ifdef _WIN32
+	_aligned_free(ptr);
+#else
+	std::free(ptr);
+#endif
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+	operator delete(ptr);
+}
+
+void operator delete(void* ptr, std::size_t, std::align_val_t alignment) noexcept
+{
+	operator delete(ptr, alignment);
+}
+
+static bool wait_for(std::atomic<size_t>& counter, size_t value, double timeout)
+{
+	streamfx::tests::timer tm;
+	while (counter.load(std::memory_order_acquire) < value) {
+		if (tm.seconds() > timeout) {
+			return false;
+		}
+		std::this_thread::yield();
+	}
+	return true;
+}
+
+static void throughput(size_t producers, size_t tasks)
+{
+	std::atomic<size_t> done{0};
+	auto                pool     = std::make_shared<threadpool>();
+	auto                callback = [&done](task_data_t) { done.fetch_add(1, std::memory_order_release); };
+
+	streamfx::tests::timer   tm;
+	std::vector<std::thread> threads;
+	for (size_t idx = 0; idx < producers; idx++) {
+		threads.emplace_back([&pool, &callback, tasks]() {
+			for (size_t n = 0; n < tasks; n++) {
+				pool->push(callback);
+			}
+		});
+	}
+	for (auto& thread : threads) {
+		thread.join();
+	}
+	bool   finished = wait_for(done, producers * tasks, 60.);
+	double time     = tm.seconds();
+
+	ST_CHECK(finished, "Only %zu of %zu tasks ran with %zu producers.", done.load(), producers * tasks, producers);
+
+	// Workers count a task as completed only after it ran.
+	auto stats = pool->statistics(priority::NORMAL);
+	for (streamfx::tests::timer wait; (stats.completed < stats.pushed) && (wait.seconds() < 1.);) {
+		std::this_thread::yield();
+		stats = pool->statistics(priority::NORMAL);
+	}
+	ST_CHECK(stats.pending == 0, "%zu tasks are still pending.", stats.pending);
+	ST_CHECK(stats.pushed == stats.completed, "Pushed %" PRIu64 " tasks, but completed %" PRIu64 ".", stats.pushed, stats.completed);
+
+	printf("%2zu producers: %10.0f tasks/s, %" PRIu64 " stolen\n", producers, static_cast<double>(producers * tasks) / time, stats.stolen);
+}
+
+static void latency(size_t tasks)
+{
+	std::atomic<size_t> done{0};
+	std::vector<double> latencies(tasks);
+	auto                pool = std::make_shared<threadpool>();
+
+	for (size_t idx = 0; idx < tasks; idx++) {
+		// Let the workers run dry and park.
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+		auto queued = std::chrono::high_resolution_clock::now();
+		pool->push([&done, &latencies, queued, idx](task_data_t) {
+			latencies[idx] = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - queued).count();
+			done.fetch_add(1, std::memory_order_release);
+		});
+		if (!wait_for(done, idx + 1, 10.)) {
+			ST_CHECK(false, "Task %zu never ran.", idx);
+			return;
+		}
+	}
+
+	std::sort(latencies.begin(), latencies.end());
+	double average = 0;
+	for (auto value : latencies) {
+		average += value;
+	}
+	average /= static_cast<double>(tasks);
+
+	printf("Latency: %.3fms average, %.3fms 99th percentile, %.3fms maximum\n", average * 1000., latencies[tasks * 99 / 100] * 1000., latencies.back() * 1000.);
+
+	// A parked worker is woken up by push(), it does not poll.
+	ST_CHECK(latencies[tasks / 2] < 0.05, "Median latency is %.3fms.", latencies[tasks / 2] * 1000.);
+}
+
+static void allocations_per_task(size_t tasks)
+{
+	std::atomic<size_t> done{0};
+	auto                pool     = std::make_shared<threadpool>();
+	task_callback_t     callback = [&done](task_data_t) { done.fetch_add(1, std::memory_order_release); };
+	auto                data     = std::make_shared<size_t>(0);
+
+	// One task at a time, so that the pool never has a reason to spawn more workers.
+	auto run = [&](size_t count) {
+		for (size_t idx = 0; idx < count; idx++) {
+			size_t expected = done.load() + 1;
+			pool->push(callback, data);
+			if (!wait_for(done, expected, 10.)) {
+				return false;
+			}
+		}
+
+		// Workers drop their reference to a task right after it ran.
+		for (streamfx::tests::timer wait; (pool->statistics(priority::NORMAL).completed < done.load()) && (wait.seconds() < 1.);) {
+			std::this_thread::yield();
+		}
+		return true;
+	};
+
+	if (!run(100)) {
+		ST_CHECK(false, "Warm up of %zu tasks did not finish.", size_t(100));
+		return;
+	}
+
+	uint64_t before   = allocations.load();
+	bool     finished = run(tasks);
+	uint64_t count    = allocations.load() - before;
+
+	printf("Allocations: %" PRIu64 " for %zu tasks\n", count, tasks);
+	ST_CHECK(finished, "Only %zu tasks ran.", done.load());
+	ST_CHECK(count == 0, "Pushing %zu tasks allocated %" PRIu64 " times.", tasks, count);
+}
+
+int main(int argc, const char* argv[])
+{
+	bool   full  = streamfx::tests::full(argc, argv);
+	size_t tasks = full ? 200000 : 5000;
+
+	for (size_t producers : {1, 2, 4, 8, 16, 32, 64}) {
+		if (!full && (producers > 8)) {
+			break;
+		}
+		throughput(producers, tasks / producers);
+	}
+	latency(full ? 2000 : 100);
+	allocations_per_task(full ? 100000 : 1000);
+
+	return streamfx::tests::failures();
+}